@@ -19,6 +19,8 @@ commands:
     dismissnotify [amount] → Dismisses all or up to AMOUNT notifications
     dispatch <dispatcher> [args] → Issue a dispatch to call a keybind
                           dispatcher with arguments
+    frametimes [reset]  → Frame timing percentiles and missed vblanks per
+                          monitor. 'reset' clears them
     getoption <option>  → Gets the config option status (values)
     globalshortcuts     → Lists all global shortcuts
     hyprpaper ...       → Issue a hyprpaper request
@@ -61,6 +63,8 @@ flags:
     -r                  → Refresh state after issuing command (e.g. for
                           updating variables)
     --batch             → Execute a batch of commands, separated by ';'
+    --session (-s)      → Keep one connection open and run every line of
+                          stdin as a request, printing replies in order
     --instance (-i)     → use a specific instance. Can be either signature or
                           index in hyprctl instances (0, 1, etc)
     --quiet (-q)        → Disable the output of hyprctl
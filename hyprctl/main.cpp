@@ -1,4 +1,5 @@
 #include <cctype>
+#include <charconv>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <cstdio>
@@ -8,6 +9,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include <sys/poll.h>
+#include <fcntl.h>
 #include <pwd.h>
 #include <unistd.h>
 #include <ranges>
@@ -217,6 +220,179 @@ int request(std::string arg, int minArgs = 0, bool needRoll = false) {
     return 0;
 }
 
+// same as the server's
+constexpr size_t MAX_FRAME_HEADER = 20;
+// a reply is a listing at worst, anything longer is a broken header
+constexpr size_t MAX_REPLY_SIZE = 1024ull * 1024 * 1024;
+
+// session frames, both ways, are "<payload length>\n<payload>"
+bool popSessionFrame(std::string& buffer, std::string& frame, bool& invalid) {
+    const auto NEWLINE = buffer.find('\n');
+
+    if (NEWLINE == std::string::npos) {
+        invalid = buffer.size() > MAX_FRAME_HEADER;
+        return false;
+    }
+
+    const auto HEADER = std::string_view{buffer}.substr(0, NEWLINE);
+    if (HEADER.empty() || HEADER.size() > MAX_FRAME_HEADER) {
+        invalid = true;
+        return false;
+    }
+
+    size_t     len       = 0;
+    const auto [PTR, EC] = std::from_chars(HEADER.data(), HEADER.data() + HEADER.size(), len);
+    if (EC != std::errc{} || PTR != HEADER.data() + HEADER.size() || len > MAX_REPLY_SIZE) {
+        invalid = true;
+        return false;
+    }
+
+    if (buffer.size() < NEWLINE + 1 + len)
+        return false;
+
+    frame = buffer.substr(NEWLINE + 1, len);
+    buffer.erase(0, NEWLINE + 1 + len);
+    return true;
+}
+
+// keeps one connection open, sends every line of stdin as a request and prints the replies in order.
+// Requests are pipelined, we never wait for a reply before sending the next one.
+int sessionRequest(const std::string& flags) {
+    const auto SERVERSOCKET = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (SERVERSOCKET < 0) {
+        log("Couldn't open a socket (1)");
+        return 1;
+    }
+
+    if (instanceSignature.empty()) {
+        log("HYPRLAND_INSTANCE_SIGNATURE was not set! (Is Hyprland running?)");
+        return 2;
+    }
+
+    sockaddr_un serverAddress = {0};
+    serverAddress.sun_family  = AF_UNIX;
+
+    std::string socketPath = getRuntimeDir() + "/" + instanceSignature + "/.socket.sock";
+
+    strncpy(serverAddress.sun_path, socketPath.c_str(), sizeof(serverAddress.sun_path) - 1);
+
+    if (connect(SERVERSOCKET, (sockaddr*)&serverAddress, SUN_LEN(&serverAddress)) < 0) {
+        log("Couldn't connect to " + socketPath + ". (3)");
+        return 3;
+    }
+
+    fcntl(SERVERSOCKET, F_SETFL, fcntl(SERVERSOCKET, F_GETFL) | O_NONBLOCK);
+
+    std::string            outgoing      = "[[SESSION]]\n";
+    std::string            incoming      = "";
+    std::string            input         = "";
+    size_t                 pending       = 1; // the handshake
+    bool                   handshakeDone = false;
+    bool                   stdinOpen     = true;
+    std::array<char, 8192> buffer        = {0};
+
+    while (stdinOpen || pending > 0) {
+        pollfd pollfds[2] = {
+            {
+                .fd     = SERVERSOCKET,
+                .events = (short)(POLLIN | (outgoing.empty() ? 0 : POLLOUT)),
+            },
+            {
+                .fd     = STDIN_FILENO,
+                .events = POLLIN,
+            },
+        };
+
+        if (poll(pollfds, stdinOpen && handshakeDone ? 2 : 1, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+
+            log("Couldn't poll (5)");
+            close(SERVERSOCKET);
+            return 5;
+        }
+
+        if (pollfds[1].revents & (POLLIN | POLLHUP)) {
+            const auto LEN = read(STDIN_FILENO, buffer.data(), buffer.size());
+
+            if (LEN <= 0)
+                stdinOpen = false;
+            else
+                input.append(buffer.data(), LEN);
+
+            size_t newline = 0;
+            while ((newline = input.find('\n')) != std::string::npos || (!stdinOpen && !input.empty())) {
+                const auto LINE = trim(input.substr(0, newline));
+                input           = newline == std::string::npos ? "" : input.substr(newline + 1);
+
+                if (LINE.empty())
+                    continue;
+
+                const auto RQ = flags + "/" + LINE;
+                outgoing += std::format("{}\n{}", RQ.length(), RQ);
+                pending++;
+            }
+        }
+
+        if (pollfds[0].revents & POLLOUT) {
+            const auto LEN = write(SERVERSOCKET, outgoing.c_str(), outgoing.length());
+
+            if (LEN < 0 && errno != EAGAIN) {
+                log("Couldn't write (4)");
+                close(SERVERSOCKET);
+                return 4;
+            }
+
+            if (LEN > 0)
+                outgoing.erase(0, LEN);
+        }
+
+        if (pollfds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            const auto LEN = read(SERVERSOCKET, buffer.data(), buffer.size());
+
+            if (LEN < 0 && errno == EAGAIN)
+                continue;
+
+            if (LEN <= 0) {
+                log("Hyprland closed the session (5)");
+                close(SERVERSOCKET);
+                return 5;
+            }
+
+            incoming.append(buffer.data(), LEN);
+
+            std::string reply   = "";
+            bool        invalid = false;
+            while (popSessionFrame(incoming, reply, invalid)) {
+                pending--;
+
+                if (!handshakeDone) {
+                    if (reply != "ok") {
+                        invalid = true;
+                        break;
+                    }
+
+                    handshakeDone = true;
+                    continue;
+                }
+
+                log(reply);
+            }
+
+            if (invalid) {
+                log("Hyprland IPC doesn't support sessions (6)");
+                close(SERVERSOCKET);
+                return 6;
+            }
+        }
+    }
+
+    close(SERVERSOCKET);
+
+    return 0;
+}
+
 int requestHyprpaper(std::string arg) {
     const auto SERVERSOCKET = socket(AF_UNIX, SOCK_STREAM, 0);
 
@@ -333,6 +509,7 @@ int main(int argc, char** argv) {
     const auto  ARGS             = splitArgs(argc, argv);
     bool        json             = false;
     bool        needRoll         = false;
+    bool        session          = false;
     std::string overrideInstance = "";
 
     for (std::size_t i = 0; i < ARGS.size(); ++i) {
@@ -357,6 +534,8 @@ int main(int argc, char** argv) {
                 needRoll = true;
             } else if (ARGS[i] == "--batch") {
                 fullRequest = "--batch ";
+            } else if (ARGS[i] == "--session" || ARGS[i] == "-s") {
+                session = true;
             } else if (ARGS[i] == "--instance" || ARGS[i] == "-i") {
                 ++i;
 
@@ -399,12 +578,18 @@ int main(int argc, char** argv) {
         fullRequest += ARGS[i] + " ";
     }
 
-    if (fullRequest.empty()) {
+    if (fullRequest.empty() && !session) {
         std::println("{}", USAGE);
         return 1;
     }
 
-    fullRequest.pop_back(); // remove trailing space
+    if (session && !fullRequest.empty()) {
+        log("'--session' reads its requests from stdin");
+        return 1;
+    }
+
+    if (!fullRequest.empty())
+        fullRequest.pop_back(); // remove trailing space
 
     fullRequest = fullArgs + "/" + fullRequest;
 
@@ -450,7 +635,9 @@ int main(int argc, char** argv) {
 
     int exitStatus = 0;
 
-    if (fullRequest.contains("/--batch"))
+    if (session)
+        exitStatus = sessionRequest(fullArgs);
+    else if (fullRequest.contains("/--batch"))
         batchRequest(fullRequest, json);
     else if (fullRequest.contains("/hyprpaper"))
         exitStatus = requestHyprpaper(fullRequest);
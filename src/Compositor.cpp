@@ -17,6 +17,7 @@
 #include <unordered_set>
 #include "debug/HyprCtl.hpp"
 #include "debug/CrashReporter.hpp"
+#include "debug/Benchmark.hpp"
 #ifdef USES_SYSTEMD
 #include <helpers/SdDaemon.hpp> // for SdNotify
 #endif
@@ -258,12 +259,16 @@ void CCompositor::initServer(std::string socketName, int socketFd) {
     option.backendType        = Aquamarine::eBackendType::AQ_BACKEND_HEADLESS;
     option.backendRequestMode = Aquamarine::eBackendRequestMode::AQ_BACKEND_REQUEST_MANDATORY;
     implementations.emplace_back(option);
-    option.backendType        = Aquamarine::eBackendType::AQ_BACKEND_DRM;
-    option.backendRequestMode = Aquamarine::eBackendRequestMode::AQ_BACKEND_REQUEST_IF_AVAILABLE;
-    implementations.emplace_back(option);
-    option.backendType        = Aquamarine::eBackendType::AQ_BACKEND_WAYLAND;
-    option.backendRequestMode = Aquamarine::eBackendRequestMode::AQ_BACKEND_REQUEST_FALLBACK;
-    implementations.emplace_back(option);
+
+    // benchmarks only run on headless outputs of their own
+    if (!g_pBenchmark) {
+        option.backendType        = Aquamarine::eBackendType::AQ_BACKEND_DRM;
+        option.backendRequestMode = Aquamarine::eBackendRequestMode::AQ_BACKEND_REQUEST_IF_AVAILABLE;
+        implementations.emplace_back(option);
+        option.backendType        = Aquamarine::eBackendType::AQ_BACKEND_WAYLAND;
+        option.backendRequestMode = Aquamarine::eBackendRequestMode::AQ_BACKEND_REQUEST_FALLBACK;
+        implementations.emplace_back(option);
+    }
 
     m_pAqBackend = CBackend::create(implementations, options);
 
@@ -481,6 +486,9 @@ void CCompositor::cleanup() {
     m_bIsShuttingDown   = true;
     Debug::shuttingDown = true;
 
+    // get everything logged so far out before teardown, in case it hangs or crashes
+    Debug::flush();
+
 #ifdef USES_SYSTEMD
     if (Systemd::SdBooted() > 0 && !envEnabled("HYPRLAND_NO_SD_NOTIFY"))
         Systemd::SdNotify(0, "STOPPING=1");
@@ -499,6 +507,7 @@ void CCompositor::cleanup() {
     m_vWindows.clear();
 
     for (auto const& m : m_vMonitors) {
+        m->cancelPendingCommit();
         g_pHyprOpenGL->destroyMonitorResources(m);
 
         m->output->state->setEnabled(false);
@@ -524,12 +533,14 @@ void CCompositor::cleanup() {
     g_pHyprRenderer.reset();
     g_pHyprOpenGL.reset();
     g_pThreadManager.reset();
+    g_pProcessManager.reset();
     g_pConfigManager.reset();
     g_pLayoutManager.reset();
     g_pHyprError.reset();
     g_pConfigManager.reset();
     g_pAnimationManager.reset();
     g_pKeybindManager.reset();
+    g_pKeymapCache.reset();
     g_pHookSystem.reset();
     g_pWatchdog.reset();
     g_pXWaylandManager.reset();
@@ -559,6 +570,9 @@ void CCompositor::initManagers(eManagersInitStage stage) {
             Debug::log(LOG, "Creating the HookSystem!");
             g_pHookSystem = std::make_unique<CHookSystemManager>();
 
+            Debug::log(LOG, "Creating the KeymapCache!");
+            g_pKeymapCache = std::make_unique<CKeymapCache>();
+
             Debug::log(LOG, "Creating the KeybindManager!");
             g_pKeybindManager = std::make_unique<CKeybindManager>();
 
@@ -604,6 +618,9 @@ void CCompositor::initManagers(eManagersInitStage stage) {
             Debug::log(LOG, "Creating the ThreadManager!");
             g_pThreadManager = std::make_unique<CThreadManager>();
 
+            Debug::log(LOG, "Creating the ProcessManager!");
+            g_pProcessManager = std::make_unique<CProcessManager>();
+
             Debug::log(LOG, "Creating CHyprCtl");
             g_pHyprCtl = std::make_unique<CHyprCtl>();
 
@@ -698,6 +715,9 @@ void CCompositor::startCompositor() {
 
     prepareFallbackOutput();
 
+    if (g_pBenchmark)
+        g_pBenchmark->start();
+
     g_pHyprRenderer->setCursorFromName("left_ptr");
 
 #ifdef USES_SYSTEMD
@@ -788,6 +808,10 @@ void CCompositor::removeWindowFromVectorSafe(PHLWINDOW pWindow) {
 
         std::erase_if(m_vWindows, [&](SP<CWindow>& el) { return el == pWindow; });
         std::erase_if(m_vWindowsFadingOut, [&](PHLWINDOWREF el) { return el.lock() == pWindow; });
+
+        for (auto const& m : m_vMonitors) {
+            m->hitIndex.remove(pWindow.get());
+        }
     }
 }
 
@@ -800,17 +824,97 @@ bool CCompositor::monitorExists(PHLMONITOR pMonitor) {
     return false;
 }
 
-PHLWINDOW CCompositor::vectorToWindowUnified(const Vector2D& pos, uint8_t properties, PHLWINDOW pIgnoreWindow) {
-    const auto  PMONITOR          = getMonitorFromVector(pos);
+static double windowGrabArea() {
     static auto PRESIZEONBORDER   = CConfigValue<Hyprlang::INT>("general:resize_on_border");
     static auto PBORDERSIZE       = CConfigValue<Hyprlang::INT>("general:border_size");
     static auto PBORDERGRABEXTEND = CConfigValue<Hyprlang::INT>("general:extend_border_grab_area");
-    static auto PSPECIALFALLTHRU  = CConfigValue<Hyprlang::INT>("input:special_fallthrough");
-    const auto  BORDER_GRAB_AREA  = *PRESIZEONBORDER ? *PBORDERSIZE + *PBORDERGRABEXTEND : 0;
+
+    return *PRESIZEONBORDER ? *PBORDERSIZE + *PBORDERGRABEXTEND : 0;
+}
+
+void CCompositor::updateWindowHitIndex(PHLWINDOW pWindow) {
+    for (auto const& m : m_vMonitors) {
+        m->hitIndex.remove(pWindow.get());
+    }
+
+    if (!pWindow->m_bIsMapped || m_bIsShuttingDown)
+        return;
+
+    const auto PMONITOR = pWindow->m_pMonitor.lock();
+
+    // the box is only known once the animation ends, until then it can be hit anywhere. Popups can go anywhere too.
+    if (pWindow->m_vRealPosition.isBeingAnimated() || pWindow->m_vRealSize.isBeingAnimated() || (pWindow->m_pPopupHead && pWindow->m_pPopupHead->hasChildren())) {
+        for (auto const& m : m_vMonitors) {
+            m->hitIndex.insert(pWindow, {}, true);
+        }
+        return;
+    }
+
+    // dimaround windows take their whole monitor
+    if (PMONITOR && pWindow->m_sWindowData.dimAround.valueOrDefault()) {
+        PMONITOR->hitIndex.insert(pWindow, {}, true);
+        return;
+    }
+
+    // superset of any getWindowBoxUnified() box
+    CBox box = {pWindow->m_vRealPosition.value(), pWindow->m_vRealSize.value()};
+    box.addExtents(g_pDecorationPositioner->getWindowDecorationExtents(pWindow, false));
+    box.addExtents(g_pDecorationPositioner->getWindowDecorationReserved(pWindow));
+    box.expand(m_fHitIndexGrabArea + 1);
+
+    const std::vector<CBox> BOXES = {box, CBox{pWindow->m_vPosition, pWindow->m_vSize}.expand(1)};
+
+    bool                    indexed = false;
+    for (auto const& m : m_vMonitors) {
+        const CBox MONBOX = {m->vecPosition, m->vecSize};
+        if (!BOXES[0].overlaps(MONBOX) && !BOXES[1].overlaps(MONBOX))
+            continue;
+
+        m->hitIndex.insert(pWindow, BOXES, false);
+        indexed = true;
+    }
+
+    // off every monitor, still keep it where the window thinks it is
+    if (!indexed && PMONITOR)
+        PMONITOR->hitIndex.insert(pWindow, BOXES, false);
+}
+
+void CCompositor::rebuildWindowHitIndex() {
+    m_fHitIndexGrabArea = windowGrabArea();
+
+    for (auto const& m : m_vMonitors) {
+        m->hitIndex.clear();
+    }
+
+    for (auto const& w : m_vWindows) {
+        updateWindowHitIndex(w);
+    }
+}
+
+PHLWINDOW CCompositor::vectorToWindowUnified(const Vector2D& pos, uint8_t properties, PHLWINDOW pIgnoreWindow) {
+    const auto  PMONITOR         = getMonitorFromVector(pos);
+    static auto PSPECIALFALLTHRU = CConfigValue<Hyprlang::INT>("input:special_fallthrough");
+    const auto  BORDER_GRAB_AREA = windowGrabArea();
+
+    if (BORDER_GRAB_AREA != m_fHitIndexGrabArea)
+        rebuildWindowHitIndex();
+
+    // only windows whose boxes are around pos or the cursor, in m_vWindows order
+    m_vHitCandidates.clear();
+    for (auto const& p : {pos, g_pPointerManager->position()}) {
+        if (const auto PMON = getMonitorFromVector(p); PMON)
+            PMON->hitIndex.collect(p, m_vHitCandidates);
+    }
+
+    std::ranges::sort(m_vHitCandidates, [](const auto& a, const auto& b) { return a->m_iStackOrder < b->m_iStackOrder; });
+    const auto [FIRST, LAST] = std::ranges::unique(m_vHitCandidates);
+    m_vHitCandidates.erase(FIRST, LAST);
+
+    const auto& CANDIDATES = m_vHitCandidates;
 
     // pinned windows on top of floating regardless
     if (properties & ALLOW_FLOATING) {
-        for (auto const& w : m_vWindows | std::views::reverse) {
+        for (auto const& w : CANDIDATES | std::views::reverse) {
             if (w->m_bIsFloating && w->m_bIsMapped && !w->isHidden() && !w->m_bX11ShouldntFocus && w->m_bPinned && !w->m_sWindowData.noFocus.valueOrDefault() &&
                 w != pIgnoreWindow) {
                 const auto BB  = w->getWindowBoxUnified(properties);
@@ -828,8 +932,7 @@ PHLWINDOW CCompositor::vectorToWindowUnified(const Vector2D& pos, uint8_t proper
 
     auto windowForWorkspace = [&](bool special) -> PHLWINDOW {
         auto floating = [&](bool aboveFullscreen) -> PHLWINDOW {
-            for (auto const& w : m_vWindows | std::views::reverse) {
-
+            for (auto const& w : CANDIDATES | std::views::reverse) {
                 if (special && !w->onSpecialWorkspace()) // because special floating may creep up into regular
                     continue;
 
@@ -894,7 +997,7 @@ PHLWINDOW CCompositor::vectorToWindowUnified(const Vector2D& pos, uint8_t proper
             return found;
 
         // for windows, we need to check their extensions too, first.
-        for (auto const& w : m_vWindows) {
+        for (auto const& w : CANDIDATES) {
             if (special != w->onSpecialWorkspace())
                 continue;
 
@@ -905,7 +1008,7 @@ PHLWINDOW CCompositor::vectorToWindowUnified(const Vector2D& pos, uint8_t proper
             }
         }
 
-        for (auto const& w : m_vWindows) {
+        for (auto const& w : CANDIDATES) {
             if (special != w->onSpecialWorkspace())
                 continue;
 
@@ -1131,6 +1234,12 @@ void CCompositor::focusWindow(PHLWINDOW pWindow, SP<CWLSurfaceResource> pSurface
     if (HISTORYPIVOT == m_vWindowFocusHistory.end()) {
         Debug::log(ERR, "BUG THIS: {} has no pivot in history", pWindow);
     } else {
+        // everything up to it moved down by one
+        for (auto it = m_vWindowFocusHistory.begin(); it != HISTORYPIVOT + 1; ++it) {
+            if (const auto PWINDOW = it->lock())
+                PWINDOW->markStateChanged();
+        }
+
         std::rotate(m_vWindowFocusHistory.begin(), HISTORYPIVOT, HISTORYPIVOT + 1);
     }
 
@@ -1393,6 +1502,8 @@ void CCompositor::changeWindowZOrder(PHLWINDOW pWindow, bool top) {
         return;
 
     auto moveToZ = [&](PHLWINDOW pw, bool top) -> void {
+        pw->m_iStackOrder = top ? ++m_iTopStackOrder : --m_iBottomStackOrder;
+
         if (top) {
             for (auto it = m_vWindows.begin(); it != m_vWindows.end(); ++it) {
                 if (*it == pw) {
@@ -2691,6 +2802,11 @@ void CCompositor::renameWorkspace(const WORKSPACEID& id, const std::string& name
     Debug::log(LOG, "renameWorkspace: Renaming workspace {} to '{}'", id, name);
     PWORKSPACE->m_szName = name;
 
+    for (auto const& w : m_vWindows) {
+        if (w->m_pWorkspace == PWORKSPACE)
+            w->markStateChanged();
+    }
+
     g_pEventManager->postEvent({"renameworkspace", std::to_string(PWORKSPACE->m_iID) + "," + PWORKSPACE->m_szName});
 }
 
@@ -2929,6 +3045,9 @@ void CCompositor::arrangeMonitors() {
     }
 
     PROTO::xdgOutput->updateAllOutputs();
+
+    // windows may now overlap other monitors
+    rebuildWindowHitIndex();
 }
 
 void CCompositor::enterUnsafeState() {
@@ -14,11 +14,13 @@
 #include "managers/input/InputManager.hpp"
 #include "managers/LayoutManager.hpp"
 #include "managers/KeybindManager.hpp"
+#include "managers/KeymapCache.hpp"
 #include "managers/AnimationManager.hpp"
 #include "managers/EventManager.hpp"
 #include "managers/ProtocolManager.hpp"
 #include "managers/SessionLockManager.hpp"
 #include "managers/HookSystemManager.hpp"
+#include "managers/ProcessManager.hpp"
 #include "debug/HyprDebugOverlay.hpp"
 #include "debug/HyprNotificationOverlay.hpp"
 #include "helpers/Monitor.hpp"
@@ -95,6 +97,10 @@ class CCompositor {
     bool                                       m_bDesktopEnvSet  = false;
     bool                                       m_bEnableXwayland = true;
 
+    // handed out to windows moved to the top / bottom of m_vWindows, see CWindow::m_iStackOrder
+    int64_t m_iTopStackOrder    = 0;
+    int64_t m_iBottomStackOrder = 0;
+
     // ------------------------------------------------- //
 
     PHLMONITOR             getMonitorFromID(const MONITORID&);
@@ -144,6 +150,8 @@ class CCompositor {
     void                   updateAllWindowsAnimatedDecorationValues();
     void                   updateWorkspaceWindows(const WORKSPACEID& id);
     void                   updateWindowAnimatedDecorationValues(PHLWINDOW);
+    void                   updateWindowHitIndex(PHLWINDOW); // after its mapped state, geometry, decorations, popups or rules changed
+    void                   rebuildWindowHitIndex();
     MONITORID              getNextAvailableMonitorID(std::string const& name);
     void                   moveWorkspaceToMonitor(PHLWORKSPACE, PHLMONITOR, bool noWarpCursor = false);
     void                   swapActiveWorkspaces(PHLMONITOR, PHLMONITOR);
@@ -197,6 +205,10 @@ class CCompositor {
     uint64_t         m_iHyprlandPID    = 0;
     wl_event_source* m_critSigSource   = nullptr;
     rlimit           m_sOriginalNofile = {0};
+
+    // grab area the hit indices were built with, and the last vectorToWindowUnified candidates
+    double                 m_fHitIndexGrabArea = 0;
+    std::vector<PHLWINDOW> m_vHitCandidates;
 };
 
 inline std::unique_ptr<CCompositor> g_pCompositor;
@@ -348,6 +348,12 @@ inline static const std::vector<SConfigOptionDescription> CONFIG_OPTIONS = {
         .type        = CONFIG_OPTION_BOOL,
         .data        = SConfigOptionDescription::SBoolData{true},
     },
+    SConfigOptionDescription{
+        .value       = "animations:bezier_precision",
+        .description = "maximum error in x when evaluating bezier curves. Lower is more precise, but slower. [0.000001 - 0.01]",
+        .type        = CONFIG_OPTION_FLOAT,
+        .data        = SConfigOptionDescription::SFloatData{0.0001, 0.000001, 0.01},
+    },
 
     /*
      * input:
@@ -1253,6 +1259,13 @@ inline static const std::vector<SConfigOptionDescription> CONFIG_OPTIONS = {
         .type        = CONFIG_OPTION_BOOL,
         .data        = SConfigOptionDescription::SBoolData{false},
     },
+    SConfigOptionDescription{
+        .value       = "render:async_commit",
+        .description = "Without explicit sync for KMS, waits for the GPU to finish a frame in the event loop before committing it, instead of blocking in glFinish / on the "
+                       "driver. Keeps one monitor's heavy frames from delaying the others. Ignored while tearing.",
+        .type        = CONFIG_OPTION_BOOL,
+        .data        = SConfigOptionDescription::SBoolData{false},
+    },
 
     /*
      * cursor:
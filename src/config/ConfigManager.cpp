@@ -1,5 +1,6 @@
 #include "ConfigManager.hpp"
 #include "../managers/KeybindManager.hpp"
+#include "../managers/ThreadManager.hpp"
 
 #include "../render/decorations/CHyprGroupBarDecoration.hpp"
 #include "config/ConfigDataValues.hpp"
@@ -8,6 +9,7 @@
 #include "../protocols/LayerShell.hpp"
 #include "../xwayland/XWayland.hpp"
 #include "../protocols/OutputManagement.hpp"
+#include "../debug/Benchmark.hpp"
 
 #include <cstddef>
 #include <cstdint>
@@ -26,6 +28,7 @@
 #include <sstream>
 #include <ranges>
 #include <unordered_set>
+#include <typeindex>
 #include <hyprutils/string/String.hpp>
 #include <filesystem>
 using namespace Hyprutils::String;
@@ -326,7 +329,7 @@ CConfigManager::CConfigManager() {
     const auto ERR = verifyConfigExists();
 
     configPaths.emplace_back(getMainConfigPath());
-    m_pConfig = std::make_unique<Hyprlang::CConfig>(configPaths.begin()->c_str(), Hyprlang::SConfigOptions{.throwAllErrors = true, .allowMissingConfig = true});
+    m_pConfig = std::make_unique<CRecordingConfig>(configPaths.begin()->c_str(), Hyprlang::SConfigOptions{.throwAllErrors = true, .allowMissingConfig = true});
 
     m_pConfig->addConfigValue("general:border_size", Hyprlang::INT{1});
     m_pConfig->addConfigValue("general:no_border_on_floating", Hyprlang::INT{0});
@@ -473,6 +476,7 @@ CConfigManager::CConfigManager() {
 
     m_pConfig->addConfigValue("animations:enabled", Hyprlang::INT{1});
     m_pConfig->addConfigValue("animations:first_launch_animation", Hyprlang::INT{1});
+    m_pConfig->addConfigValue("animations:bezier_precision", {0.0001F});
 
     m_pConfig->addConfigValue("input:follow_mouse", Hyprlang::INT{1});
     m_pConfig->addConfigValue("input:focus_on_close", Hyprlang::INT{0});
@@ -593,6 +597,7 @@ CConfigManager::CConfigManager() {
     m_pConfig->addConfigValue("render:explicit_sync", Hyprlang::INT{2});
     m_pConfig->addConfigValue("render:explicit_sync_kms", Hyprlang::INT{2});
     m_pConfig->addConfigValue("render:direct_scanout", Hyprlang::INT{0});
+    m_pConfig->addConfigValue("render:async_commit", Hyprlang::INT{0});
     m_pConfig->addConfigValue("render:expand_undersized_textures", Hyprlang::INT{1});
 
     // devices
@@ -741,15 +746,126 @@ std::string CConfigManager::getErrors() {
     return m_szConfigErrors;
 }
 
+const std::deque<std::string>& CConfigManager::getConfigPaths() {
+    return configPaths;
+}
+
 void CConfigManager::reload() {
     EMIT_HOOK_EVENT("preConfigReload", nullptr);
+
+    const auto PREVIOUS = snapshotCategories();
+
     setDefaultAnimationVars();
     resetHLConfig();
     configCurrentPath = getMainConfigPath();
     const auto ERR    = m_pConfig->parse();
+
+    const auto CURRENT = snapshotCategories();
+
+    for (size_t i = 0; i < CONFIG_CATEGORY_COUNT; ++i) {
+        m_bsChangedCategories[i] = isFirstLaunch || m_bFullReload || PREVIOUS[i] != CURRENT[i];
+    }
+
+    m_bFullReload = false;
+
+    Debug::log(LOG, "Config reloaded, changed categories: {}", m_bsChangedCategories.to_string());
+
     postConfigReload(ERR);
 }
 
+void CRecordingConfig::addConfigValue(const char* name, const Hyprlang::CConfigValue& value) {
+    Hyprlang::CConfig::addConfigValue(name, value);
+    m_vValueNames.emplace_back(name);
+}
+
+void CRecordingConfig::addSpecialConfigValue(const char* cat, const char* name, const Hyprlang::CConfigValue& value) {
+    Hyprlang::CConfig::addSpecialConfigValue(cat, name, value);
+
+    if (std::string_view{cat} == "device")
+        m_vDeviceValueNames.emplace_back(name);
+}
+
+void CConfigManager::recordKeyword(eConfigCategory category, const std::string& command, const std::string& value) {
+    // order matters, e.g. for binds in submaps
+    auto& hash = m_vKeywordHashes[category];
+    hash ^= std::hash<std::string>{}(command + "=" + value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+}
+
+static eConfigCategory categoryOf(const std::string& name) {
+    if (name.starts_with("binds:"))
+        return CONFIG_CATEGORY_KEYBINDS;
+    if (name.starts_with("general:") || name.starts_with("decoration:") || name.starts_with("group:"))
+        return CONFIG_CATEGORY_DECORATION;
+    if (name.starts_with("input:"))
+        return CONFIG_CATEGORY_INPUT;
+    if (name == "misc:vrr")
+        return CONFIG_CATEGORY_MONITORS;
+    if (name.starts_with("animations:"))
+        return CONFIG_CATEGORY_ANIMATIONS;
+
+    return CONFIG_CATEGORY_OTHER;
+}
+
+static std::string stringifyValue(Hyprlang::CConfigValue* value) {
+    if (!value)
+        return "";
+
+    const auto VAL  = value->getValue();
+    const auto TYPE = std::type_index(VAL.type());
+
+    if (TYPE == typeid(Hyprlang::INT))
+        return std::to_string(std::any_cast<Hyprlang::INT>(VAL));
+    else if (TYPE == typeid(Hyprlang::FLOAT))
+        return std::to_string(std::any_cast<Hyprlang::FLOAT>(VAL));
+    else if (TYPE == typeid(Hyprlang::VEC2))
+        return std::format("{} {}", std::any_cast<Hyprlang::VEC2>(VAL).x, std::any_cast<Hyprlang::VEC2>(VAL).y);
+    else if (TYPE == typeid(Hyprlang::STRING))
+        return std::any_cast<Hyprlang::STRING>(VAL);
+    else if (TYPE == typeid(void*))
+        return ((ICustomConfigValueData*)std::any_cast<void*>(VAL))->toString();
+
+    return "";
+}
+
+std::array<size_t, CONFIG_CATEGORY_COUNT> CConfigManager::snapshotCategories() {
+    std::array<size_t, CONFIG_CATEGORY_COUNT> hashes = {};
+
+    // everything is applied on the first launch anyways
+    if (isFirstLaunch)
+        return hashes;
+
+    std::array<std::string, CONFIG_CATEGORY_COUNT> values;
+
+    for (auto const& name : m_pConfig->m_vValueNames) {
+        values[categoryOf(name)] += name + "=" + stringifyValue(m_pConfig->getConfigValuePtr(name.c_str())) + "\n";
+    }
+
+    // device sections only matter for the devices we have
+    for (auto const& h : g_pInputManager->m_vHIDs) {
+        const auto PHID = h.lock();
+
+        if (!PHID || !deviceConfigExists(PHID->hlName))
+            continue;
+
+        auto devname = PHID->hlName;
+        std::replace(devname.begin(), devname.end(), ' ', '-');
+
+        for (auto const& name : m_pConfig->m_vDeviceValueNames) {
+            values[CONFIG_CATEGORY_INPUT] += devname + ":" + name + "=" + stringifyValue(m_pConfig->getSpecialConfigValuePtr("device", name.c_str(), devname.c_str())) + "\n";
+        }
+    }
+
+    for (auto const& v : pluginVariables) {
+        values[CONFIG_CATEGORY_OTHER] += v.name + "=" + stringifyValue(m_pConfig->getSpecialConfigValuePtr("plugin", v.name.c_str(), nullptr)) + "\n";
+    }
+
+    for (size_t i = 0; i < CONFIG_CATEGORY_COUNT; ++i) {
+        hashes[i] = std::hash<std::string>{}(values[i]) ^ m_vKeywordHashes[i];
+    }
+
+    return hashes;
+}
+
 void CConfigManager::setDefaultAnimationVars() {
     if (isFirstLaunch) {
         INITANIMCFG("global");
@@ -822,6 +938,7 @@ void CConfigManager::setDefaultAnimationVars() {
 std::optional<std::string> CConfigManager::resetHLConfig() {
     m_dMonitorRules.clear();
     m_dWindowRules.clear();
+    m_bWindowRulesDirty = true;
     g_pKeybindManager->clearKeybinds();
     g_pAnimationManager->removeAllBeziers();
     m_mAdditionalReservedAreas.clear();
@@ -830,8 +947,10 @@ std::optional<std::string> CConfigManager::resetHLConfig() {
     setDefaultAnimationVars(); // reset anims
     m_vDeclaredPlugins.clear();
     m_dLayerRules.clear();
+    m_bLayerRulesDirty = true;
     m_vFailedPluginConfigValues.clear();
     finalExecRequests.clear();
+    m_vKeywordHashes.fill(0);
 
     // paths
     configPaths.clear();
@@ -848,22 +967,33 @@ void CConfigManager::postConfigReload(const Hyprlang::CParseResult& result) {
     static const auto PENABLEEXPLICIT     = CConfigValue<Hyprlang::INT>("render:explicit_sync");
     static int        prevEnabledExplicit = *PENABLEEXPLICIT;
 
-    for (auto const& w : g_pCompositor->m_vWindows) {
-        w->uncacheWindowDecos();
+    // only reapply what changed. Binds, input and animations can't change how windows are laid out or look
+    const bool DECORATION = m_bsChangedCategories[CONFIG_CATEGORY_DECORATION];
+    const bool RULES      = m_bsChangedCategories[CONFIG_CATEGORY_RULES];
+    const bool INPUT      = m_bsChangedCategories[CONFIG_CATEGORY_INPUT];
+    const bool MONITORS   = m_bsChangedCategories[CONFIG_CATEGORY_MONITORS];
+    const bool VISUAL     = DECORATION || RULES || MONITORS || m_bsChangedCategories[CONFIG_CATEGORY_OTHER];
+
+    if (DECORATION) {
+        for (auto const& w : g_pCompositor->m_vWindows) {
+            w->uncacheWindowDecos();
+        }
     }
 
-    for (auto const& m : g_pCompositor->m_vMonitors)
-        g_pLayoutManager->getCurrentLayout()->recalculateMonitor(m->ID);
+    if (VISUAL) {
+        for (auto const& m : g_pCompositor->m_vMonitors)
+            g_pLayoutManager->getCurrentLayout()->recalculateMonitor(m->ID);
+    }
 
     // Update the keyboard layout to the cfg'd one if this is not the first launch
-    if (!isFirstLaunch) {
+    if (!isFirstLaunch && INPUT) {
         g_pInputManager->setKeyboardLayout();
         g_pInputManager->setPointerConfigs();
         g_pInputManager->setTouchDeviceConfigs();
         g_pInputManager->setTabletConfigs();
     }
 
-    if (!isFirstLaunch)
+    if (!isFirstLaunch && DECORATION)
         g_pHyprOpenGL->m_bReloadScreenShader = true;
 
     // parseError will be displayed next frame
@@ -889,7 +1019,7 @@ void CConfigManager::postConfigReload(const Hyprlang::CParseResult& result) {
     // not on first launch because monitors might not exist yet
     // and they'll be taken care of in the newMonitor event
     // ignore if nomonitorreload is set
-    if (!isFirstLaunch && !m_bNoMonitorReload) {
+    if (!isFirstLaunch && !m_bNoMonitorReload && MONITORS) {
         // check
         performMonitorReload();
         ensureMonitorStatus();
@@ -919,19 +1049,24 @@ void CConfigManager::postConfigReload(const Hyprlang::CParseResult& result) {
         g_pCompositor->m_bEnableXwayland = PENABLEXWAYLAND;
 #endif
 
-    if (!isFirstLaunch && !g_pCompositor->m_bUnsafeState)
+    if (!isFirstLaunch && !g_pCompositor->m_bUnsafeState && DECORATION)
         refreshGroupBarGradients();
 
     // Updates dynamic window and workspace rules
-    for (auto const& w : g_pCompositor->m_vWorkspaces) {
-        if (w->inert())
-            continue;
-        g_pCompositor->updateWorkspaceWindows(w->m_iID);
-        g_pCompositor->updateWorkspaceWindowData(w->m_iID);
+    if (RULES || DECORATION) {
+        for (auto const& w : g_pCompositor->m_vWorkspaces) {
+            if (w->inert())
+                continue;
+            g_pCompositor->updateWorkspaceWindows(w->m_iID);
+            g_pCompositor->updateWorkspaceWindowData(w->m_iID);
+        }
     }
 
-    // Update window border colors
-    g_pCompositor->updateAllWindowsAnimatedDecorationValues();
+    // Update window border colors, and the input boxes borders and shadows add to
+    if (DECORATION) {
+        g_pCompositor->updateAllWindowsAnimatedDecorationValues();
+        g_pCompositor->rebuildWindowHitIndex();
+    }
 
     // update layout
     g_pLayoutManager->switchToLayout(std::any_cast<Hyprlang::STRING>(m_pConfig->getConfigValue("general:layout")));
@@ -951,18 +1086,20 @@ void CConfigManager::postConfigReload(const Hyprlang::CParseResult& result) {
 
     Debug::coloredLogs = reinterpret_cast<int64_t* const*>(m_pConfig->getConfigValuePtr("debug:colored_stdout_logs")->getDataStaticPtr());
 
-    for (auto const& m : g_pCompositor->m_vMonitors) {
-        // mark blur dirty
-        g_pHyprOpenGL->markBlurDirtyForMonitor(m);
+    if (VISUAL) {
+        for (auto const& m : g_pCompositor->m_vMonitors) {
+            // mark blur dirty
+            g_pHyprOpenGL->markBlurDirtyForMonitor(m);
 
-        g_pCompositor->scheduleFrameForMonitor(m);
+            g_pCompositor->scheduleFrameForMonitor(m);
 
-        // Force the compositor to fully re-render all monitors
-        m->forceFullFrames = 2;
+            // Force the compositor to fully re-render all monitors
+            m->forceFullFrames = 2;
 
-        // also force mirrors, as the aspect ratio could've changed
-        for (auto const& mirror : m->mirrors)
-            mirror->forceFullFrames = 3;
+            // also force mirrors, as the aspect ratio could've changed
+            for (auto const& mirror : m->mirrors)
+                mirror->forceFullFrames = 3;
+        }
     }
 
     // Reset no monitor reload
@@ -1036,7 +1173,8 @@ void CConfigManager::tick() {
         return;
     }
 
-    bool parse = false;
+    // the watcher knows, or we stat
+    bool parse = m_bFilesChanged;
 
     for (auto const& cf : configPaths) {
         struct stat fileStat;
@@ -1054,12 +1192,23 @@ void CConfigManager::tick() {
     }
 
     if (parse) {
-        m_bForceReload = false;
+        // an explicit reload reapplies everything, a changed file only what changed
+        m_bFullReload   = m_bForceReload;
+        m_bForceReload  = false;
+        m_bFilesChanged = false;
 
         reload();
     }
 }
 
+void CConfigManager::scheduleReload() {
+    m_bForceReload = true;
+
+    // with a config watch, the timer only runs when armed
+    if (g_pThreadManager && g_pThreadManager->m_esConfigTimer)
+        wl_event_source_timer_update(g_pThreadManager->m_esConfigTimer, 1);
+}
+
 Hyprlang::CConfigValue* CConfigManager::getConfigValueSafeDevice(const std::string& dev, const std::string& val, const std::string& fallback) {
 
     const auto VAL = m_pConfig->getSpecialConfigValuePtr("device", val.c_str(), dev.c_str());
@@ -1233,61 +1382,21 @@ std::vector<SWindowRule> CConfigManager::getMatchingRules(PHLWINDOW pWindow, boo
     // local tags for dynamic tag rule match
     auto tags = pWindow->m_tags;
 
-    for (auto const& rule : m_dWindowRules) {
-        // check if we have a matching rule
-        if (!rule.v2) {
-            try {
-                if (rule.szValue.starts_with("tag:") && !tags.isTagged(rule.szValue.substr(4)))
-                    continue;
+    if (m_bWindowRulesDirty) {
+        m_windowRuleMatcher.rebuild(m_dWindowRules);
+        m_bWindowRulesDirty = false;
+    }
 
-                if (rule.szValue.starts_with("title:")) {
-                    std::regex RULECHECK(rule.szValue.substr(6));
+    // class / title patterns are already checked (and cached) by the matcher, only dynamic properties are left
+    for (auto const& idx : m_windowRuleMatcher.candidatesFor(pWindow)) {
+        const auto& COMPILED = m_windowRuleMatcher.at(idx);
+        const auto& rule     = COMPILED.rule;
 
-                    if (!std::regex_search(title, RULECHECK))
-                        continue;
-                } else {
-                    std::regex classCheck(rule.szValue);
+        if (!COMPILED.tag.empty() && !tags.isTagged(COMPILED.tag))
+            continue;
 
-                    if (!std::regex_search(appidclass, classCheck))
-                        continue;
-                }
-            } catch (...) {
-                Debug::log(ERR, "Regex error at {}", rule.szValue);
-                continue;
-            }
-        } else {
+        if (rule.v2) {
             try {
-                if (!rule.szTag.empty() && !tags.isTagged(rule.szTag))
-                    continue;
-
-                if (!rule.szClass.empty()) {
-                    std::regex RULECHECK(rule.szClass);
-
-                    if (!std::regex_search(appidclass, RULECHECK))
-                        continue;
-                }
-
-                if (!rule.szTitle.empty()) {
-                    std::regex RULECHECK(rule.szTitle);
-
-                    if (!std::regex_search(title, RULECHECK))
-                        continue;
-                }
-
-                if (!rule.szInitialTitle.empty()) {
-                    std::regex RULECHECK(rule.szInitialTitle);
-
-                    if (!std::regex_search(pWindow->m_szInitialTitle, RULECHECK))
-                        continue;
-                }
-
-                if (!rule.szInitialClass.empty()) {
-                    std::regex RULECHECK(rule.szInitialClass);
-
-                    if (!std::regex_search(pWindow->m_szInitialClass, RULECHECK))
-                        continue;
-                }
-
                 if (rule.bX11 != -1) {
                     if (pWindow->m_bIsX11 != rule.bX11)
                         continue;
@@ -1366,7 +1475,7 @@ std::vector<SWindowRule> CConfigManager::getMatchingRules(PHLWINDOW pWindow, boo
                     }
                 }
             } catch (std::exception& e) {
-                Debug::log(ERR, "Regex error at {} ({})", rule.szValue, e.what());
+                Debug::log(ERR, "Rule error at {} ({})", rule.szValue, e.what());
                 continue;
             }
         }
@@ -1393,8 +1502,8 @@ std::vector<SWindowRule> CConfigManager::getMatchingRules(PHLWINDOW pWindow, boo
     }
 
     std::vector<uint64_t> PIDs = {(uint64_t)pWindow->getPID()};
-    while (getPPIDof(PIDs.back()) > 10)
-        PIDs.push_back(getPPIDof(PIDs.back()));
+    while (g_pProcessManager->getPPID(PIDs.back()) > 10)
+        PIDs.push_back(g_pProcessManager->getPPID(PIDs.back()));
 
     bool anyExecFound = false;
 
@@ -1418,19 +1527,13 @@ std::vector<SLayerRule> CConfigManager::getMatchingRules(PHLLS pLS) {
     if (!pLS->layerSurface || pLS->fadingOut)
         return returns;
 
-    for (auto const& lr : m_dLayerRules) {
-        if (lr.targetNamespace.starts_with("address:0x")) {
-            if (std::format("address:0x{:x}", (uintptr_t)pLS.get()) != lr.targetNamespace)
-                continue;
-        } else {
-            std::regex NSCHECK(lr.targetNamespace);
-
-            if (!std::regex_search(pLS->layerSurface->layerNamespace, NSCHECK))
-                continue;
-        }
+    if (m_bLayerRulesDirty) {
+        m_layerRuleMatcher.rebuild(m_dLayerRules);
+        m_bLayerRulesDirty = false;
+    }
 
-        // hit
-        returns.push_back(lr);
+    for (auto const& idx : m_layerRuleMatcher.candidatesFor(pLS)) {
+        returns.push_back(m_layerRuleMatcher.at(idx).rule);
     }
 
     if (shouldBlurLS(pLS->layerSurface->layerNamespace))
@@ -1440,7 +1543,8 @@ std::vector<SLayerRule> CConfigManager::getMatchingRules(PHLLS pLS) {
 }
 
 void CConfigManager::dispatchExecOnce() {
-    if (firstExecDispatched || isFirstLaunch)
+    // nothing but the synthetic content while benchmarking
+    if (firstExecDispatched || isFirstLaunch || g_pBenchmark)
         return;
 
     // update dbus env
@@ -1589,6 +1693,7 @@ void CConfigManager::ensureVRR(PHLMONITOR pMonitor) {
 
         if (USEVRR == 0) {
             if (m->vrrActive) {
+                g_pHyprRenderer->finishPendingCommit(m);
                 m->output->state->resetExplicitFences();
                 m->output->state->setAdaptiveSync(false);
 
@@ -1599,6 +1704,7 @@ void CConfigManager::ensureVRR(PHLMONITOR pMonitor) {
             return;
         } else if (USEVRR == 1) {
             if (!m->vrrActive) {
+                g_pHyprRenderer->finishPendingCommit(m);
                 m->output->state->resetExplicitFences();
                 m->output->state->setAdaptiveSync(true);
 
@@ -1624,6 +1730,7 @@ void CConfigManager::ensureVRR(PHLMONITOR pMonitor) {
                 /* fullscreen */
                 m->vrrActive = true;
 
+                g_pHyprRenderer->finishPendingCommit(m);
                 m->output->state->resetExplicitFences();
                 m->output->state->setAdaptiveSync(true);
 
@@ -1638,6 +1745,7 @@ void CConfigManager::ensureVRR(PHLMONITOR pMonitor) {
             } else if (!WORKSPACEFULL) {
                 m->vrrActive = false;
 
+                g_pHyprRenderer->finishPendingCommit(m);
                 m->output->state->resetExplicitFences();
                 m->output->state->setAdaptiveSync(false);
 
@@ -1860,6 +1968,7 @@ static bool parseModeLine(const std::string& modeline, drmModeModeInfo& mode) {
 }
 
 std::optional<std::string> CConfigManager::handleMonitor(const std::string& command, const std::string& args) {
+    recordKeyword(CONFIG_CATEGORY_MONITORS, command, args);
 
     // get the monitor config
     SMonitorRule newrule;
@@ -2044,6 +2153,8 @@ std::optional<std::string> CConfigManager::handleMonitor(const std::string& comm
 }
 
 std::optional<std::string> CConfigManager::handleBezier(const std::string& command, const std::string& args) {
+    recordKeyword(CONFIG_CATEGORY_ANIMATIONS, command, args);
+
     const auto  ARGS = CVarList(args);
 
     std::string bezierName = ARGS[0];
@@ -2084,6 +2195,8 @@ void CConfigManager::setAnimForChildren(SAnimationPropertyConfig* const ANIM) {
 };
 
 std::optional<std::string> CConfigManager::handleAnimation(const std::string& command, const std::string& args) {
+    recordKeyword(CONFIG_CATEGORY_ANIMATIONS, command, args);
+
     const auto ARGS = CVarList(args);
 
     // Master on/off
@@ -2123,7 +2236,8 @@ std::optional<std::string> CConfigManager::handleAnimation(const std::string& co
         }
 
         // curve
-        PANIM->second.internalBezier = ARGS[3];
+        PANIM->second.internalBezier           = ARGS[3];
+        PANIM->second.internalBezierGeneration = 0;
 
         if (!g_pAnimationManager->bezierExists(ARGS[3])) {
             PANIM->second.internalBezier = "default";
@@ -2159,6 +2273,8 @@ SParsedKey parseKey(const std::string& key) {
 }
 
 std::optional<std::string> CConfigManager::handleBind(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_KEYBINDS, command, value);
+
     // example:
     // bind[fl]=SUPER,G,exec,dmenu_run <args>
 
@@ -2273,6 +2389,8 @@ std::optional<std::string> CConfigManager::handleBind(const std::string& command
 }
 
 std::optional<std::string> CConfigManager::handleUnbind(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_KEYBINDS, command, value);
+
     const auto ARGS = CVarList(value);
 
     const auto MOD = g_pKeybindManager->stringToModMask(ARGS[0]);
@@ -2307,6 +2425,8 @@ bool layerRuleValid(const std::string& RULE) {
 }
 
 std::optional<std::string> CConfigManager::handleWindowRule(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_RULES, command, value);
+
     const auto RULE  = trim(value.substr(0, value.find_first_of(',')));
     const auto VALUE = trim(value.substr(value.find_first_of(',') + 1));
 
@@ -2316,6 +2436,7 @@ std::optional<std::string> CConfigManager::handleWindowRule(const std::string& c
 
     if (RULE == "unset") {
         std::erase_if(m_dWindowRules, [&](const SWindowRule& other) { return other.szValue == VALUE; });
+        m_bWindowRulesDirty = true;
         return {};
     }
 
@@ -2330,10 +2451,14 @@ std::optional<std::string> CConfigManager::handleWindowRule(const std::string& c
     else
         m_dWindowRules.push_back({RULE, VALUE});
 
+    m_bWindowRulesDirty = true;
+
     return {};
 }
 
 std::optional<std::string> CConfigManager::handleLayerRule(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_RULES, command, value);
+
     const auto RULE  = trim(value.substr(0, value.find_first_of(',')));
     const auto VALUE = trim(value.substr(value.find_first_of(',') + 1));
 
@@ -2343,6 +2468,7 @@ std::optional<std::string> CConfigManager::handleLayerRule(const std::string& co
 
     if (RULE == "unset") {
         std::erase_if(m_dLayerRules, [&](const SLayerRule& other) { return other.targetNamespace == VALUE; });
+        m_bLayerRulesDirty = true;
         return {};
     }
 
@@ -2352,6 +2478,7 @@ std::optional<std::string> CConfigManager::handleLayerRule(const std::string& co
     }
 
     m_dLayerRules.push_back({VALUE, RULE});
+    m_bLayerRulesDirty = true;
 
     for (auto const& m : g_pCompositor->m_vMonitors)
         for (auto const& lsl : m->m_aLayerSurfaceLayers)
@@ -2362,6 +2489,8 @@ std::optional<std::string> CConfigManager::handleLayerRule(const std::string& co
 }
 
 std::optional<std::string> CConfigManager::handleWindowRuleV2(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_RULES, command, value);
+
     const auto RULE  = trim(value.substr(0, value.find_first_of(',')));
     const auto VALUE = value.substr(value.find_first_of(',') + 1);
 
@@ -2535,6 +2664,7 @@ std::optional<std::string> CConfigManager::handleWindowRuleV2(const std::string&
                 return true;
             }
         });
+        m_bWindowRulesDirty = true;
         return {};
     }
 
@@ -2543,6 +2673,8 @@ std::optional<std::string> CConfigManager::handleWindowRuleV2(const std::string&
     else
         m_dWindowRules.push_back(rule);
 
+    m_bWindowRulesDirty = true;
+
     return {};
 }
 
@@ -2568,6 +2700,8 @@ void CConfigManager::updateBlurredLS(const std::string& name, const bool forceBl
 }
 
 std::optional<std::string> CConfigManager::handleBlurLS(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_DECORATION, command, value);
+
     if (value.starts_with("remove,")) {
         const auto TOREMOVE = trim(value.substr(7));
         if (std::erase_if(m_dBlurLSNamespaces, [&](const auto& other) { return other == TOREMOVE; }))
@@ -2582,6 +2716,8 @@ std::optional<std::string> CConfigManager::handleBlurLS(const std::string& comma
 }
 
 std::optional<std::string> CConfigManager::handleWorkspaceRules(const std::string& command, const std::string& value) {
+    recordKeyword(CONFIG_CATEGORY_RULES, command, value);
+
     // This can either be the monitor or the workspace identifier
     const auto FIRST_DELIM = value.find_first_of(',');
 
@@ -2685,6 +2821,8 @@ std::optional<std::string> CConfigManager::handleWorkspaceRules(const std::strin
 }
 
 std::optional<std::string> CConfigManager::handleSubmap(const std::string& command, const std::string& submap) {
+    recordKeyword(CONFIG_CATEGORY_KEYBINDS, command, submap);
+
     if (submap == "reset")
         m_szCurrentSubmap = "";
     else
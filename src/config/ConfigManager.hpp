@@ -9,6 +9,8 @@
 #include <variant>
 #include <vector>
 #include <deque>
+#include <array>
+#include <bitset>
 #include <algorithm>
 #include <regex>
 #include <optional>
@@ -22,6 +24,7 @@
 
 #include "defaultConfig.hpp"
 #include "ConfigDataValues.hpp"
+#include "RuleMatcher.hpp"
 
 #include <hyprlang.hpp>
 
@@ -56,6 +59,8 @@ struct SMonitorAdditionalReservedArea {
     int right  = 0;
 };
 
+class CBezierCurve;
+
 struct SAnimationPropertyConfig {
     bool                      overridden = true;
 
@@ -64,6 +69,10 @@ struct SAnimationPropertyConfig {
     float                     internalSpeed   = 0.f;
     int                       internalEnabled = -1;
 
+    // resolved internalBezier, see CAnimationManager::getBezierHandle
+    CBezierCurve*             internalBezierHandle     = nullptr;
+    uint64_t                  internalBezierGeneration = 0;
+
     SAnimationPropertyConfig* pValues          = nullptr;
     SAnimationPropertyConfig* pParentAnimation = nullptr;
 };
@@ -84,6 +93,18 @@ struct SExecRequestedRule {
     uint64_t    iPid   = 0;
 };
 
+// what a reload can change, each reapplied only if it did
+enum eConfigCategory : uint8_t {
+    CONFIG_CATEGORY_KEYBINDS = 0, // bind, unbind, submap, binds:
+    CONFIG_CATEGORY_RULES,        // windowrule(v2), layerrule, workspace
+    CONFIG_CATEGORY_DECORATION,   // general:, decoration:, group:, blurls
+    CONFIG_CATEGORY_INPUT,        // input:, device sections
+    CONFIG_CATEGORY_MONITORS,     // monitor, misc:vrr
+    CONFIG_CATEGORY_ANIMATIONS,   // bezier, animation, animations:
+    CONFIG_CATEGORY_OTHER,        // everything else, plugin values included
+    CONFIG_CATEGORY_COUNT,
+};
+
 enum eConfigOptionType : uint16_t {
     CONFIG_OPTION_BOOL         = 0,
     CONFIG_OPTION_INT          = 1, /* e.g. 0/1/2*/
@@ -148,11 +169,25 @@ struct SConfigOptionDescription {
     std::variant<SBoolData, SRangeData, SFloatData, SStringData, SColorData, SChoiceData, SGradientData, SVectorData> data;
 };
 
+// hyprlang's config, remembering which values got registered so reloads can tell what changed, see CConfigManager::snapshotCategories.
+// Hides hyprlang's adders, so registering through m_pConfig is all it takes.
+class CRecordingConfig : public Hyprlang::CConfig {
+  public:
+    using Hyprlang::CConfig::CConfig;
+
+    void                     addConfigValue(const char* name, const Hyprlang::CConfigValue& value);
+    void                     addSpecialConfigValue(const char* cat, const char* name, const Hyprlang::CConfigValue& value);
+
+    std::vector<std::string> m_vValueNames;
+    std::vector<std::string> m_vDeviceValueNames; // of device sections
+};
+
 class CConfigManager {
   public:
     CConfigManager();
 
     void                                                            tick();
+    void                                                            scheduleReload(); // a full reload on the next tick, which is armed right away
     void                                                            init();
 
     int                                                             getDeviceInt(const std::string&, const std::string&, const std::string& fallback = "");
@@ -168,6 +203,7 @@ class CConfigManager {
     void                                                            onPluginLoadUnload(const std::string& name, bool load);
     static std::string                                              getMainConfigPath();
     const std::string                                               getConfigString();
+    const std::deque<std::string>&                                  getConfigPaths();
 
     SMonitorRule                                                    getMonitorRuleFor(const PHLMONITOR);
     SWorkspaceRule                                                  getWorkspaceRuleFor(PHLWORKSPACE workspace);
@@ -263,11 +299,12 @@ class CConfigManager {
 
     bool m_bWantsMonitorReload = false;
     bool m_bForceReload        = false;
+    bool m_bFilesChanged       = false; // set by the config watcher, reloads on the next tick
     bool m_bNoMonitorReload    = false;
     bool isLaunchingExecOnce   = false; // For exec-once to skip initial ws tracking
 
   private:
-    std::unique_ptr<Hyprlang::CConfig>                        m_pConfig;
+    std::unique_ptr<CRecordingConfig>                         m_pConfig;
 
     std::deque<std::string>                                   configPaths;       // stores all the config paths
     std::unordered_map<std::string, time_t>                   configModifyTimes; // stores modify times
@@ -288,6 +325,10 @@ class CConfigManager {
     std::deque<SWorkspaceRule>                                m_dWorkspaceRules;
     std::deque<SWindowRule>                                   m_dWindowRules;
     std::deque<SLayerRule>                                    m_dLayerRules;
+    CWindowRuleMatcher                                        m_windowRuleMatcher;
+    CLayerRuleMatcher                                         m_layerRuleMatcher;
+    bool                                                      m_bWindowRulesDirty = true; // rules changed, matchers need a rebuild
+    bool                                                      m_bLayerRulesDirty  = true;
     std::deque<std::string>                                   m_dBlurLSNamespaces;
 
     bool                                                      firstExecDispatched     = false;
@@ -298,16 +339,22 @@ class CConfigManager {
     std::vector<std::pair<std::string, std::string>>          m_vFailedPluginConfigValues; // for plugin values of unloaded plugins
     std::string                                               m_szConfigErrors = "";
 
+    std::array<size_t, CONFIG_CATEGORY_COUNT>                 m_vKeywordHashes = {}; // of the keywords parsed since the last reset
+    std::bitset<CONFIG_CATEGORY_COUNT>                        m_bsChangedCategories; // by the last reload
+    bool                                                      m_bFullReload = false; // reapply everything on the next reload
+
     // internal methods
-    void                              setAnimForChildren(SAnimationPropertyConfig* const);
-    void                              updateBlurredLS(const std::string&, const bool);
-    void                              setDefaultAnimationVars();
-    std::optional<std::string>        resetHLConfig();
-    static std::optional<std::string> generateConfig(std::string configPath);
-    static std::optional<std::string> verifyConfigExists();
-    void                              postConfigReload(const Hyprlang::CParseResult& result);
-    void                              reload();
-    SWorkspaceRule                    mergeWorkspaceRules(const SWorkspaceRule&, const SWorkspaceRule&);
+    void                                      setAnimForChildren(SAnimationPropertyConfig* const);
+    void                                      updateBlurredLS(const std::string&, const bool);
+    void                                      setDefaultAnimationVars();
+    std::optional<std::string>                resetHLConfig();
+    static std::optional<std::string>         generateConfig(std::string configPath);
+    static std::optional<std::string>         verifyConfigExists();
+    void                                      postConfigReload(const Hyprlang::CParseResult& result);
+    void                                      reload();
+    SWorkspaceRule                            mergeWorkspaceRules(const SWorkspaceRule&, const SWorkspaceRule&);
+    void                                      recordKeyword(eConfigCategory category, const std::string& command, const std::string& value);
+    std::array<size_t, CONFIG_CATEGORY_COUNT> snapshotCategories();
 };
 
 inline std::unique_ptr<CConfigManager> g_pConfigManager;
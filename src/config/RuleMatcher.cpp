@@ -0,0 +1,349 @@
+#include "RuleMatcher.hpp"
+#include "../debug/Log.hpp"
+#include <algorithm>
+#include <cctype>
+
+static bool isRegexSpecial(char c) {
+    switch (c) {
+        case '\\':
+        case '^':
+        case '$':
+        case '.':
+        case '|':
+        case '?':
+        case '*':
+        case '+':
+        case '(':
+        case ')':
+        case '[':
+        case ']':
+        case '{':
+        case '}': return true;
+        default: return false;
+    }
+}
+
+static bool isPlainLiteral(const std::string& str) {
+    return std::ranges::none_of(str, isRegexSpecial);
+}
+
+// Longest literal run that every match of the pattern has to contain.
+// Conservative: anything not trivially required (alternations, groups, optional chars) breaks the run.
+static std::string requiredLiteral(const std::string& pattern) {
+    if (pattern.contains('|'))
+        return "";
+
+    std::string best, current;
+    int         depth = 0;
+
+    const auto  endRun = [&]() {
+        if (depth == 0 && current.length() > best.length())
+            best = current;
+        current.clear();
+    };
+
+    for (size_t i = 0; i < pattern.length(); ++i) {
+        const char c = pattern[i];
+
+        if (c == '\\') {
+            // escaped punctuation is a literal char, \d \w \b etc. are classes
+            if (i + 1 < pattern.length() && !std::isalnum((unsigned char)pattern[i + 1]) && depth == 0) {
+                current += pattern[++i];
+                continue;
+            }
+
+            endRun();
+            ++i;
+            continue;
+        }
+
+        if (c == '?' || c == '*' || c == '{') {
+            // previous char is optional
+            if (!current.empty())
+                current.pop_back();
+            endRun();
+
+            // skip the {n,m} body
+            if (c == '{') {
+                while (i < pattern.length() && pattern[i] != '}')
+                    ++i;
+            }
+            continue;
+        }
+
+        if (c == '[') {
+            endRun();
+            // skip the whole bracket expression
+            ++i;
+            if (i < pattern.length() && pattern[i] == '^')
+                ++i;
+            if (i < pattern.length() && pattern[i] == ']')
+                ++i;
+            while (i < pattern.length() && pattern[i] != ']') {
+                if (pattern[i] == '\\')
+                    ++i;
+                ++i;
+            }
+            continue;
+        }
+
+        if (c == '(') {
+            endRun();
+            depth++;
+            continue;
+        }
+
+        if (c == ')') {
+            endRun();
+            depth = std::max(depth - 1, 0);
+            continue;
+        }
+
+        if (isRegexSpecial(c)) {
+            endRun();
+            continue;
+        }
+
+        if (depth == 0)
+            current += c;
+    }
+
+    endRun();
+
+    return best;
+}
+
+CRulePattern::CRulePattern(const std::string& pattern) {
+    if (pattern.empty())
+        return;
+
+    if (isPlainLiteral(pattern)) {
+        m_eKind     = PATTERN_SUBSTRING;
+        m_szLiteral = pattern;
+        return;
+    }
+
+    if (pattern.length() > 2 && pattern.starts_with('^') && pattern.ends_with('$')) {
+        auto inner = pattern.substr(1, pattern.length() - 2);
+        if (inner.length() > 2 && inner.starts_with('(') && inner.ends_with(')'))
+            inner = inner.substr(1, inner.length() - 2);
+
+        if (isPlainLiteral(inner)) {
+            m_eKind     = PATTERN_EXACT;
+            m_szLiteral = inner;
+            return;
+        }
+    }
+
+    try {
+        m_regex     = std::regex(pattern, std::regex::optimize);
+        m_eKind     = PATTERN_REGEX;
+        m_szLiteral = requiredLiteral(pattern);
+    } catch (std::exception& e) {
+        Debug::log(ERR, "Regex error at {} ({})", pattern, e.what());
+        m_eKind = PATTERN_INVALID;
+    }
+}
+
+bool CRulePattern::matches(const std::string& str) const {
+    switch (m_eKind) {
+        case PATTERN_EMPTY: return true;
+        case PATTERN_EXACT: return str == m_szLiteral;
+        case PATTERN_SUBSTRING: return str.contains(m_szLiteral);
+        case PATTERN_REGEX:
+            if (!m_szLiteral.empty() && !str.contains(m_szLiteral))
+                return false;
+            return std::regex_search(str, *m_regex);
+        default: break;
+    }
+
+    return false;
+}
+
+bool CRulePattern::valid() const {
+    return m_eKind != PATTERN_INVALID;
+}
+
+bool CRulePattern::empty() const {
+    return m_eKind == PATTERN_EMPTY;
+}
+
+std::optional<std::string> CRulePattern::exactLiteral() const {
+    if (m_eKind != PATTERN_EXACT)
+        return std::nullopt;
+
+    return m_szLiteral;
+}
+
+void CRuleIndex::clear() {
+    m_mExactBuckets.clear();
+    m_vGeneric.clear();
+}
+
+void CRuleIndex::add(size_t idx, const std::optional<std::string>& exactKey) {
+    if (exactKey.has_value())
+        m_mExactBuckets[*exactKey].push_back(idx);
+    else
+        m_vGeneric.push_back(idx);
+}
+
+void CRuleIndex::collect(const std::string& key, std::vector<size_t>& out) const {
+    out.clear();
+
+    const auto IT = m_mExactBuckets.find(key);
+    if (IT == m_mExactBuckets.end()) {
+        out = m_vGeneric;
+        return;
+    }
+
+    // both lists are sorted, keep rule order
+    out.reserve(IT->second.size() + m_vGeneric.size());
+    std::ranges::merge(IT->second, m_vGeneric, std::back_inserter(out));
+}
+
+void CWindowRuleMatcher::rebuild(const std::deque<SWindowRule>& rules) {
+    m_vRules.clear();
+    m_vRules.reserve(rules.size());
+    m_index.clear();
+    m_iUsedFields = 0;
+    m_iGeneration++;
+
+    for (auto const& r : rules) {
+        SCompiledWindowRule compiled;
+        compiled.rule = r;
+
+        if (!r.v2) {
+            if (r.szValue.starts_with("tag:"))
+                compiled.tag = r.szValue.substr(4);
+            else if (r.szValue.starts_with("title:"))
+                compiled.titlePattern = CRulePattern(r.szValue.substr(6));
+            else
+                compiled.classPattern = CRulePattern(r.szValue);
+        } else {
+            compiled.tag                 = r.szTag;
+            compiled.classPattern        = CRulePattern(r.szClass);
+            compiled.titlePattern        = CRulePattern(r.szTitle);
+            compiled.initialClassPattern = CRulePattern(r.szInitialClass);
+            compiled.initialTitlePattern = CRulePattern(r.szInitialTitle);
+        }
+
+        // a rule with a broken regex can never match, don't even index it
+        if (!compiled.classPattern.valid() || !compiled.titlePattern.valid() || !compiled.initialClassPattern.valid() || !compiled.initialTitlePattern.valid())
+            continue;
+
+        if (!compiled.classPattern.empty())
+            m_iUsedFields |= RULE_FIELD_CLASS;
+        if (!compiled.titlePattern.empty())
+            m_iUsedFields |= RULE_FIELD_TITLE;
+        if (!compiled.initialClassPattern.empty())
+            m_iUsedFields |= RULE_FIELD_INITIALCLASS;
+        if (!compiled.initialTitlePattern.empty())
+            m_iUsedFields |= RULE_FIELD_INITIALTITLE;
+
+        m_index.add(m_vRules.size(), compiled.classPattern.exactLiteral());
+        m_vRules.emplace_back(std::move(compiled));
+    }
+
+    Debug::log(LOG, "Compiled {} window rules ({} dropped)", m_vRules.size(), rules.size() - m_vRules.size());
+}
+
+bool CWindowRuleMatcher::cacheValid(PHLWINDOW pWindow) const {
+    const auto& CACHE = pWindow->m_sRuleMatchCache;
+
+    if (CACHE.generation != m_iGeneration)
+        return false;
+
+    if ((m_iUsedFields & RULE_FIELD_CLASS) && CACHE.szClass != pWindow->m_szClass)
+        return false;
+    if ((m_iUsedFields & RULE_FIELD_TITLE) && CACHE.szTitle != pWindow->m_szTitle)
+        return false;
+    if ((m_iUsedFields & RULE_FIELD_INITIALCLASS) && CACHE.szInitialClass != pWindow->m_szInitialClass)
+        return false;
+    if ((m_iUsedFields & RULE_FIELD_INITIALTITLE) && CACHE.szInitialTitle != pWindow->m_szInitialTitle)
+        return false;
+
+    return true;
+}
+
+const std::vector<size_t>& CWindowRuleMatcher::candidatesFor(PHLWINDOW pWindow) {
+    auto& cache = pWindow->m_sRuleMatchCache;
+
+    if (cacheValid(pWindow))
+        return cache.candidates;
+
+    cache.generation     = m_iGeneration;
+    cache.szClass        = (m_iUsedFields & RULE_FIELD_CLASS) ? pWindow->m_szClass : "";
+    cache.szTitle        = (m_iUsedFields & RULE_FIELD_TITLE) ? pWindow->m_szTitle : "";
+    cache.szInitialClass = (m_iUsedFields & RULE_FIELD_INITIALCLASS) ? pWindow->m_szInitialClass : "";
+    cache.szInitialTitle = (m_iUsedFields & RULE_FIELD_INITIALTITLE) ? pWindow->m_szInitialTitle : "";
+
+    m_index.collect(pWindow->m_szClass, cache.candidates);
+
+    std::erase_if(cache.candidates, [&](size_t idx) {
+        const auto& R = m_vRules[idx];
+        return !R.classPattern.matches(pWindow->m_szClass) || !R.titlePattern.matches(pWindow->m_szTitle) || !R.initialClassPattern.matches(pWindow->m_szInitialClass) ||
+            !R.initialTitlePattern.matches(pWindow->m_szInitialTitle);
+    });
+
+    return cache.candidates;
+}
+
+const SCompiledWindowRule& CWindowRuleMatcher::at(size_t idx) const {
+    return m_vRules.at(idx);
+}
+
+void CLayerRuleMatcher::rebuild(const std::deque<SLayerRule>& rules) {
+    m_vRules.clear();
+    m_vRules.reserve(rules.size());
+    m_index.clear();
+    m_vAddressRules.clear();
+    m_iGeneration++;
+
+    for (auto const& r : rules) {
+        SCompiledLayerRule compiled;
+        compiled.rule = r;
+
+        if (r.targetNamespace.starts_with("address:0x")) {
+            compiled.address = r.targetNamespace;
+            m_vAddressRules.push_back(m_vRules.size());
+            m_vRules.emplace_back(std::move(compiled));
+            continue;
+        }
+
+        compiled.namespacePattern = CRulePattern(r.targetNamespace);
+
+        if (!compiled.namespacePattern.valid())
+            continue;
+
+        m_index.add(m_vRules.size(), compiled.namespacePattern.exactLiteral());
+        m_vRules.emplace_back(std::move(compiled));
+    }
+}
+
+const std::vector<size_t>& CLayerRuleMatcher::candidatesFor(PHLLS pLS) {
+    auto&       cache     = pLS->ruleMatchCache;
+    const auto& NAMESPACE = pLS->layerSurface->layerNamespace;
+
+    if (cache.generation == m_iGeneration && cache.szNamespace == NAMESPACE)
+        return cache.candidates;
+
+    cache.generation  = m_iGeneration;
+    cache.szNamespace = NAMESPACE;
+
+    m_index.collect(NAMESPACE, cache.candidates);
+    std::erase_if(cache.candidates, [&](size_t idx) { return !m_vRules[idx].namespacePattern.matches(NAMESPACE); });
+
+    const auto ADDRESS = std::format("address:0x{:x}", (uintptr_t)pLS.get());
+    for (auto const& idx : m_vAddressRules) {
+        if (m_vRules[idx].address == ADDRESS)
+            cache.candidates.push_back(idx);
+    }
+
+    std::ranges::sort(cache.candidates);
+
+    return cache.candidates;
+}
+
+const SCompiledLayerRule& CLayerRuleMatcher::at(size_t idx) const {
+    return m_vRules.at(idx);
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <regex>
+#include <optional>
+#include <unordered_map>
+#include "../desktop/Window.hpp"
+#include "../desktop/LayerSurface.hpp"
+
+/*
+    A rule pattern (class, title, namespace...), compiled once when rules are loaded.
+    Plain literals never touch std::regex, and real regexes are prefiltered
+    by a literal substring every match has to contain.
+*/
+class CRulePattern {
+  public:
+    CRulePattern() = default;
+    CRulePattern(const std::string& pattern);
+
+    bool                       matches(const std::string& str) const;
+    bool                       valid() const;
+    bool                       empty() const;
+
+    // set if the pattern can only ever match one string, e.g. ^(kitty)$
+    std::optional<std::string> exactLiteral() const;
+
+  private:
+    enum ePatternKind : uint8_t {
+        PATTERN_EMPTY = 0,
+        PATTERN_EXACT,
+        PATTERN_SUBSTRING,
+        PATTERN_REGEX,
+        PATTERN_INVALID,
+    };
+
+    ePatternKind              m_eKind = PATTERN_EMPTY;
+    std::string               m_szLiteral; // for regexes: a substring any match must contain, can be empty
+    std::optional<std::regex> m_regex;
+};
+
+/*
+    Prefilter index over a rule list: rules with an exact key live in buckets,
+    everything else is a candidate for every lookup. Candidates are returned in rule order.
+*/
+class CRuleIndex {
+  public:
+    void clear();
+    void add(size_t idx, const std::optional<std::string>& exactKey);
+    void collect(const std::string& key, std::vector<size_t>& out) const;
+
+  private:
+    std::unordered_map<std::string, std::vector<size_t>> m_mExactBuckets;
+    std::vector<size_t>                                  m_vGeneric;
+};
+
+struct SCompiledWindowRule {
+    SWindowRule  rule;
+    std::string  tag;
+    CRulePattern classPattern, titlePattern, initialClassPattern, initialTitlePattern;
+};
+
+class CWindowRuleMatcher {
+  public:
+    void                       rebuild(const std::deque<SWindowRule>& rules);
+
+    // rules whose class / title patterns match the window, in config order.
+    // Cached per window, and only recomputed when a field any rule looks at changes.
+    const std::vector<size_t>& candidatesFor(PHLWINDOW pWindow);
+    const SCompiledWindowRule& at(size_t idx) const;
+
+  private:
+    enum eRuleFields : uint8_t {
+        RULE_FIELD_CLASS        = 1 << 0,
+        RULE_FIELD_TITLE        = 1 << 1,
+        RULE_FIELD_INITIALCLASS = 1 << 2,
+        RULE_FIELD_INITIALTITLE = 1 << 3,
+    };
+
+    bool                             cacheValid(PHLWINDOW pWindow) const;
+
+    std::vector<SCompiledWindowRule> m_vRules;
+    CRuleIndex                       m_index;
+    uint8_t                          m_iUsedFields = 0;
+    uint64_t                         m_iGeneration = 1;
+};
+
+struct SCompiledLayerRule {
+    SLayerRule   rule;
+    std::string  address; // for address:0x rules
+    CRulePattern namespacePattern;
+};
+
+class CLayerRuleMatcher {
+  public:
+    void                       rebuild(const std::deque<SLayerRule>& rules);
+
+    // rules that target the layer, in config order. Cached per layer.
+    const std::vector<size_t>& candidatesFor(PHLLS pLS);
+    const SCompiledLayerRule&  at(size_t idx) const;
+
+  private:
+    std::vector<SCompiledLayerRule> m_vRules;
+    CRuleIndex                      m_index;
+    std::vector<size_t>             m_vAddressRules;
+    uint64_t                        m_iGeneration = 1;
+};
@@ -0,0 +1,398 @@
+#include "Benchmark.hpp"
+#include "../Compositor.hpp"
+#include "../managers/KeybindManager.hpp"
+#include "../managers/input/InputManager.hpp"
+#include "../managers/eventLoop/EventLoopManager.hpp"
+#include "../render/OpenGL.hpp"
+#include "../render/Renderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <print>
+#include <sys/socket.h>
+#include <unistd.h>
+
+constexpr const char* BENCHMARK_OUTPUT = "BENCHMARK-1";
+constexpr const char* BENCHMARK_CLASS  = "hyprland-benchmark"; // every window class starts with it
+
+constexpr size_t      BENCHMARK_WARMUP_FRAMES  = 30; // shaders, buffers and caches settle first
+constexpr size_t      BENCHMARK_TILES          = 8;
+constexpr size_t      BENCHMARK_FLOATS         = 4;
+constexpr int         BENCHMARK_FLOAT_WIDTH    = 480;
+constexpr int         BENCHMARK_FLOAT_HEIGHT   = 320;
+constexpr int         BENCHMARK_TILE_WIDTH     = 640; // until the layout sizes them
+constexpr int         BENCHMARK_TILE_HEIGHT    = 480;
+constexpr size_t      BENCHMARK_FLOAT_FRAMES   = 240; // a full circle
+constexpr size_t      BENCHMARK_SWIPE_FRAMES   = 120; // there and back
+constexpr int         BENCHMARK_SWIPE_DISTANCE = 300;
+constexpr int         BENCHMARK_SWIPE_FINGERS  = 3;
+
+// as given to --benchmark
+static const char* scenarioName(eBenchmarkScenario scenario) {
+    switch (scenario) {
+        case BENCHMARK_TILED: return "tiled";
+        case BENCHMARK_FLOATS: return "floats";
+        case BENCHMARK_SWIPE: return "swipe";
+        case BENCHMARK_SCROLL: return "scroll";
+    }
+
+    return "unknown";
+}
+
+static std::string histogramJSON(const CTimeHistogram& histogram) {
+    return std::format(R"#({{"p50": {:.3f}, "p95": {:.3f}, "p99": {:.3f}, "max": {:.3f}}})#", histogram.percentile(0.5F), histogram.percentile(0.95F), histogram.percentile(0.99F),
+                       histogram.max());
+}
+
+static int onClientFD(int fd, uint32_t mask, void* data) {
+    g_pBenchmark->onClientEvent(mask);
+    return 0;
+}
+
+CBenchmark::CBenchmark(const std::vector<eBenchmarkScenario>& scenarios, size_t frames) : m_vScenarios(scenarios), m_iFrames(frames) {
+    ;
+}
+
+CBenchmark::~CBenchmark() {
+    if (!m_szConfigPath.empty())
+        unlink(m_szConfigPath.c_str());
+}
+
+std::optional<std::vector<eBenchmarkScenario>> CBenchmark::parseScenarios(const std::string& name) {
+    if (name == "all")
+        return std::vector<eBenchmarkScenario>{BENCHMARK_TILED, BENCHMARK_FLOATS, BENCHMARK_SWIPE, BENCHMARK_SCROLL};
+
+    for (auto const& s : {BENCHMARK_TILED, BENCHMARK_FLOATS, BENCHMARK_SWIPE, BENCHMARK_SCROLL}) {
+        if (name == scenarioName(s))
+            return std::vector<eBenchmarkScenario>{s};
+    }
+
+    return std::nullopt;
+}
+
+std::string CBenchmark::writeConfig() {
+    // nothing from the user's config, so results compare across machines. No splash either, it's random.
+    const auto CONFIG = std::format(R"#(# written by Hyprland --benchmark
+monitor = {0}, 1920x1080@60, 0x0, 1
+
+general:gaps_in = 5
+general:gaps_out = 10
+general:border_size = 2
+general:layout = dwindle
+decoration:rounding = 10
+decoration:blur:enabled = true
+decoration:blur:size = 8
+decoration:blur:passes = 2
+animations:enabled = false
+gestures:workspace_swipe = true
+gestures:workspace_swipe_fingers = {1}
+gestures:workspace_swipe_distance = {2}
+gestures:workspace_swipe_invert = false
+misc:disable_hyprland_logo = true
+misc:disable_splash_rendering = true
+debug:enable_stdout_logs = false
+debug:damage_tracking = 2
+
+windowrulev2 = float, class:^({3}-float-\d)$
+windowrulev2 = size {4} {5}, class:^({3}-float-\d)$
+windowrulev2 = workspace 2 silent, class:^({3}-next)$
+windowrulev2 = fullscreen, class:^({3}-scroll)$
+)#",
+                                    BENCHMARK_OUTPUT, BENCHMARK_SWIPE_FINGERS, BENCHMARK_SWIPE_DISTANCE, BENCHMARK_CLASS, BENCHMARK_FLOAT_WIDTH, BENCHMARK_FLOAT_HEIGHT);
+
+    const auto  RUNTIMEDIR = getenv("XDG_RUNTIME_DIR");
+    std::string path       = std::format("{}/hyprland-benchmark-XXXXXX.conf", RUNTIMEDIR ? RUNTIMEDIR : "/tmp");
+
+    const int   FD = mkstemps(path.data(), 5);
+    if (FD < 0)
+        return "";
+
+    const bool WRITTEN = write(FD, CONFIG.data(), CONFIG.size()) == (ssize_t)CONFIG.size();
+    close(FD);
+
+    if (!WRITTEN) {
+        unlink(path.c_str());
+        return "";
+    }
+
+    m_szConfigPath = path;
+    return path;
+}
+
+void CBenchmark::start() {
+    m_pMonitorAddedHook = g_pHookSystem->hookDynamic("monitorAdded", [this](void* self, SCallbackInfo& info, std::any param) {
+        const auto PMONITOR = std::any_cast<PHLMONITOR>(param);
+        if (PMONITOR->szName != BENCHMARK_OUTPUT)
+            return;
+
+        Debug::log(LOG, "Benchmark: running {} scenario(s) of {} frames on {}", m_vScenarios.size(), m_iFrames, PMONITOR->szName);
+
+        m_pMonitor = PMONITOR;
+
+        // once the monitor has its workspace
+        g_pEventLoopManager->doLater([this] { beginScenario(); });
+    });
+
+    m_pRenderHook = g_pHookSystem->hookDynamic("render", [this](void* self, SCallbackInfo& info, std::any param) { onRender(std::any_cast<eRenderStage>(param)); });
+
+    for (auto const& impl : g_pCompositor->m_pAqBackend->getImplementations()) {
+        if (impl->type() != Aquamarine::AQ_BACKEND_HEADLESS)
+            continue;
+
+        impl->createOutput(BENCHMARK_OUTPUT);
+        return;
+    }
+
+    fail("no headless backend");
+}
+
+void CBenchmark::onRender(eRenderStage stage) {
+    const auto PMONITOR = m_pMonitor.lock();
+
+    if (!PMONITOR || !m_pClient || g_pHyprRenderer->m_eRenderMode != RENDER_MODE_NORMAL || g_pHyprOpenGL->m_RenderData.pMonitor != PMONITOR)
+        return;
+
+    switch (stage) {
+        case RENDER_BEGIN: {
+            if (!m_bReady) {
+                if (mappedWindows() < m_iWindows)
+                    return;
+
+                m_bReady = true;
+                m_iFrame = 0;
+            }
+
+            if (m_iFrame == BENCHMARK_WARMUP_FRAMES) {
+                PMONITOR->frameTimes.reset();
+                m_sStatsStart.drawCalls     = g_pHyprOpenGL->m_sStats.drawCalls;
+                m_sStatsStart.textureAllocs = g_pHyprOpenGL->m_sStats.textureAllocs;
+                m_sStatsStart.fbAllocs      = g_pHyprOpenGL->m_sStats.fbAllocs;
+            }
+            break;
+        }
+        case RENDER_LAST_MOMENT: {
+            if (!m_bReady)
+                break;
+
+            m_iFrame++;
+
+            // what the next frame shows, moved like input would be, outside of rendering
+            g_pEventLoopManager->doLater([this] { stepScenario(); });
+            break;
+        }
+        default: break;
+    }
+}
+
+void CBenchmark::onClientEvent(uint32_t mask) {
+    if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR)) {
+        // only the compositor closes the other end, when it kills the client
+        m_pServerClient = nullptr;
+        fail("the compositor disconnected the benchmark client, see the log");
+        return;
+    }
+
+    if ((mask & WL_EVENT_READABLE) && !m_pClient->dispatch()) {
+        fail("the benchmark client lost its connection");
+        return;
+    }
+
+    if ((mask & WL_EVENT_WRITABLE) && !m_pClient->flush()) {
+        fail("the benchmark client lost its connection");
+        return;
+    }
+
+    updateClientSource();
+}
+
+void CBenchmark::updateClientSource() {
+    if (!m_pClient || !m_pClientSource)
+        return;
+
+    // the client's requests only go out when the socket has room, the compositor reading them drains it
+    wl_event_source_fd_update(m_pClientSource, WL_EVENT_READABLE | (m_pClient->flushPending() ? WL_EVENT_WRITABLE : 0));
+}
+
+void CBenchmark::beginScenario() {
+    const auto PMONITOR = m_pMonitor.lock();
+    if (!PMONITOR || m_iScenario >= m_vScenarios.size())
+        return;
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        fail("couldn't create a socketpair for the client");
+        return;
+    }
+
+    m_pServerClient = wl_client_create(g_pCompositor->m_sWLDisplay, fds[0]);
+    if (!m_pServerClient) {
+        close(fds[0]);
+        close(fds[1]);
+        fail("couldn't create the client");
+        return;
+    }
+
+    m_pClient = std::make_unique<CBenchmarkClient>(fds[1]);
+    if (m_pClient->fd() < 0) {
+        fail("the client couldn't connect");
+        return;
+    }
+
+    m_pClientSource = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, m_pClient->fd(), WL_EVENT_READABLE, onClientFD, nullptr);
+
+    const auto SCENARIO = m_vScenarios[m_iScenario];
+
+    if (SCENARIO == BENCHMARK_SCROLL) {
+        m_pClient->addToplevel(std::format("{}-scroll", BENCHMARK_CLASS), BENCHMARK_CONTENT_SCROLL, PMONITOR->vecPixelSize.x, PMONITOR->vecPixelSize.y, false, 0);
+        m_iWindows = 1;
+    } else {
+        for (size_t i = 0; i < BENCHMARK_TILES; ++i) {
+            m_pClient->addToplevel(std::format("{}-tile", BENCHMARK_CLASS), BENCHMARK_CONTENT_LINES, BENCHMARK_TILE_WIDTH, BENCHMARK_TILE_HEIGHT, false, i);
+        }
+
+        m_iWindows = BENCHMARK_TILES;
+
+        // the workspace swiped to, see the workspace rule in writeConfig
+        if (SCENARIO == BENCHMARK_SWIPE) {
+            for (size_t i = 0; i < BENCHMARK_TILES; ++i) {
+                m_pClient->addToplevel(std::format("{}-next", BENCHMARK_CLASS), BENCHMARK_CONTENT_LINES, BENCHMARK_TILE_WIDTH, BENCHMARK_TILE_HEIGHT, false, BENCHMARK_TILES + i);
+            }
+
+            m_iWindows += BENCHMARK_TILES;
+        } else if (SCENARIO == BENCHMARK_FLOATS) {
+            for (size_t i = 0; i < BENCHMARK_FLOATS; ++i) {
+                m_pClient->addToplevel(std::format("{}-float-{}", BENCHMARK_CLASS, i), BENCHMARK_CONTENT_STATIC, BENCHMARK_FLOAT_WIDTH, BENCHMARK_FLOAT_HEIGHT, true,
+                                       BENCHMARK_TILES * 2 + i);
+            }
+
+            m_iWindows += BENCHMARK_FLOATS;
+        }
+    }
+
+    m_iFrame = 0;
+    m_bReady = false;
+
+    m_pClient->flush();
+    updateClientSource();
+    g_pHyprRenderer->damageMonitor(PMONITOR);
+}
+
+void CBenchmark::endScenario() {
+    const auto  PMONITOR = m_pMonitor.lock();
+    const auto& STATS    = g_pHyprOpenGL->m_sStats;
+
+    m_vResults.emplace_back(std::format(R"#({{
+    "scenario": "{}",
+    "output": "{}x{}",
+    "frames": {},
+    "cpu": {},
+    "gpu": {},
+    "interval": {},
+    "missedVblanks": {},
+    "drawCallsPerFrame": {:.1f},
+    "textureAllocs": {},
+    "framebufferAllocs": {}
+}})#",
+                                        scenarioName(m_vScenarios[m_iScenario]), PMONITOR->vecPixelSize.x, PMONITOR->vecPixelSize.y, m_iFrames,
+                                        histogramJSON(PMONITOR->frameTimes.render), histogramJSON(PMONITOR->frameTimes.gpu), histogramJSON(PMONITOR->frameTimes.interval),
+                                        PMONITOR->frameTimes.missedVblanks.load(), (double)(STATS.drawCalls - m_sStatsStart.drawCalls) / m_iFrames,
+                                        STATS.textureAllocs - m_sStatsStart.textureAllocs, STATS.fbAllocs - m_sStatsStart.fbAllocs));
+
+    destroyClient();
+
+    m_iScenario++;
+
+    if (m_iScenario < m_vScenarios.size())
+        return;
+
+    std::string results = "";
+    for (auto const& r : m_vResults) {
+        results += r + ",\n";
+    }
+
+    results.pop_back();
+    results.pop_back();
+
+    // stdout logs are off in benchmark mode, this is all that goes there
+    std::println("[\n{}\n]", results);
+
+    g_pCompositor->stopCompositor();
+}
+
+void CBenchmark::stepScenario() {
+    const auto PMONITOR = m_pMonitor.lock();
+    if (!PMONITOR || !m_pClient || !m_bReady)
+        return;
+
+    if (m_iFrame >= BENCHMARK_WARMUP_FRAMES + m_iFrames) {
+        endScenario();
+        beginScenario();
+        return;
+    }
+
+    switch (m_vScenarios[m_iScenario]) {
+        case BENCHMARK_FLOATS: {
+            // circling around the middle of the monitor
+            for (size_t i = 0; i < BENCHMARK_FLOATS; ++i) {
+                const double ANGLE  = 2 * M_PI * ((double)(m_iFrame % BENCHMARK_FLOAT_FRAMES) / BENCHMARK_FLOAT_FRAMES + (double)i / BENCHMARK_FLOATS);
+                const auto   CENTER = PMONITOR->vecPosition + PMONITOR->vecSize / 2.0 + Vector2D{std::cos(ANGLE) * PMONITOR->vecSize.x / 4.0, std::sin(ANGLE) * PMONITOR->vecSize.y / 4.0};
+                const auto   POS    = (CENTER - Vector2D{BENCHMARK_FLOAT_WIDTH, BENCHMARK_FLOAT_HEIGHT} / 2.0).round();
+
+                g_pKeybindManager->m_mDispatchers["movewindowpixel"](std::format("exact {} {},class:^({}-float-{})$", (int)POS.x, (int)POS.y, BENCHMARK_CLASS, i));
+            }
+            break;
+        }
+        case BENCHMARK_SWIPE: {
+            if (!m_bSwiping) {
+                g_pInputManager->onSwipeBegin({.fingers = BENCHMARK_SWIPE_FINGERS});
+                m_bSwiping = true;
+            }
+
+            // over the whole swipe distance and back
+            const double STEP    = 2.0 * BENCHMARK_SWIPE_DISTANCE / BENCHMARK_SWIPE_FRAMES;
+            const bool   FORWARD = (m_iFrame - 1) % BENCHMARK_SWIPE_FRAMES < BENCHMARK_SWIPE_FRAMES / 2;
+
+            g_pInputManager->onSwipeUpdate({.fingers = BENCHMARK_SWIPE_FINGERS, .delta = {FORWARD ? STEP : -STEP, 0.0}});
+            break;
+        }
+        default: break;
+    }
+}
+
+void CBenchmark::destroyClient() {
+    if (m_bSwiping) {
+        g_pInputManager->onSwipeEnd({.cancelled = true});
+        m_bSwiping = false;
+
+        // wherever the swipe ended, the next scenario starts on the first workspace again
+        g_pKeybindManager->m_mDispatchers["workspace"]("1");
+    }
+
+    if (m_pClientSource) {
+        wl_event_source_remove(m_pClientSource);
+        m_pClientSource = nullptr;
+    }
+
+    // the client end first, the compositor's end then takes its windows with it right away
+    m_pClient.reset();
+
+    if (m_pServerClient) {
+        wl_client_destroy(m_pServerClient);
+        m_pServerClient = nullptr;
+    }
+
+    m_bReady = false;
+}
+
+void CBenchmark::fail(const std::string& reason) {
+    Debug::log(CRIT, "Benchmark: {}", reason);
+    std::println(stderr, "[ ERROR ] Benchmark failed: {}", reason);
+
+    destroyClient();
+    m_iScenario = m_vScenarios.size();
+
+    g_pCompositor->stopCompositor();
+}
+
+size_t CBenchmark::mappedWindows() const {
+    return std::ranges::count_if(g_pCompositor->m_vWindows, [](const auto& w) { return w->m_bIsMapped && w->m_szInitialClass.starts_with(BENCHMARK_CLASS); });
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../defines.hpp"
+#include "../helpers/Monitor.hpp"
+#include "../managers/HookSystemManager.hpp"
+#include "BenchmarkClient.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+enum eBenchmarkScenario : uint8_t {
+    BENCHMARK_TILED = 0, // terminal-like tiles printing a line every frame
+    BENCHMARK_FLOATS,    // the tiles, with translucent blurred floats moving over them
+    BENCHMARK_SWIPE,     // a workspace swipe back and forth between two workspaces of tiles
+    BENCHMARK_SCROLL,    // a fullscreen window scrolling, all of it changing every frame
+};
+
+/*
+    Hyprland --benchmark: runs each scenario on a headless output for a fixed number of frames,
+    then prints frame times, draw calls and allocations as JSON and exits.
+    The windows belong to a wayland client inside the compositor (see CBenchmarkClient), so their buffers go through
+    the same commit and render path as anyone's. Floats and swipes move per frame instead of with the clock,
+    and the config is a fixed one (see writeConfig), so every run renders the same frames.
+*/
+class CBenchmark {
+  public:
+    CBenchmark(const std::vector<eBenchmarkScenario>& scenarios, size_t frames);
+    ~CBenchmark();
+
+    // "tiled", "floats", "swipe", "scroll" or "all"
+    static std::optional<std::vector<eBenchmarkScenario>> parseScenarios(const std::string& name);
+
+    // the config the benchmark runs with, in a temporary file. Empty if it couldn't be written.
+    std::string writeConfig();
+
+    // once the backend runs: creates the output
+    void start();
+
+    void onClientEvent(uint32_t mask);
+
+  private:
+    void                              onRender(eRenderStage stage);
+    void                              beginScenario();
+    void                              endScenario(); // prints the results and stops after the last one
+    void                              stepScenario();
+    void                              destroyClient();
+    void                              updateClientSource(); // listens for writable too while the client has requests it couldn't send
+    void                              fail(const std::string& reason);
+    size_t                            mappedWindows() const;
+
+    std::vector<eBenchmarkScenario>   m_vScenarios;
+    size_t                            m_iScenario = 0;
+    size_t                            m_iFrames   = 0;
+    size_t                            m_iFrame    = 0; // in the current scenario since all its windows mapped, warmup included
+    PHLMONITORREF                     m_pMonitor;
+    std::string                       m_szConfigPath;
+
+    std::unique_ptr<CBenchmarkClient> m_pClient;
+    wl_client*                        m_pServerClient = nullptr; // the compositor's end of m_pClient
+    wl_event_source*                  m_pClientSource = nullptr;
+    size_t                            m_iWindows      = 0; // opened by the current scenario
+    bool                              m_bReady        = false;
+    bool                              m_bSwiping      = false;
+
+    // counters when measuring started, see CHyprOpenGLImpl::m_sStats
+    struct {
+        uint64_t drawCalls     = 0;
+        uint64_t textureAllocs = 0;
+        uint64_t fbAllocs      = 0;
+    } m_sStatsStart;
+
+    std::vector<std::string> m_vResults; // a JSON object per scenario
+
+    SP<HOOK_CALLBACK_FN>     m_pMonitorAddedHook;
+    SP<HOOK_CALLBACK_FN>     m_pRenderHook;
+};
+
+inline std::unique_ptr<CBenchmark> g_pBenchmark;
@@ -0,0 +1,451 @@
+#include "BenchmarkClient.hpp"
+#include "Log.hpp"
+#include <wayland-client.h>
+// only declares the requests, the xdg_*_interface tables are the ones generated for the compositor's side
+#include "xdg-shell-client-protocol.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+
+constexpr int    BENCHMARK_LINE_HEIGHT     = 16;
+constexpr int    BENCHMARK_SCROLL_SPEED    = 8; // rows per frame
+constexpr size_t BENCHMARK_SEED_MULTIPLIER = 31;
+constexpr size_t BENCHMARK_BUFFERS         = 3; // the compositor may hold on to two
+constexpr int    BENCHMARK_FORMAT_BYTES    = 4;
+
+struct SBenchmarkBuffer {
+    SBenchmarkToplevel*              toplevel = nullptr;
+    wl_buffer*                       buffer   = nullptr;
+    uint32_t*                        pixels   = nullptr;
+    bool                             busy     = false;
+    std::vector<std::pair<int, int>> stale; // rows drawn since this buffer was last copied into
+};
+
+struct SBenchmarkToplevel {
+    CBenchmarkClient* client = nullptr;
+    std::string       appID;
+    eBenchmarkContent content     = BENCHMARK_CONTENT_STATIC;
+    bool              translucent = false;
+    size_t            seed        = 0;
+    size_t            frame       = 0;
+
+    wl_surface*       surface       = nullptr;
+    xdg_surface*      xdgSurface    = nullptr;
+    xdg_toplevel*     xdgToplevel   = nullptr;
+    wl_callback*      frameCallback = nullptr;
+
+    int               defaultWidth     = 0;
+    int               defaultHeight    = 0;
+    int               configuredWidth  = 0; // 0 leaves it to the client
+    int               configuredHeight = 0;
+    int               width            = 0; // of the buffers
+    int               height           = 0;
+    bool              waitingForBuffer = false;
+
+    // drawn into first, and copied into buffers as they're used
+    std::vector<uint32_t>                           canvas;
+    std::vector<std::pair<int, int>>                damage; // rows since the last commit
+
+    int                                             poolFD   = -1;
+    void*                                           poolData = nullptr;
+    size_t                                          poolSize = 0;
+    wl_shm_pool*                                    pool     = nullptr;
+    std::array<SBenchmarkBuffer, BENCHMARK_BUFFERS> buffers;
+};
+
+// the same pixels every run, premultiplied like wl_shm wants
+static uint32_t patternPixel(size_t x, size_t y, size_t seed, bool translucent) {
+    uint32_t h = (x * 73856093U) ^ (y * 19349663U) ^ (seed * 83492791U);
+    h ^= h >> 13;
+    h *= 0x5bd1e995U;
+    h ^= h >> 15;
+
+    if (!translucent)
+        return 0xFF000000 | (h & 0x00FFFFFF);
+
+    constexpr uint32_t ALPHA = 0xCC;
+
+    const uint32_t     R = ((h >> 16) & 0xFF) * ALPHA / 0xFF;
+    const uint32_t     G = ((h >> 8) & 0xFF) * ALPHA / 0xFF;
+    const uint32_t     B = (h & 0xFF) * ALPHA / 0xFF;
+
+    return (ALPHA << 24) | (R << 16) | (G << 8) | B;
+}
+
+static void fillRows(SBenchmarkToplevel* toplevel, int from, int to, size_t seed) {
+    for (int y = from; y < to; ++y) {
+        for (int x = 0; x < toplevel->width; ++x) {
+            toplevel->canvas[(size_t)y * toplevel->width + x] = patternPixel(x, y, seed, toplevel->translucent);
+        }
+    }
+
+    toplevel->damage.emplace_back(from, to);
+    for (auto& b : toplevel->buffers) {
+        b.stale.emplace_back(from, to);
+    }
+}
+
+static void handleGlobal(void* data, wl_registry* registry, uint32_t name, const char* interface, uint32_t version) {
+    ((CBenchmarkClient*)data)->onGlobal(name, interface);
+}
+
+static void handleGlobalRemove(void* data, wl_registry* registry, uint32_t name) {
+    ;
+}
+
+static const wl_registry_listener registryListener = {
+    .global        = handleGlobal,
+    .global_remove = handleGlobalRemove,
+};
+
+static const xdg_wm_base_listener wmBaseListener = {
+    .ping = [](void* data, xdg_wm_base* wmBase, uint32_t serial) { xdg_wm_base_pong(wmBase, serial); },
+};
+
+static const xdg_surface_listener xdgSurfaceListener = {
+    .configure =
+        [](void* data, xdg_surface* xdgSurface, uint32_t serial) {
+            const auto TOPLEVEL = (SBenchmarkToplevel*)data;
+            xdg_surface_ack_configure(xdgSurface, serial);
+            TOPLEVEL->client->onConfigure(TOPLEVEL);
+        },
+};
+
+// bound at v1, the events added later never come
+static const xdg_toplevel_listener toplevelListener = {
+    .configure =
+        [](void* data, xdg_toplevel* toplevel, int32_t width, int32_t height, wl_array* states) {
+            const auto TOPLEVEL        = (SBenchmarkToplevel*)data;
+            TOPLEVEL->configuredWidth  = width;
+            TOPLEVEL->configuredHeight = height;
+        },
+    .close = [](void* data, xdg_toplevel* toplevel) { ; },
+};
+
+static const wl_callback_listener frameListener = {
+    .done =
+        [](void* data, wl_callback* callback, uint32_t time) {
+            const auto TOPLEVEL = (SBenchmarkToplevel*)data;
+            wl_callback_destroy(callback);
+            TOPLEVEL->frameCallback = nullptr;
+            TOPLEVEL->client->onFrame(TOPLEVEL);
+        },
+};
+
+static const wl_buffer_listener bufferListener = {
+    .release =
+        [](void* data, wl_buffer* buffer) {
+            const auto BUFFER = (SBenchmarkBuffer*)data;
+            BUFFER->busy      = false;
+            BUFFER->toplevel->client->onRelease(BUFFER->toplevel);
+        },
+};
+
+CBenchmarkClient::CBenchmarkClient(int fd) {
+    m_pDisplay = wl_display_connect_to_fd(fd);
+
+    if (!m_pDisplay) {
+        Debug::log(ERR, "Benchmark: client couldn't connect");
+        return;
+    }
+
+    m_pRegistry = wl_display_get_registry(m_pDisplay);
+    wl_registry_add_listener(m_pRegistry, &registryListener, this);
+    flush();
+}
+
+CBenchmarkClient::~CBenchmarkClient() {
+    if (!m_pDisplay)
+        return;
+
+    for (auto const& t : m_vToplevels) {
+        destroyToplevel(t.get());
+    }
+
+    if (m_pWmBase)
+        xdg_wm_base_destroy(m_pWmBase);
+    if (m_pShm)
+        wl_shm_destroy(m_pShm);
+    if (m_pCompositor)
+        wl_compositor_destroy(m_pCompositor);
+
+    wl_registry_destroy(m_pRegistry);
+    wl_display_disconnect(m_pDisplay);
+}
+
+int CBenchmarkClient::fd() {
+    return m_pDisplay ? wl_display_get_fd(m_pDisplay) : -1;
+}
+
+bool CBenchmarkClient::dispatch() {
+    if (!m_pDisplay)
+        return false;
+
+    // not wl_display_dispatch, that flushes first and waits for the socket to drain, which only this thread can do
+    while (wl_display_prepare_read(m_pDisplay) != 0) {
+        if (wl_display_dispatch_pending(m_pDisplay) < 0) {
+            Debug::log(ERR, "Benchmark: client lost its connection");
+            return false;
+        }
+    }
+
+    if ((wl_display_read_events(m_pDisplay) < 0 && errno != EAGAIN) || wl_display_dispatch_pending(m_pDisplay) < 0) {
+        Debug::log(ERR, "Benchmark: client lost its connection");
+        return false;
+    }
+
+    return flush();
+}
+
+bool CBenchmarkClient::flush() {
+    if (!m_pDisplay)
+        return false;
+
+    if (wl_display_flush(m_pDisplay) >= 0) {
+        m_bFlushPending = false;
+        return true;
+    }
+
+    if (errno != EAGAIN) {
+        Debug::log(ERR, "Benchmark: client couldn't flush");
+        return false;
+    }
+
+    // the compositor reads it on the same thread, so never wait for it to. The rest goes once the socket is writable.
+    m_bFlushPending = true;
+    return true;
+}
+
+bool CBenchmarkClient::flushPending() const {
+    return m_bFlushPending;
+}
+
+void CBenchmarkClient::onGlobal(uint32_t name, const char* interface) {
+    const std::string IFACE = interface;
+
+    if (IFACE == wl_compositor_interface.name)
+        m_pCompositor = (wl_compositor*)wl_registry_bind(m_pRegistry, name, &wl_compositor_interface, 4);
+    else if (IFACE == wl_shm_interface.name)
+        m_pShm = (wl_shm*)wl_registry_bind(m_pRegistry, name, &wl_shm_interface, 1);
+    else if (IFACE == xdg_wm_base_interface.name) {
+        m_pWmBase = (xdg_wm_base*)wl_registry_bind(m_pRegistry, name, &xdg_wm_base_interface, 1);
+        xdg_wm_base_add_listener(m_pWmBase, &wmBaseListener, this);
+    } else
+        return;
+
+    if (!m_pCompositor || !m_pShm || !m_pWmBase)
+        return;
+
+    for (auto const& t : m_vToplevels) {
+        if (!t->surface)
+            createToplevel(t.get());
+    }
+}
+
+void CBenchmarkClient::addToplevel(const std::string& appID, eBenchmarkContent content, int width, int height, bool translucent, size_t seed) {
+    auto& toplevel          = m_vToplevels.emplace_back(std::make_unique<SBenchmarkToplevel>());
+    toplevel->client        = this;
+    toplevel->appID         = appID;
+    toplevel->content       = content;
+    toplevel->translucent   = translucent;
+    toplevel->seed          = seed;
+    toplevel->defaultWidth  = width;
+    toplevel->defaultHeight = height;
+
+    if (m_pCompositor && m_pShm && m_pWmBase)
+        createToplevel(toplevel.get());
+}
+
+void CBenchmarkClient::createToplevel(SBenchmarkToplevel* toplevel) {
+    toplevel->surface    = wl_compositor_create_surface(m_pCompositor);
+    toplevel->xdgSurface = xdg_wm_base_get_xdg_surface(m_pWmBase, toplevel->surface);
+    xdg_surface_add_listener(toplevel->xdgSurface, &xdgSurfaceListener, toplevel);
+
+    toplevel->xdgToplevel = xdg_surface_get_toplevel(toplevel->xdgSurface);
+    xdg_toplevel_add_listener(toplevel->xdgToplevel, &toplevelListener, toplevel);
+
+    xdg_toplevel_set_app_id(toplevel->xdgToplevel, toplevel->appID.c_str());
+    xdg_toplevel_set_title(toplevel->xdgToplevel, toplevel->appID.c_str());
+
+    // no buffer, asks for the first configure
+    wl_surface_commit(toplevel->surface);
+
+    // keeps libwayland's own buffer from filling up, it would wait for the compositor otherwise
+    flush();
+}
+
+void CBenchmarkClient::destroyToplevel(SBenchmarkToplevel* toplevel) {
+    if (!toplevel->surface)
+        return;
+
+    if (toplevel->frameCallback)
+        wl_callback_destroy(toplevel->frameCallback);
+
+    destroyBuffers(toplevel);
+
+    xdg_toplevel_destroy(toplevel->xdgToplevel);
+    xdg_surface_destroy(toplevel->xdgSurface);
+    wl_surface_destroy(toplevel->surface);
+
+    toplevel->frameCallback = nullptr;
+    toplevel->xdgToplevel   = nullptr;
+    toplevel->xdgSurface    = nullptr;
+    toplevel->surface       = nullptr;
+}
+
+bool CBenchmarkClient::allocateBuffers(SBenchmarkToplevel* toplevel, int width, int height) {
+    destroyBuffers(toplevel);
+
+    const size_t STRIDE = (size_t)width * BENCHMARK_FORMAT_BYTES;
+    const size_t SIZE   = STRIDE * height;
+
+    toplevel->poolSize = SIZE * BENCHMARK_BUFFERS;
+    toplevel->poolFD   = memfd_create("hyprland-benchmark", MFD_CLOEXEC);
+
+    if (toplevel->poolFD < 0 || ftruncate(toplevel->poolFD, toplevel->poolSize) < 0) {
+        Debug::log(ERR, "Benchmark: couldn't allocate a {}x{} shm pool for {}", width, height, toplevel->appID);
+        return false;
+    }
+
+    toplevel->poolData = mmap(nullptr, toplevel->poolSize, PROT_READ | PROT_WRITE, MAP_SHARED, toplevel->poolFD, 0);
+    if (toplevel->poolData == MAP_FAILED) {
+        toplevel->poolData = nullptr;
+        Debug::log(ERR, "Benchmark: couldn't map the shm pool for {}", toplevel->appID);
+        return false;
+    }
+
+    toplevel->pool   = wl_shm_create_pool(m_pShm, toplevel->poolFD, toplevel->poolSize);
+    toplevel->width  = width;
+    toplevel->height = height;
+
+    const auto FORMAT = toplevel->translucent ? WL_SHM_FORMAT_ARGB8888 : WL_SHM_FORMAT_XRGB8888;
+
+    for (size_t i = 0; i < BENCHMARK_BUFFERS; ++i) {
+        auto& b    = toplevel->buffers[i];
+        b.toplevel = toplevel;
+        b.buffer   = wl_shm_pool_create_buffer(toplevel->pool, SIZE * i, width, height, STRIDE, FORMAT);
+        b.pixels   = (uint32_t*)((uint8_t*)toplevel->poolData + SIZE * i);
+        b.busy     = false;
+        b.stale.clear();
+        wl_buffer_add_listener(b.buffer, &bufferListener, &b);
+    }
+
+    toplevel->canvas.resize((size_t)width * height);
+    toplevel->damage.clear();
+    fillRows(toplevel, 0, height, toplevel->seed);
+
+    return true;
+}
+
+void CBenchmarkClient::destroyBuffers(SBenchmarkToplevel* toplevel) {
+    for (auto& b : toplevel->buffers) {
+        if (b.buffer)
+            wl_buffer_destroy(b.buffer);
+
+        b = {};
+    }
+
+    if (toplevel->pool)
+        wl_shm_pool_destroy(toplevel->pool);
+    if (toplevel->poolData)
+        munmap(toplevel->poolData, toplevel->poolSize);
+    if (toplevel->poolFD >= 0)
+        close(toplevel->poolFD);
+
+    toplevel->pool     = nullptr;
+    toplevel->poolData = nullptr;
+    toplevel->poolFD   = -1;
+    toplevel->width    = 0;
+    toplevel->height   = 0;
+}
+
+void CBenchmarkClient::onConfigure(SBenchmarkToplevel* toplevel) {
+    const int WIDTH  = toplevel->configuredWidth > 0 ? toplevel->configuredWidth : toplevel->defaultWidth;
+    const int HEIGHT = toplevel->configuredHeight > 0 ? toplevel->configuredHeight : toplevel->defaultHeight;
+
+    if (WIDTH == toplevel->width && HEIGHT == toplevel->height)
+        return;
+
+    if (!allocateBuffers(toplevel, WIDTH, HEIGHT))
+        return;
+
+    present(toplevel);
+}
+
+void CBenchmarkClient::onFrame(SBenchmarkToplevel* toplevel) {
+    toplevel->frame++;
+    draw(toplevel);
+    present(toplevel);
+}
+
+void CBenchmarkClient::onRelease(SBenchmarkToplevel* toplevel) {
+    if (!toplevel->waitingForBuffer)
+        return;
+
+    toplevel->waitingForBuffer = false;
+    present(toplevel);
+}
+
+void CBenchmarkClient::draw(SBenchmarkToplevel* toplevel) {
+    const int    W    = toplevel->width, H = toplevel->height;
+    const size_t SEED = toplevel->frame * BENCHMARK_SEED_MULTIPLIER + toplevel->seed;
+
+    switch (toplevel->content) {
+        case BENCHMARK_CONTENT_LINES: {
+            const int LINES = std::max(H / BENCHMARK_LINE_HEIGHT, 1);
+            const int Y     = ((toplevel->frame + toplevel->seed * 3) % LINES) * BENCHMARK_LINE_HEIGHT;
+            fillRows(toplevel, Y, std::min(Y + BENCHMARK_LINE_HEIGHT, H), SEED);
+            break;
+        }
+        case BENCHMARK_CONTENT_SCROLL: {
+            const int SPEED = std::min(BENCHMARK_SCROLL_SPEED, H);
+            std::memmove(toplevel->canvas.data(), toplevel->canvas.data() + (size_t)SPEED * W, (size_t)(H - SPEED) * W * sizeof(uint32_t));
+            fillRows(toplevel, H - SPEED, H, SEED);
+
+            // the rows that moved up changed too
+            toplevel->damage.emplace_back(0, H);
+            for (auto& b : toplevel->buffers) {
+                b.stale.emplace_back(0, H);
+            }
+            break;
+        }
+        case BENCHMARK_CONTENT_STATIC: break;
+    }
+}
+
+void CBenchmarkClient::present(SBenchmarkToplevel* toplevel) {
+    const auto BUFFER = std::ranges::find_if(toplevel->buffers, [](const auto& b) { return !b.busy; });
+
+    if (BUFFER == toplevel->buffers.end()) {
+        toplevel->waitingForBuffer = true;
+        return;
+    }
+
+    const size_t STRIDE = (size_t)toplevel->width * BENCHMARK_FORMAT_BYTES;
+
+    for (auto const& [FROM, TO] : BUFFER->stale) {
+        std::memcpy((uint8_t*)BUFFER->pixels + STRIDE * FROM, (uint8_t*)toplevel->canvas.data() + STRIDE * FROM, STRIDE * (TO - FROM));
+    }
+
+    BUFFER->stale.clear();
+    BUFFER->busy = true;
+
+    wl_surface_attach(toplevel->surface, BUFFER->buffer, 0, 0);
+
+    for (auto const& [FROM, TO] : toplevel->damage) {
+        wl_surface_damage_buffer(toplevel->surface, 0, FROM, toplevel->width, TO - FROM);
+    }
+
+    toplevel->damage.clear();
+
+    if (toplevel->content != BENCHMARK_CONTENT_STATIC && !toplevel->frameCallback) {
+        toplevel->frameCallback = wl_surface_frame(toplevel->surface);
+        wl_callback_add_listener(toplevel->frameCallback, &frameListener, toplevel);
+    }
+
+    wl_surface_commit(toplevel->surface);
+    flush();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct wl_display;
+struct wl_registry;
+struct wl_compositor;
+struct wl_shm;
+struct xdg_wm_base;
+struct SBenchmarkToplevel;
+
+enum eBenchmarkContent : uint8_t {
+    BENCHMARK_CONTENT_STATIC = 0, // drawn once
+    BENCHMARK_CONTENT_LINES,      // a line changes every frame, like a terminal printing
+    BENCHMARK_CONTENT_SCROLL,     // scrolls a few rows every frame, all of it changes
+};
+
+/*
+    A wayland client living in the compositor process for --benchmark, connected over a socketpair.
+    Its toplevels draw into shm buffers on every frame callback, and go through the same
+    map / commit / render path as any other client's.
+    It never blocks: the compositor's event loop calls dispatch() when fd() is readable, and flush() when it's writable after flushPending().
+*/
+class CBenchmarkClient {
+  public:
+    CBenchmarkClient(int fd);
+    ~CBenchmarkClient();
+
+    // app id is what window rules see as the class. width and height are used until the compositor configures a size.
+    void addToplevel(const std::string& appID, eBenchmarkContent content, int width, int height, bool translucent, size_t seed);
+
+    int  fd();
+    bool dispatch();           // false once the connection is gone
+    bool flush();              // false once the connection is gone
+    bool flushPending() const; // the socket was full, flush() again once it's writable
+
+    // for the listeners
+    void onGlobal(uint32_t name, const char* interface);
+    void onConfigure(SBenchmarkToplevel* toplevel);
+    void onFrame(SBenchmarkToplevel* toplevel);
+    void onRelease(SBenchmarkToplevel* toplevel);
+
+  private:
+    void                                             createToplevel(SBenchmarkToplevel* toplevel);
+    void                                             destroyToplevel(SBenchmarkToplevel* toplevel);
+    bool                                             allocateBuffers(SBenchmarkToplevel* toplevel, int width, int height);
+    void                                             destroyBuffers(SBenchmarkToplevel* toplevel);
+    void                                             draw(SBenchmarkToplevel* toplevel);
+    void                                             present(SBenchmarkToplevel* toplevel);
+
+    wl_display*                                      m_pDisplay    = nullptr;
+    wl_registry*                                     m_pRegistry   = nullptr;
+    wl_compositor*                                   m_pCompositor = nullptr;
+    wl_shm*                                          m_pShm        = nullptr;
+    xdg_wm_base*                                     m_pWmBase     = nullptr;
+
+    std::vector<std::unique_ptr<SBenchmarkToplevel>> m_vToplevels;
+
+    bool                                             m_bFlushPending = false;
+};
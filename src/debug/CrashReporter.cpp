@@ -241,5 +241,6 @@ void CrashReporter::createAndSaveCrash(int sig) {
 
     finalCrashReport += "\n\nLog tail:\n";
 
-    finalCrashReport += std::string_view(Debug::rollingLog).substr(Debug::rollingLog.find("\n") + 1);
+    const auto LOGTAIL = Debug::flushForCrash();
+    finalCrashReport += std::string_view(LOGTAIL).substr(LOGTAIL.find("\n") + 1);
 }
@@ -0,0 +1,111 @@
+#include "FrameTimes.hpp"
+#include <algorithm>
+#include <cmath>
+
+static uint64_t toNs(const timespec& ts) {
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t nowNs() {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return toNs(now);
+}
+
+static size_t bucketFor(uint32_t us) {
+    if (us <= 1)
+        return 0;
+
+    return std::min((size_t)(std::log2((double)us) * TIME_HISTOGRAM_SUBBUCKETS), TIME_HISTOGRAM_BUCKETS - 1);
+}
+
+void CTimeHistogram::add(float ms) {
+    const uint32_t US = std::clamp(ms * 1000.F, 0.F, (float)UINT32_MAX);
+
+    m_aBuckets[bucketFor(US)].fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t prev = m_iMaxUs.load(std::memory_order_relaxed);
+    while (US > prev && !m_iMaxUs.compare_exchange_weak(prev, US, std::memory_order_relaxed)) {
+        ;
+    }
+}
+
+void CTimeHistogram::reset() {
+    for (auto& b : m_aBuckets) {
+        b.store(0, std::memory_order_relaxed);
+    }
+
+    m_iMaxUs.store(0, std::memory_order_relaxed);
+}
+
+float CTimeHistogram::percentile(float p) const {
+    // a snapshot, so the total matches the buckets even if someone adds meanwhile
+    std::array<uint32_t, TIME_HISTOGRAM_BUCKETS> buckets;
+    uint64_t                                     total = 0;
+    for (size_t i = 0; i < TIME_HISTOGRAM_BUCKETS; ++i) {
+        buckets[i] = m_aBuckets[i].load(std::memory_order_relaxed);
+        total += buckets[i];
+    }
+
+    if (total == 0)
+        return 0;
+
+    const uint64_t TARGET = std::max((uint64_t)std::ceil(std::clamp(p, 0.F, 1.F) * total), (uint64_t)1);
+
+    uint64_t       seen = 0;
+    for (size_t i = 0; i < TIME_HISTOGRAM_BUCKETS; ++i) {
+        seen += buckets[i];
+        if (seen >= TARGET)
+            return std::min((float)(std::exp2((double)(i + 1) / TIME_HISTOGRAM_SUBBUCKETS) / 1000.0), max());
+    }
+
+    return max();
+}
+
+float CTimeHistogram::max() const {
+    return m_iMaxUs.load(std::memory_order_relaxed) / 1000.F;
+}
+
+uint64_t CTimeHistogram::count() const {
+    uint64_t total = 0;
+    for (auto const& b : m_aBuckets) {
+        total += b.load(std::memory_order_relaxed);
+    }
+
+    return total;
+}
+
+void CFrameTimes::onCommit() {
+    m_iLastCommitNs = nowNs();
+}
+
+void CFrameTimes::onPresented(const timespec* when, uint32_t refreshNs, float refreshRate) {
+    // a present without a commit of ours, e.g. a modeset
+    if (m_iLastCommitNs == 0)
+        return;
+
+    const uint64_t PRESENTNS = when ? toNs(*when) : nowNs();
+    const double   PERIODNS  = refreshNs ? refreshNs : 1000000000.0 / std::max(refreshRate, 1.F);
+    const double   LATENCYNS = PRESENTNS > m_iLastCommitNs ? PRESENTNS - m_iLastCommitNs : 0;
+
+    present.add(LATENCYNS / 1000000.0);
+
+    // a commit goes out on the next vblank, anything later than that was missed
+    if (LATENCYNS > PERIODNS * 1.5)
+        missedVblanks.fetch_add(std::round(LATENCYNS / PERIODNS) - 1, std::memory_order_relaxed);
+
+    // only while frames follow each other, idle time isn't a frame interval
+    if (m_iLastPresentNs != 0 && m_iLastCommitNs > m_iLastPresentNs && PRESENTNS > m_iLastPresentNs && m_iLastCommitNs - m_iLastPresentNs < PERIODNS * 2)
+        interval.add((PRESENTNS - m_iLastPresentNs) / 1000000.0);
+
+    m_iLastPresentNs = PRESENTNS;
+    m_iLastCommitNs  = 0;
+}
+
+void CFrameTimes::reset() {
+    interval.reset();
+    render.reset();
+    gpu.reset();
+    present.reset();
+    missedVblanks.store(0, std::memory_order_relaxed);
+}
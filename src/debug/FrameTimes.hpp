@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+// 8 buckets per power of two, from 1us to ~16s
+constexpr size_t TIME_HISTOGRAM_SUBBUCKETS = 8;
+constexpr size_t TIME_HISTOGRAM_BUCKETS    = 24 * TIME_HISTOGRAM_SUBBUCKETS;
+
+/*
+    Fixed-size, log-scaled histogram of durations. Percentiles are off by at most a bucket, about 9%.
+    Adding and reading are relaxed atomics, so it can be read while being written to without locking.
+*/
+class CTimeHistogram {
+  public:
+    void     add(float ms);
+    void     reset();
+
+    float    percentile(float p) const; // p in [0, 1]. In ms, the upper bound of the bucket it falls into, 0 if empty.
+    float    max() const;               // in ms, exact
+    uint64_t count() const;
+
+  private:
+    std::array<std::atomic<uint32_t>, TIME_HISTOGRAM_BUCKETS> m_aBuckets = {};
+    std::atomic<uint32_t>                                     m_iMaxUs   = 0;
+};
+
+/*
+    Frame timings of a monitor, see hyprctl frametimes.
+    The renderer and the present event feed it, nothing here depends on the debug overlay.
+*/
+class CFrameTimes {
+  public:
+    CTimeHistogram        interval; // between two presents
+    CTimeHistogram        render;   // cpu time of renderMonitor
+    CTimeHistogram        gpu;      // gpu time of a frame, if timer queries are supported
+    CTimeHistogram        present;  // from the commit to the present
+
+    std::atomic<uint64_t> missedVblanks = 0;
+
+    void                  onCommit();
+    void                  onPresented(const timespec* when, uint32_t refreshNs, float refreshRate);
+    void                  reset();
+
+  private:
+    uint64_t m_iLastCommitNs  = 0;
+    uint64_t m_iLastPresentNs = 0;
+};
@@ -14,7 +14,7 @@
 #include <sys/utsname.h>
 #include <sys/un.h>
 #include <unistd.h>
-#include <sys/poll.h>
+#include <fcntl.h>
 #include <filesystem>
 #include <ranges>
 
@@ -22,6 +22,9 @@
 #include <string>
 #include <typeindex>
 #include <numeric>
+#include <array>
+#include <charconv>
+#include <unordered_map>
 
 #include <hyprutils/string/String.hpp>
 using namespace Hyprutils::String;
@@ -45,6 +48,188 @@ static void trimTrailingComma(std::string& str) {
         str.pop_back();
 }
 
+// Inputs of a serialized fragment. A fragment is only rebuilt when its key changes,
+// so a listing of unchanged objects is mostly comparisons and copies.
+// Windows mark their strings, tags, group and focus history index changed with CWindow::m_iStateGeneration,
+// the rest are plain values changed from too many places to mark.
+struct SWindowFragmentKey {
+    uint64_t    generation = 0;
+    bool        mapped = false, hidden = false, floating = false, pseudo = false, xwayland = false, pinned = false;
+    int         x = 0, y = 0, w = 0, h = 0;
+    uintptr_t   workspace   = 0; // its name changes are marked on the window
+    WORKSPACEID workspaceID = WORKSPACE_INVALID;
+    int64_t     monitorID   = -1;
+    pid_t       pid         = 0;
+    uint8_t     fullscreenInternal = 0, fullscreenClient = 0;
+    uintptr_t   swallowing = 0;
+
+    bool        operator==(const SWindowFragmentKey&) const = default;
+};
+
+struct SWorkspaceFragmentKey {
+    WORKSPACEID id = WORKSPACE_INVALID;
+    std::string name, monitorName;
+    MONITORID   monitorID            = MONITOR_INVALID;
+    int         windows              = 0;
+    bool        hasFullscreen        = false;
+    uintptr_t   lastWindow           = 0;
+    uint64_t    lastWindowGeneration = 0; // for its title
+
+    bool        operator==(const SWorkspaceFragmentKey&) const = default;
+};
+
+struct SMonitorFragmentKey {
+    MONITORID   id = MONITOR_INVALID;
+    std::string name, description, make, model, serial;
+    int         width = 0, height = 0, x = 0, y = 0;
+    float       refreshRate = 0, scale = 0;
+    WORKSPACEID activeWorkspaceID = WORKSPACE_INVALID, specialWorkspaceID = WORKSPACE_INVALID;
+    std::string activeWorkspaceName, specialWorkspaceName;
+    int         reserved[4] = {0};
+    int         transform   = 0;
+    bool        focused = false, dpms = false, vrr = false, tearing = false, enabled = false;
+    uintptr_t   solitary  = 0;
+    uint32_t    drmFormat = 0;
+    MONITORID   mirrorOf  = MONITOR_INVALID;
+    size_t      modes     = 0;
+
+    bool        operator==(const SMonitorFragmentKey&) const = default;
+};
+
+template <typename K>
+struct SSnapshotFragment {
+    K           key;
+    std::string data;
+    uint64_t    lastSweep = 0;
+};
+
+template <typename K>
+using CFragmentMap = std::unordered_map<uintptr_t, SSnapshotFragment<K>>;
+
+struct CHyprCtl::SSnapshotCache {
+    // indexed by eHyprCtlOutputFormat
+    std::array<CFragmentMap<SWindowFragmentKey>, 2>    windows;
+    std::array<CFragmentMap<SWorkspaceFragmentKey>, 2> workspaces;
+    std::array<CFragmentMap<SMonitorFragmentKey>, 2>   monitors;
+    uint64_t                                           sweep = 0;
+};
+
+template <typename K, typename F>
+static const std::string& getFragment(CFragmentMap<K>& map, uint64_t sweep, uintptr_t id, K&& key, F&& build) {
+    auto& fragment     = map[id];
+    fragment.lastSweep = sweep;
+
+    if (fragment.data.empty() || !(fragment.key == key)) {
+        fragment.data = build();
+        fragment.key  = std::move(key);
+    }
+
+    return fragment.data;
+}
+
+// drop fragments of objects that weren't part of the last full listing
+template <typename K>
+static void sweepFragments(CFragmentMap<K>& map, uint64_t sweep) {
+    std::erase_if(map, [sweep](const auto& el) { return el.second.lastSweep != sweep; });
+}
+
+// focus history ids for a request, the history is walked once and only if a fragment is rebuilt
+class CFocusHistoryIDs {
+  public:
+    int get(const CWindow* pWindow) {
+        if (!m_bFilled) {
+            for (size_t i = 0; i < g_pCompositor->m_vWindowFocusHistory.size(); ++i) {
+                const auto PWINDOW = g_pCompositor->m_vWindowFocusHistory[i].lock();
+                if (PWINDOW && !m_mIDs.contains(PWINDOW.get()))
+                    m_mIDs[PWINDOW.get()] = i;
+            }
+
+            m_bFilled = true;
+        }
+
+        const auto IT = m_mIDs.find(pWindow);
+        return IT == m_mIDs.end() ? -1 : IT->second;
+    }
+
+  private:
+    std::unordered_map<const CWindow*, int> m_mIDs;
+    bool                                    m_bFilled = false;
+};
+
+static SWindowFragmentKey makeWindowKey(PHLWINDOW w) {
+    return SWindowFragmentKey{
+        .generation         = w->m_iStateGeneration,
+        .mapped             = w->m_bIsMapped,
+        .hidden             = w->isHidden(),
+        .floating           = w->m_bIsFloating,
+        .pseudo             = w->m_bIsPseudotiled,
+        .xwayland           = w->m_bIsX11,
+        .pinned             = w->m_bPinned,
+        .x                  = (int)w->m_vRealPosition.goal().x,
+        .y                  = (int)w->m_vRealPosition.goal().y,
+        .w                  = (int)w->m_vRealSize.goal().x,
+        .h                  = (int)w->m_vRealSize.goal().y,
+        .workspace          = (uintptr_t)w->m_pWorkspace.get(),
+        .workspaceID        = w->m_pWorkspace ? w->workspaceID() : WORKSPACE_INVALID,
+        .monitorID          = (int64_t)w->monitorID(),
+        .pid                = w->getPID(),
+        .fullscreenInternal = (uint8_t)w->m_sFullscreenState.internal,
+        .fullscreenClient   = (uint8_t)w->m_sFullscreenState.client,
+        .swallowing         = (uintptr_t)w->m_pSwallowed.lock().get(),
+    };
+}
+
+static SWorkspaceFragmentKey makeWorkspaceKey(PHLWORKSPACE w) {
+    const auto PLASTW   = w->getLastFocusedWindow();
+    const auto PMONITOR = w->m_pMonitor.lock();
+
+    return SWorkspaceFragmentKey{
+        .id                   = w->m_iID,
+        .name                 = w->m_szName,
+        .monitorName          = PMONITOR ? PMONITOR->szName : "",
+        .monitorID            = PMONITOR ? PMONITOR->ID : MONITOR_INVALID,
+        .windows              = g_pCompositor->getWindowsOnWorkspace(w->m_iID),
+        .hasFullscreen        = w->m_bHasFullscreenWindow,
+        .lastWindow           = (uintptr_t)PLASTW.get(),
+        .lastWindowGeneration = PLASTW ? PLASTW->m_iStateGeneration : 0,
+    };
+}
+
+static SMonitorFragmentKey makeMonitorKey(PHLMONITOR m) {
+    if (!m->output || m->ID == -1)
+        return {};
+
+    return SMonitorFragmentKey{
+        .id                   = m->ID,
+        .name                 = m->szName,
+        .description          = m->szShortDescription,
+        .make                 = m->output->make,
+        .model                = m->output->model,
+        .serial               = m->output->serial,
+        .width                = (int)m->vecPixelSize.x,
+        .height               = (int)m->vecPixelSize.y,
+        .x                    = (int)m->vecPosition.x,
+        .y                    = (int)m->vecPosition.y,
+        .refreshRate          = m->refreshRate,
+        .scale                = m->scale,
+        .activeWorkspaceID    = m->activeWorkspaceID(),
+        .specialWorkspaceID   = m->activeSpecialWorkspaceID(),
+        .activeWorkspaceName  = m->activeWorkspace ? m->activeWorkspace->m_szName : "",
+        .specialWorkspaceName = m->activeSpecialWorkspace ? m->activeSpecialWorkspace->m_szName : "",
+        .reserved             = {(int)m->vecReservedTopLeft.x, (int)m->vecReservedTopLeft.y, (int)m->vecReservedBottomRight.x, (int)m->vecReservedBottomRight.y},
+        .transform            = (int)m->transform,
+        .focused              = m == g_pCompositor->m_pLastMonitor,
+        .dpms                 = m->dpmsStatus,
+        .vrr                  = m->output->state->state().adaptiveSync,
+        .tearing              = m->tearingState.activelyTearing,
+        .enabled              = m->m_bEnabled,
+        .solitary             = (uintptr_t)m->solitaryClient.get(),
+        .drmFormat            = m->output->state->state().drmFormat,
+        .mirrorOf             = m->pMirrorOf ? m->pMirrorOf->ID : MONITOR_INVALID,
+        .modes                = m->output->modes.size(),
+    };
+}
+
 static std::string formatToString(uint32_t drmFormat) {
     switch (drmFormat) {
         case DRM_FORMAT_XRGB2101010: return "XRGB2101010";
@@ -149,12 +334,15 @@ std::string monitorsRequest(eHyprCtlOutputFormat format, std::string request) {
     if (vars.size() == 2 && vars[1] == "all")
         allMonitors = true;
 
+    auto&       cache = g_pHyprCtl->m_pSnapshotCache->monitors[format];
+    const auto  SWEEP = ++g_pHyprCtl->m_pSnapshotCache->sweep;
+
     std::string result = "";
     if (format == eHyprCtlOutputFormat::FORMAT_JSON) {
         result += "[";
 
         for (auto const& m : allMonitors ? g_pCompositor->m_vRealMonitors : g_pCompositor->m_vMonitors) {
-            result += CHyprCtl::getMonitorData(m, format);
+            result += getFragment(cache, SWEEP, (uintptr_t)m.get(), makeMonitorKey(m), [&]() { return CHyprCtl::getMonitorData(m, format); });
         }
 
         trimTrailingComma(result);
@@ -165,10 +353,13 @@ std::string monitorsRequest(eHyprCtlOutputFormat format, std::string request) {
             if (!m->output || m->ID == -1)
                 continue;
 
-            result += CHyprCtl::getMonitorData(m, format);
+            result += getFragment(cache, SWEEP, (uintptr_t)m.get(), makeMonitorKey(m), [&]() { return CHyprCtl::getMonitorData(m, format); });
         }
     }
 
+    if (allMonitors)
+        sweepFragments(cache, SWEEP);
+
     return result;
 }
 
@@ -206,8 +397,11 @@ static std::string getGroupedData(PHLWINDOW w, eHyprCtlOutputFormat format) {
     return result.str();
 }
 
-std::string CHyprCtl::getWindowData(PHLWINDOW w, eHyprCtlOutputFormat format) {
-    auto getFocusHistoryID = [](PHLWINDOW wnd) -> int {
+std::string CHyprCtl::getWindowData(PHLWINDOW w, eHyprCtlOutputFormat format, std::optional<int> focusHistoryID) {
+    auto getFocusHistoryID = [focusHistoryID](PHLWINDOW wnd) -> int {
+        if (focusHistoryID.has_value())
+            return *focusHistoryID;
+
         for (size_t i = 0; i < g_pCompositor->m_vWindowFocusHistory.size(); ++i) {
             if (g_pCompositor->m_vWindowFocusHistory[i].lock() == wnd)
                 return i;
@@ -266,7 +460,14 @@ std::string CHyprCtl::getWindowData(PHLWINDOW w, eHyprCtlOutputFormat format) {
 }
 
 std::string clientsRequest(eHyprCtlOutputFormat format, std::string request) {
-    std::string result = "";
+    auto&            cache      = g_pHyprCtl->m_pSnapshotCache->windows[format];
+    const auto       SWEEP      = ++g_pHyprCtl->m_pSnapshotCache->sweep;
+    CFocusHistoryIDs focusIDs;
+    const auto       windowData = [&](PHLWINDOW w) -> const std::string& {
+        return getFragment(cache, SWEEP, (uintptr_t)w.get(), makeWindowKey(w), [&]() { return CHyprCtl::getWindowData(w, format, focusIDs.get(w.get())); });
+    };
+
+    std::string      result = "";
     if (format == eHyprCtlOutputFormat::FORMAT_JSON) {
         result += "[";
 
@@ -274,7 +475,7 @@ std::string clientsRequest(eHyprCtlOutputFormat format, std::string request) {
             if (!w->m_bIsMapped && !g_pHyprCtl->m_sCurrentRequestParams.all)
                 continue;
 
-            result += CHyprCtl::getWindowData(w, format);
+            result += windowData(w);
         }
 
         trimTrailingComma(result);
@@ -285,9 +486,12 @@ std::string clientsRequest(eHyprCtlOutputFormat format, std::string request) {
             if (!w->m_bIsMapped && !g_pHyprCtl->m_sCurrentRequestParams.all)
                 continue;
 
-            result += CHyprCtl::getWindowData(w, format);
+            result += windowData(w);
         }
     }
+
+    sweepFragments(cache, SWEEP);
+
     return result;
 }
 
@@ -380,10 +584,16 @@ std::string activeWorkspaceRequest(eHyprCtlOutputFormat format, std::string requ
 std::string workspacesRequest(eHyprCtlOutputFormat format, std::string request) {
     std::string result = "";
 
+    auto&      cache         = g_pHyprCtl->m_pSnapshotCache->workspaces[format];
+    const auto SWEEP         = ++g_pHyprCtl->m_pSnapshotCache->sweep;
+    const auto workspaceData = [&](PHLWORKSPACE w) -> const std::string& {
+        return getFragment(cache, SWEEP, (uintptr_t)w.get(), makeWorkspaceKey(w), [&]() { return CHyprCtl::getWorkspaceData(w, format); });
+    };
+
     if (format == eHyprCtlOutputFormat::FORMAT_JSON) {
         result += "[";
         for (auto const& w : g_pCompositor->m_vWorkspaces) {
-            result += CHyprCtl::getWorkspaceData(w, format);
+            result += workspaceData(w);
             result += ",";
         }
 
@@ -391,10 +601,12 @@ std::string workspacesRequest(eHyprCtlOutputFormat format, std::string request)
         result += "]";
     } else {
         for (auto const& w : g_pCompositor->m_vWorkspaces) {
-            result += CHyprCtl::getWorkspaceData(w, format);
+            result += workspaceData(w);
         }
     }
 
+    sweepFragments(cache, SWEEP);
+
     return result;
 }
 
@@ -424,7 +636,10 @@ std::string activeWindowRequest(eHyprCtlOutputFormat format, std::string request
     if (!validMapped(PWINDOW))
         return format == eHyprCtlOutputFormat::FORMAT_JSON ? "{}" : "Invalid";
 
-    auto result = CHyprCtl::getWindowData(PWINDOW, format);
+    // one fragment, don't sweep the rest of the cache
+    auto&       cache  = g_pHyprCtl->m_pSnapshotCache->windows[format];
+    std::string result = getFragment(cache, g_pHyprCtl->m_pSnapshotCache->sweep, (uintptr_t)PWINDOW.get(), makeWindowKey(PWINDOW),
+                                     [&]() { return CHyprCtl::getWindowData(PWINDOW, format); });
 
     if (format == eHyprCtlOutputFormat::FORMAT_JSON)
         result.pop_back();
@@ -779,10 +994,72 @@ std::string rollinglogRequest(eHyprCtlOutputFormat format, std::string request)
 
     if (format == eHyprCtlOutputFormat::FORMAT_JSON) {
         result += "[\n\"log\":\"";
-        result += escapeJSONStrings(Debug::rollingLog);
+        result += escapeJSONStrings(Debug::getRollingLog());
         result += "\"]";
     } else {
-        result = Debug::rollingLog;
+        result = Debug::getRollingLog();
+    }
+
+    return result;
+}
+
+static std::string getHistogramData(const CTimeHistogram& histogram, eHyprCtlOutputFormat format) {
+    if (format == eHyprCtlOutputFormat::FORMAT_JSON)
+        return std::format(R"#({{"p50": {:.3f}, "p95": {:.3f}, "p99": {:.3f}, "max": {:.3f}, "count": {}}})#", histogram.percentile(0.5F), histogram.percentile(0.95F),
+                           histogram.percentile(0.99F), histogram.max(), histogram.count());
+
+    return std::format("p50 {:.2f}ms, p95 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms ({} samples)", histogram.percentile(0.5F), histogram.percentile(0.95F), histogram.percentile(0.99F),
+                       histogram.max(), histogram.count());
+}
+
+std::string frametimesRequest(eHyprCtlOutputFormat format, std::string request) {
+    CVarList vars(request, 0, ' ');
+
+    if (vars.size() > 2)
+        return "too many args";
+
+    if (vars.size() == 2) {
+        if (vars[1] != "reset")
+            return "unknown arg, only 'reset' is supported";
+
+        for (auto const& m : g_pCompositor->m_vMonitors) {
+            m->frameTimes.reset();
+        }
+
+        g_pAnimationManager->m_hTickTimes.reset();
+
+        return "ok";
+    }
+
+    std::string result = "";
+    if (format == eHyprCtlOutputFormat::FORMAT_JSON) {
+        result += "{\n\"monitors\": [";
+
+        for (auto const& m : g_pCompositor->m_vMonitors) {
+            result += std::format(R"#(
+{{
+    "name": "{}",
+    "interval": {},
+    "render": {},
+    "gpu": {},
+    "present": {},
+    "missedVblanks": {}
+}},)#",
+                                  escapeJSONStrings(m->szName), getHistogramData(m->frameTimes.interval, format), getHistogramData(m->frameTimes.render, format),
+                                  getHistogramData(m->frameTimes.gpu, format), getHistogramData(m->frameTimes.present, format), m->frameTimes.missedVblanks.load());
+        }
+
+        trimTrailingComma(result);
+
+        result += std::format("],\n\"animationTick\": {}\n}}", getHistogramData(g_pAnimationManager->m_hTickTimes, format));
+    } else {
+        for (auto const& m : g_pCompositor->m_vMonitors) {
+            result += std::format("Monitor {}:\n\tinterval: {}\n\trender: {}\n\tgpu: {}\n\tpresent: {}\n\tmissed vblanks: {}\n\n", m->szName,
+                                  getHistogramData(m->frameTimes.interval, format), getHistogramData(m->frameTimes.render, format), getHistogramData(m->frameTimes.gpu, format),
+                                  getHistogramData(m->frameTimes.present, format), m->frameTimes.missedVblanks.load());
+        }
+
+        result += std::format("animation tick: {}\n", getHistogramData(g_pAnimationManager->m_hTickTimes, format));
     }
 
     return result;
@@ -1598,6 +1875,8 @@ std::string submapRequest(eHyprCtlOutputFormat format, std::string request) {
 }
 
 CHyprCtl::CHyprCtl() {
+    m_pSnapshotCache = std::make_unique<SSnapshotCache>();
+
     registerCommand(SHyprCtlCommand{"workspaces", true, workspacesRequest});
     registerCommand(SHyprCtlCommand{"workspacerules", true, workspaceRulesRequest});
     registerCommand(SHyprCtlCommand{"activeworkspace", true, activeWorkspaceRequest});
@@ -1634,12 +1913,19 @@ CHyprCtl::CHyprCtl() {
     registerCommand(SHyprCtlCommand{"setcursor", false, dispatchSetCursor});
     registerCommand(SHyprCtlCommand{"getoption", false, dispatchGetOption});
     registerCommand(SHyprCtlCommand{"decorations", false, decorationRequest});
+    registerCommand(SHyprCtlCommand{"frametimes", false, frametimesRequest});
     registerCommand(SHyprCtlCommand{"[[BATCH]]", false, dispatchBatch});
 
     startHyprCtlSocket();
 }
 
 CHyprCtl::~CHyprCtl() {
+    for (auto const& client : m_vClients) {
+        wl_event_source_remove(client.eventSource);
+        wl_event_source_remove(client.timeoutSource);
+        close(client.fd);
+    }
+
     if (m_eventSource)
         wl_event_source_remove(m_eventSource);
     if (m_iSocketFD >= 0)
@@ -1798,71 +2084,362 @@ bool isFollowUpRollingLogRequest(const std::string& request) {
     return request.contains("rollinglog") && request.contains("f");
 }
 
-int hyprCtlFDTick(int fd, uint32_t mask, void* data) {
+// a client that doesn't finish its request or read its reply in this time is dropped
+constexpr int              CLIENT_TIMEOUT_MS   = 5000;
+constexpr size_t           MAX_REQUEST_SIZE    = 1024 * 1024;
+constexpr size_t           CLIENT_READ_CHUNK   = 8192;
+constexpr size_t           MAX_FRAME_HEADER    = 20;
+constexpr size_t           MAX_SESSION_PENDING = 4 * 1024 * 1024; // unread reply bytes before we stop reading new session requests
+constexpr int              SESSION_IDLE_MS     = 10 * 60 * 1000;  // a session without requests for this long is closed
+constexpr std::string_view SESSION_HANDSHAKE   = "[[SESSION]]";
+
+int                        CHyprCtl::onSocketEvent(int fd, uint32_t mask, void* data) {
+    return g_pHyprCtl->onSocketEvent(fd, mask);
+}
+
+int CHyprCtl::onClientEvent(int fd, uint32_t mask, void* data) {
+    return g_pHyprCtl->onClientEvent(fd, mask);
+}
+
+int CHyprCtl::onClientTimeout(void* data) {
+    const auto FD = (int)(intptr_t)data;
+
+    Debug::log(WARN, "Hypr socket client at fd {} timed out, dropping", FD);
+    g_pHyprCtl->removeClientByFD(FD);
+
+    return 0;
+}
+
+int CHyprCtl::onSocketEvent(int fd, uint32_t mask) {
     if (mask & WL_EVENT_ERROR || mask & WL_EVENT_HANGUP)
         return 0;
 
-    sockaddr_in            clientAddress;
-    socklen_t              clientSize = sizeof(clientAddress);
+    // accept everything that's pending, none of it can block
+    while (true) {
+        sockaddr_in clientAddress;
+        socklen_t   clientSize         = sizeof(clientAddress);
+        const auto  ACCEPTEDCONNECTION = accept4(m_iSocketFD, (sockaddr*)&clientAddress, &clientSize, SOCK_CLOEXEC | SOCK_NONBLOCK);
 
-    const auto             ACCEPTEDCONNECTION = accept4(g_pHyprCtl->m_iSocketFD, (sockaddr*)&clientAddress, &clientSize, SOCK_CLOEXEC);
+        if (ACCEPTEDCONNECTION < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                Debug::log(ERR, "Hypr socket failed receiving connection, errno: {}", errno);
+            break;
+        }
 
-    std::array<char, 1024> readBuffer;
+        auto& client         = m_vClients.emplace_back();
+        client.fd            = ACCEPTEDCONNECTION;
+        client.eventSource   = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, ACCEPTEDCONNECTION, WL_EVENT_READABLE, onClientEvent, nullptr);
+        client.timeoutSource = wl_event_loop_add_timer(g_pCompositor->m_sWLEventLoop, onClientTimeout, (void*)(intptr_t)ACCEPTEDCONNECTION);
+        wl_event_source_timer_update(client.timeoutSource, CLIENT_TIMEOUT_MS);
+    }
 
-    //
-    pollfd pollfds[1] = {
-        {
-            .fd     = ACCEPTEDCONNECTION,
-            .events = POLLIN,
-        },
-    };
+    return 0;
+}
+
+// session frames, both ways, are "<payload length>\n<payload>"
+enum eSessionFrameResult : uint8_t {
+    SESSION_FRAME_INCOMPLETE = 0,
+    SESSION_FRAME_OK,
+    SESSION_FRAME_INVALID,
+};
+
+static eSessionFrameResult peekSessionFrame(const std::string& buffer, size_t& payloadStart, size_t& payloadLen) {
+    const auto NEWLINE = buffer.find('\n');
+
+    if (NEWLINE == std::string::npos)
+        return buffer.size() > MAX_FRAME_HEADER ? SESSION_FRAME_INVALID : SESSION_FRAME_INCOMPLETE;
+
+    const auto HEADER = buffer.substr(0, NEWLINE);
+    if (HEADER.empty() || HEADER.size() > MAX_FRAME_HEADER || !isNumber(HEADER))
+        return SESSION_FRAME_INVALID;
+
+    payloadStart = NEWLINE + 1;
+
+    const auto [PTR, EC] = std::from_chars(HEADER.data(), HEADER.data() + HEADER.size(), payloadLen);
+    if (EC != std::errc{} || PTR != HEADER.data() + HEADER.size() || payloadLen > MAX_REQUEST_SIZE)
+        return SESSION_FRAME_INVALID;
+
+    return buffer.size() < payloadStart + payloadLen ? SESSION_FRAME_INCOMPLETE : SESSION_FRAME_OK;
+}
+
+static eSessionFrameResult popSessionFrame(std::string& buffer, std::string& frame) {
+    size_t     payloadStart = 0, payloadLen = 0;
+    const auto RESULT = peekSessionFrame(buffer, payloadStart, payloadLen);
+
+    if (RESULT != SESSION_FRAME_OK)
+        return RESULT;
+
+    frame = buffer.substr(payloadStart, payloadLen);
+    buffer.erase(0, payloadStart + payloadLen);
+
+    return SESSION_FRAME_OK;
+}
 
-    int ret = poll(pollfds, 1, 5000);
+static std::string makeSessionFrame(const std::string& payload) {
+    return std::format("{}\n{}", payload.size(), payload);
+}
+
+int CHyprCtl::onClientEvent(int fd, uint32_t mask) {
+    auto client = findClientByFD(fd);
+
+    if (client == m_vClients.end())
+        return 0;
+
+    if (mask & WL_EVENT_ERROR) {
+        removeClientByFD(fd);
+        return 0;
+    }
 
-    if (ret <= 0) {
-        close(ACCEPTEDCONNECTION);
+    if ((mask & WL_EVENT_WRITABLE) && client->replyOffset < client->reply.size()) {
+        if (client->session)
+            processSessionRequests(fd);
+        else if (flushClientReply(fd))
+            finishClient(fd);
         return 0;
     }
 
-    std::string request;
+    if (!client->replying && (mask & WL_EVENT_READABLE)) {
+        bool eof = false;
+        if (!readClient(fd, eof))
+            return 0;
+
+        client = findClientByFD(fd);
+
+        if (client->session) {
+            client->closing = eof;
+            processSessionRequests(fd);
+            return 0;
+        }
+
+        if (client->request.empty()) {
+            if (eof || mask & WL_EVENT_HANGUP)
+                removeClientByFD(fd);
+            return 0;
+        }
+
+        if (client->request.starts_with(SESSION_HANDSHAKE)) {
+            // persistent session: framed, pipelined requests on this connection until the client closes it
+            client->session = true;
+            client->closing = eof;
+            client->request.erase(0, SESSION_HANDSHAKE.length());
+            if (client->request.starts_with('\n'))
+                client->request.erase(0, 1);
+            client->reply = makeSessionFrame("ok");
+
+            Debug::log(LOG, "Hypr socket client at fd {} started a session", fd);
+
+            processSessionRequests(fd);
+            return 0;
+        }
+
+        wl_event_source_timer_update(client->timeoutSource, CLIENT_TIMEOUT_MS);
+
+        // there is no framing: a request is whatever the client sent before the socket ran dry
+        dispatchClientRequest(fd);
+        return 0;
+    }
+
+    if (mask & WL_EVENT_HANGUP)
+        removeClientByFD(fd);
+
+    return 0;
+}
+
+bool CHyprCtl::readClient(int fd, bool& eof) {
+    auto                                client = findClientByFD(fd);
+    std::array<char, CLIENT_READ_CHUNK> readBuffer;
+
     while (true) {
-        readBuffer.fill(0);
-        auto messageSize = read(ACCEPTEDCONNECTION, readBuffer.data(), 1023);
-        if (messageSize < 1)
-            break;
-        std::string recvd = readBuffer.data();
-        request += recvd;
-        if (messageSize < 1023)
-            break;
+        // sessions may pipeline more than we want to buffer, leave the rest in the socket until we catch up.
+        // Anything past this size holds at least one complete frame, so we always make progress.
+        if (client->session && client->request.size() > MAX_REQUEST_SIZE + MAX_FRAME_HEADER + 1)
+            return true;
+
+        const auto LEN = read(fd, readBuffer.data(), readBuffer.size());
+
+        if (LEN > 0) {
+            client->request.append(readBuffer.data(), LEN);
+
+            if (!client->session && client->request.size() > MAX_REQUEST_SIZE) {
+                Debug::log(ERR, "Hypr socket client at fd {} sent an oversized request, dropping", fd);
+                removeClientByFD(fd);
+                return false;
+            }
+
+            continue;
+        }
+
+        if (LEN == 0) {
+            eof = true;
+            return true;
+        }
+
+        if (errno == EINTR)
+            continue;
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return true;
+
+        removeClientByFD(fd);
+        return false;
     }
+}
 
+std::string CHyprCtl::runSocketRequest(const std::string& request) {
     std::string reply = "";
 
     try {
-        reply = g_pHyprCtl->getReply(request);
+        reply = getReply(request);
     } catch (std::exception& e) {
         Debug::log(ERR, "Error in request: {}", e.what());
         reply = "Err: " + std::string(e.what());
     }
 
-    successWrite(ACCEPTEDCONNECTION, reply);
-
-    if (isFollowUpRollingLogRequest(request)) {
-        Debug::log(LOG, "Followup rollinglog request received. Starting thread to write to socket.");
-        Debug::RollingLogFollow::Get().StartFor(ACCEPTEDCONNECTION);
-        runWritingDebugLogThread(ACCEPTEDCONNECTION);
-        Debug::log(LOG, Debug::RollingLogFollow::Get().DebugInfo());
-    } else
-        close(ACCEPTEDCONNECTION);
-
     if (g_pConfigManager->m_bWantsMonitorReload)
         g_pConfigManager->ensureMonitorStatus();
 
-    return 0;
+    return reply;
+}
+
+void CHyprCtl::dispatchClientRequest(int fd) {
+    auto reply = runSocketRequest(findClientByFD(fd)->request);
+
+    // the request might have done anything, including dropping clients
+    auto client = findClientByFD(fd);
+    if (client == m_vClients.end())
+        return;
+
+    client->reply       = std::move(reply);
+    client->replyOffset = 0;
+    client->replying    = true;
+
+    if (flushClientReply(fd))
+        finishClient(fd);
+}
+
+void CHyprCtl::processSessionRequests(int fd) {
+    while (true) {
+        auto client = findClientByFD(fd);
+        if (client == m_vClients.end())
+            return;
+
+        // don't run ahead of a client that doesn't read its replies
+        std::string frame;
+        while (client->reply.size() - client->replyOffset < MAX_SESSION_PENDING) {
+            const auto RESULT = popSessionFrame(client->request, frame);
+
+            if (RESULT == SESSION_FRAME_INCOMPLETE)
+                break;
+
+            if (RESULT == SESSION_FRAME_INVALID) {
+                Debug::log(ERR, "Hypr socket client at fd {} sent an invalid session frame, dropping", fd);
+                removeClientByFD(fd);
+                return;
+            }
+
+            auto reply = runSocketRequest(frame);
+
+            client = findClientByFD(fd);
+            if (client == m_vClients.end())
+                return;
+
+            client->reply += makeSessionFrame(reply);
+        }
+
+        if (!flushClientReply(fd))
+            return;
+
+        client = findClientByFD(fd);
+
+        // flushed everything, keep going if we stopped early because of backpressure
+        size_t payloadStart = 0, payloadLen = 0;
+        if (peekSessionFrame(client->request, payloadStart, payloadLen) == SESSION_FRAME_OK)
+            continue;
+
+        if (client->closing) {
+            removeClientByFD(fd);
+            return;
+        }
+
+        wl_event_source_fd_update(client->eventSource, WL_EVENT_READABLE);
+
+        // a half-sent frame has to be finished quickly, an idle session can wait much longer for its next request
+        wl_event_source_timer_update(client->timeoutSource, client->request.empty() ? SESSION_IDLE_MS : CLIENT_TIMEOUT_MS);
+        return;
+    }
+}
+
+bool CHyprCtl::flushClientReply(int fd) {
+    auto client = findClientByFD(fd);
+
+    while (client->replyOffset < client->reply.size()) {
+        const auto LEN = write(fd, client->reply.data() + client->replyOffset, client->reply.size() - client->replyOffset);
+
+        if (LEN > 0) {
+            client->replyOffset += LEN;
+            continue;
+        }
+
+        if (LEN < 0 && errno == EINTR)
+            continue;
+
+        if (LEN < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // finish when the client reads some more
+            wl_event_source_fd_update(client->eventSource, WL_EVENT_WRITABLE);
+            wl_event_source_timer_update(client->timeoutSource, CLIENT_TIMEOUT_MS);
+            return false;
+        }
+
+        Debug::log(ERR, "Couldn't write to socket. Error: {}", strerror(errno));
+        removeClientByFD(fd);
+        return false;
+    }
+
+    client->reply.clear();
+    client->replyOffset = 0;
+
+    return true;
+}
+
+void CHyprCtl::finishClient(int fd) {
+    const auto REQUEST = findClientByFD(fd)->request;
+
+    if (!isFollowUpRollingLogRequest(REQUEST)) {
+        removeClientByFD(fd);
+        return;
+    }
+
+    // the log follower owns the fd from now on, and writes to it from its own thread
+    removeClientByFD(fd, false);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+    Debug::log(LOG, "Followup rollinglog request received. Starting thread to write to socket.");
+    Debug::RollingLogFollow::Get().StartFor(fd);
+    runWritingDebugLogThread(fd);
+    Debug::log(LOG, Debug::RollingLogFollow::Get().DebugInfo());
+}
+
+std::vector<CHyprCtl::SClient>::iterator CHyprCtl::findClientByFD(int fd) {
+    return std::find_if(m_vClients.begin(), m_vClients.end(), [fd](const auto& client) { return client.fd == fd; });
+}
+
+void CHyprCtl::removeClientByFD(int fd, bool closeFD) {
+    const auto CLIENTIT = findClientByFD(fd);
+
+    if (CLIENTIT == m_vClients.end())
+        return;
+
+    wl_event_source_remove(CLIENTIT->eventSource);
+    wl_event_source_remove(CLIENTIT->timeoutSource);
+
+    if (closeFD)
+        close(fd);
+
+    m_vClients.erase(CLIENTIT);
 }
 
 void CHyprCtl::startHyprCtlSocket() {
-    m_iSocketFD = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    m_iSocketFD = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
 
     if (m_iSocketFD < 0) {
         Debug::log(ERR, "Couldn't start the Hyprland Socket. (1) IPC will not work.");
@@ -1885,5 +2462,5 @@ void CHyprCtl::startHyprCtlSocket() {
 
     Debug::log(LOG, "Hypr socket started at {}", m_socketPath);
 
-    m_eventSource = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, m_iSocketFD, WL_EVENT_READABLE, hyprCtlFDTick, nullptr);
+    m_eventSource = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, m_iSocketFD, WL_EVENT_READABLE, onSocketEvent, nullptr);
 }
@@ -26,14 +26,51 @@ class CHyprCtl {
         bool sysInfoConfig = false;
     } m_sCurrentRequestParams;
 
-    static std::string getWindowData(PHLWINDOW w, eHyprCtlOutputFormat format);
+    // serialized clients / workspaces / monitors, reused as long as their inputs don't change
+    struct SSnapshotCache;
+    std::unique_ptr<SSnapshotCache> m_pSnapshotCache;
+
+    static std::string getWindowData(PHLWINDOW w, eHyprCtlOutputFormat format, std::optional<int> focusHistoryID = {}); // looked up when not given
     static std::string getWorkspaceData(PHLWORKSPACE w, eHyprCtlOutputFormat format);
     static std::string getMonitorData(Hyprutils::Memory::CSharedPointer<CMonitor> m, eHyprCtlOutputFormat format);
 
   private:
-    void                             startHyprCtlSocket();
+    void startHyprCtlSocket();
+
+    // every client is serviced from the event loop without ever blocking it:
+    // read until the client goes quiet, reply, then write the reply out as the socket becomes writable.
+    // Clients opening with [[SESSION]] instead keep the connection and send length-framed requests, see processSessionRequests
+    struct SClient {
+        int              fd            = -1;
+        wl_event_source* eventSource   = nullptr;
+        wl_event_source* timeoutSource = nullptr;
+        std::string      request;
+        std::string      reply;
+        size_t           replyOffset = 0;
+        bool             replying    = false;
+        bool             session     = false;
+        bool             closing     = false; // session client sent EOF, close once replies are out
+    };
+
+    static int                       onSocketEvent(int fd, uint32_t mask, void* data);
+    static int                       onClientEvent(int fd, uint32_t mask, void* data);
+    static int                       onClientTimeout(void* data);
+
+    int                              onSocketEvent(int fd, uint32_t mask);
+    int                              onClientEvent(int fd, uint32_t mask);
+
+    bool                             readClient(int fd, bool& eof);
+    std::string                      runSocketRequest(const std::string& request);
+    void                             dispatchClientRequest(int fd);
+    void                             processSessionRequests(int fd);
+    bool                             flushClientReply(int fd);
+    void                             finishClient(int fd);
+
+    std::vector<SClient>::iterator   findClientByFD(int fd);
+    void                             removeClientByFD(int fd, bool closeFD = true);
 
     std::vector<SP<SHyprCtlCommand>> m_vCommands;
+    std::vector<SClient>             m_vClients;
     wl_event_source*                 m_eventSource = nullptr;
     std::string                      m_socketPath;
 };
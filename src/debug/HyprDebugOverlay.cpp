@@ -174,6 +174,9 @@ int CHyprMonitorDebugOverlay::draw(int offset) {
     text = std::format("Avg Anim Tick: {:.2f}ms (var {:.2f}ms) ({:.2f} TPS)", avgAnimMgrTick, varAnimMgrTick, 1.0 / (avgAnimMgrTick / 1000.0));
     showText(text.c_str(), 10);
 
+    text = std::format("Full damage fallbacks: {}/s", m_pMonitor->damage.fullDamageFallbacks());
+    showText(text.c_str(), 10);
+
     pango_font_description_free(pangoFD);
     g_object_unref(layoutText);
 
@@ -3,19 +3,327 @@
 #include "../Compositor.hpp"
 #include "RollingLogFollow.hpp"
 
-#include <fstream>
-#include <print>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <thread>
 #include <fcntl.h>
+#include <unistd.h>
+
+struct SLogRecord {
+    LogLevel                                             level = LOG;
+    std::string                                          msg;
+    std::optional<std::chrono::system_clock::time_point> time;
+    bool                                                 toFile   = false;
+    bool                                                 toStdout = false;
+    bool                                                 colored  = false;
+};
+
+// Bounded MPMC queue (Vyukov). Each cell's sequence number tells whether it's free for the
+// producer at a given position, or filled for the consumer, so no locks are needed.
+template <typename T, size_t SIZE>
+class CLogQueue {
+    static_assert((SIZE & (SIZE - 1)) == 0, "CLogQueue size has to be a power of two");
+
+  public:
+    CLogQueue() {
+        for (size_t i = 0; i < SIZE; ++i) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // false if full. data is only moved from on success.
+    bool push(T&& data) {
+        size_t pos  = m_enqueuePos.load(std::memory_order_relaxed);
+        SCell* cell = nullptr;
+
+        while (true) {
+            cell            = &m_cells[pos & (SIZE - 1)];
+            const auto SEQ  = cell->seq.load(std::memory_order_acquire);
+            const auto DIFF = (intptr_t)SEQ - (intptr_t)pos;
+
+            if (DIFF == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (DIFF < 0)
+                return false;
+            else
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+
+        cell->data = std::move(data);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        size_t pos  = m_dequeuePos.load(std::memory_order_relaxed);
+        SCell* cell = nullptr;
+
+        while (true) {
+            cell            = &m_cells[pos & (SIZE - 1)];
+            const auto SEQ  = cell->seq.load(std::memory_order_acquire);
+            const auto DIFF = (intptr_t)SEQ - (intptr_t)(pos + 1);
+
+            if (DIFF == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (DIFF < 0)
+                return false;
+            else
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+
+        out = std::move(cell->data);
+        cell->seq.store(pos + SIZE, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    struct SCell {
+        std::atomic<size_t> seq;
+        T                   data;
+    };
+
+    std::array<SCell, SIZE>          m_cells;
+    alignas(64) std::atomic<size_t> m_enqueuePos = 0;
+    alignas(64) std::atomic<size_t> m_dequeuePos = 0;
+};
+
+// fixed capacity tail of the log
+class CRollingLog {
+  public:
+    void append(std::string_view str) {
+        if (str.length() > m_buffer.size())
+            str = str.substr(str.length() - m_buffer.size());
+
+        // at most two copies, up to the end of the buffer and from its start
+        const size_t FIRST = std::min(str.length(), m_buffer.size() - m_head);
+        memcpy(m_buffer.data() + m_head, str.data(), FIRST);
+        memcpy(m_buffer.data(), str.data() + FIRST, str.length() - FIRST);
+
+        m_head = (m_head + str.length()) % m_buffer.size();
+        m_size = std::min(m_size + str.length(), m_buffer.size());
+    }
+
+    std::string str() const {
+        std::string result;
+        result.reserve(m_size);
+
+        const size_t START = (m_head + m_buffer.size() - m_size) % m_buffer.size();
+        const size_t FIRST = std::min(m_size, m_buffer.size() - START);
+        result.append(m_buffer.data() + START, FIRST);
+        result.append(m_buffer.data(), m_size - FIRST);
+
+        return result;
+    }
+
+  private:
+    std::array<char, ROLLING_LOG_SIZE> m_buffer = {};
+    size_t                             m_head   = 0;
+    size_t                             m_size   = 0;
+};
+
+static CLogQueue<SLogRecord, LOG_QUEUE_SIZE> logQueue;
+static CRollingLog                           rollingLog;
+static int                                   logFD = -1;
+
+// held while writing out records, guards logFD and rollingLog
+static std::timed_mutex             drainMutex;
+static std::atomic<std::thread::id> drainOwner;
+
+static std::thread                  writerThread;
+static std::thread::id              writerThreadID;
+static std::atomic<bool>            writerRunning  = false;
+static std::atomic<bool>            writerStop     = false;
+static std::atomic<uint32_t>        writerWakeups  = 0;
+static std::atomic<size_t>          droppedRecords = 0;
+
+// locks drainMutex and remembers who holds it, so a thread crashing with it held doesn't wait on itself
+class CDrainLock {
+  public:
+    CDrainLock() {
+        drainMutex.lock();
+        drainOwner.store(std::this_thread::get_id(), std::memory_order_release);
+    }
+
+    ~CDrainLock() {
+        drainOwner.store(std::thread::id{}, std::memory_order_release);
+        drainMutex.unlock();
+    }
+
+    CDrainLock(const CDrainLock&)            = delete;
+    CDrainLock& operator=(const CDrainLock&) = delete;
+};
+
+static const char* levelColor(LogLevel level) {
+    switch (level) {
+        case WARN: return "\033[1;33m"; // yellow
+        case ERR: return "\033[1;31m";  // red
+        case CRIT: return "\033[1;35m"; // magenta
+        case INFO: return "\033[1;32m"; // green
+        case TRACE: return "\033[1;34m"; // blue
+        default: return nullptr;
+    }
+}
+
+static std::string formatRecord(const SLogRecord& record) {
+    std::string result;
+
+    switch (record.level) {
+        case LOG: result = "[LOG] "; break;
+        case WARN: result = "[WARN] "; break;
+        case ERR: result = "[ERR] "; break;
+        case CRIT: result = "[CRITICAL] "; break;
+        case INFO: result = "[INFO] "; break;
+        case TRACE: result = "[TRACE] "; break;
+        default: break;
+    }
+
+    if (record.time.has_value()) {
+#ifndef _LIBCPP_VERSION
+        static auto current_zone = std::chrono::current_zone();
+        const auto  zt           = std::chrono::zoned_time{current_zone, *record.time};
+        const auto  hms          = std::chrono::hh_mm_ss{zt.get_local_time() - std::chrono::floor<std::chrono::days>(zt.get_local_time())};
+#else
+        // TODO: current clang 17 does not support `zoned_time`, remove this once clang 19 is ready
+        const auto hms = std::chrono::hh_mm_ss{*record.time - std::chrono::floor<std::chrono::days>(*record.time)};
+#endif
+        result += std::format("[{}] ", hms);
+    }
+
+    result += record.msg;
+
+    return result;
+}
+
+static void writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.length()) {
+        const auto LEN = write(fd, data.c_str() + written, data.length() - written);
+        if (LEN < 0 && errno == EINTR)
+            continue;
+        if (LEN <= 0)
+            return;
+        written += LEN;
+    }
+}
+
+// pops up to maxRecords and writes them out in one batch per target. drainMutex has to be held.
+static void drainLocked(size_t maxRecords = SIZE_MAX) {
+    std::string fileBatch, stdoutBatch;
+    SLogRecord  record;
+    size_t      count = 0;
+
+    const auto  add = [&](const SLogRecord& rec) {
+        const auto STR = formatRecord(rec);
+
+        rollingLog.append(STR);
+        rollingLog.append("\n");
+
+        if (Debug::RollingLogFollow::Get().IsRunning())
+            Debug::RollingLogFollow::Get().AddLog(STR);
+
+        if (rec.toFile)
+            fileBatch += STR + "\n";
+
+        if (rec.toStdout) {
+            const auto COLOR = rec.colored ? levelColor(rec.level) : nullptr;
+            stdoutBatch += COLOR ? std::format("{}{}\033[0m\n", COLOR, STR) : STR + "\n";
+        }
+    };
+
+    while (count < maxRecords && logQueue.pop(record)) {
+        count++;
+        add(record);
+    }
+
+    // straight into the batch, the queue is likely still full
+    if (const auto DROPPED = droppedRecords.exchange(0); DROPPED > 0)
+        add(SLogRecord{.level = WARN, .msg = std::format("Log queue overflowed, dropped {} messages", DROPPED), .toFile = true, .toStdout = true});
+
+    if (!fileBatch.empty() && logFD >= 0)
+        writeAll(logFD, fileBatch);
+
+    if (!stdoutBatch.empty()) {
+        fwrite(stdoutBatch.c_str(), 1, stdoutBatch.length(), stdout);
+        fflush(stdout);
+    }
+}
+
+static void writerLoop() {
+    while (!writerStop) {
+        const auto SEEN = writerWakeups.load(std::memory_order_acquire);
+
+        {
+            CDrainLock lg;
+            drainLocked();
+        }
+
+        // sleeps until anything is pushed after SEEN
+        writerWakeups.wait(SEEN, std::memory_order_acquire);
+    }
+
+    CDrainLock lg;
+    drainLocked();
+}
 
 void Debug::init(const std::string& IS) {
     logFile = IS + (ISDEBUG ? "/hyprlandd.log" : "/hyprland.log");
-    logOfs.open(logFile, std::ios::out | std::ios::app);
-    auto handle = logOfs.native_handle();
-    fcntl(handle, F_SETFD, FD_CLOEXEC);
+    logFD   = open(logFile.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+    writerStop    = false;
+    writerThread  = std::thread(writerLoop);
+    writerRunning = true;
+
+    writerThreadID = writerThread.get_id();
 }
 
 void Debug::close() {
-    logOfs.close();
+    if (writerRunning) {
+        writerStop = true;
+        writerWakeups.fetch_add(1, std::memory_order_release);
+        writerWakeups.notify_one();
+        writerThread.join();
+        writerRunning = false;
+    }
+
+    CDrainLock lg;
+    drainLocked();
+
+    if (logFD >= 0)
+        ::close(logFD);
+    logFD = -1;
+}
+
+void Debug::flush() {
+    CDrainLock lg;
+    drainLocked();
+}
+
+std::string Debug::flushForCrash() {
+    // if the writer itself, or whoever else holds the drain lock, crashed mid-write, leave its state alone
+    if (std::this_thread::get_id() == writerThreadID || drainOwner.load(std::memory_order_acquire) == std::this_thread::get_id())
+        return rollingLog.str();
+
+    if (!drainMutex.try_lock_for(std::chrono::milliseconds(100)))
+        return "";
+
+    drainOwner.store(std::this_thread::get_id(), std::memory_order_release);
+    drainLocked(LOG_QUEUE_SIZE);
+    auto result = rollingLog.str();
+    drainOwner.store(std::thread::id{}, std::memory_order_release);
+    drainMutex.unlock();
+
+    return result;
+}
+
+std::string Debug::getRollingLog() {
+    CDrainLock lg;
+    drainLocked();
+    return rollingLog.str();
 }
 
 void Debug::log(LogLevel level, std::string str) {
@@ -25,49 +333,41 @@ void Debug::log(LogLevel level, std::string str) {
     if (shuttingDown)
         return;
 
-    std::string coloredStr = str;
-    switch (level) {
-        case LOG:
-            str        = "[LOG] " + str;
-            coloredStr = str;
-            break;
-        case WARN:
-            str        = "[WARN] " + str;
-            coloredStr = "\033[1;33m" + str + "\033[0m"; // yellow
-            break;
-        case ERR:
-            str        = "[ERR] " + str;
-            coloredStr = "\033[1;31m" + str + "\033[0m"; // red
-            break;
-        case CRIT:
-            str        = "[CRITICAL] " + str;
-            coloredStr = "\033[1;35m" + str + "\033[0m"; // magenta
-            break;
-        case INFO:
-            str        = "[INFO] " + str;
-            coloredStr = "\033[1;32m" + str + "\033[0m"; // green
-            break;
-        case TRACE:
-            str        = "[TRACE] " + str;
-            coloredStr = "\033[1;34m" + str + "\033[0m"; // blue
-            break;
-        default: break;
+    SLogRecord record = {
+        .level    = level,
+        .msg      = std::move(str),
+        .toFile   = !disableLogs || !**disableLogs,
+        .toStdout = !disableStdout,
+        .colored  = !coloredLogs || **coloredLogs,
+    };
+
+    if (disableTime && !**disableTime)
+        record.time = std::chrono::system_clock::now();
+
+    // without a writer (before init, after close) log synchronously
+    if (!writerRunning) {
+        CDrainLock lg;
+        if (!logQueue.push(std::move(record))) {
+            drainLocked();
+            logQueue.push(std::move(record));
+        }
+        drainLocked();
+        return;
     }
 
-    rollingLog += str + "\n";
-    if (rollingLog.size() > ROLLING_LOG_SIZE)
-        rollingLog = rollingLog.substr(rollingLog.size() - ROLLING_LOG_SIZE);
+    for (size_t attempt = 0; !logQueue.push(std::move(record)); ++attempt) {
+        // full, give the writer a moment before dropping the message
+        writerWakeups.fetch_add(1, std::memory_order_release);
+        writerWakeups.notify_one();
 
-    if (RollingLogFollow::Get().IsRunning())
-        RollingLogFollow::Get().AddLog(str);
+        if (attempt >= 64) {
+            droppedRecords++;
+            return;
+        }
 
-    if (!disableLogs || !**disableLogs) {
-        // log to a file
-        logOfs << str << "\n";
-        logOfs.flush();
+        std::this_thread::yield();
     }
 
-    // log it to the stdout too.
-    if (!disableStdout)
-        std::println("{}", ((coloredLogs && !**coloredLogs) ? str : coloredStr));
+    writerWakeups.fetch_add(1, std::memory_order_release);
+    writerWakeups.notify_one();
 }
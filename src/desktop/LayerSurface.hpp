@@ -10,6 +10,13 @@ struct SLayerRule {
     std::string rule            = "";
 };
 
+// which layer rules target this layer, see CLayerRuleMatcher
+struct SLayerRuleMatchCache {
+    uint64_t            generation = 0;
+    std::string         szNamespace;
+    std::vector<size_t> candidates;
+};
+
 class CLayerShellResource;
 
 class CLayerSurface {
@@ -59,6 +66,8 @@ class CLayerSurface {
 
     std::optional<std::string> animationStyle;
 
+    SLayerRuleMatchCache       ruleMatchCache;
+
     PHLLSREF                   self;
 
     CBox                       geometry = {0, 0, 0, 0};
@@ -59,6 +59,10 @@ void CPopup::initAllSignals() {
 void CPopup::onNewPopup(SP<CXDGPopupResource> popup) {
     const auto POPUP = m_vChildren.emplace_back(makeShared<CPopup>(popup, this)).get();
     Debug::log(LOG, "New popup at {:x}", (uintptr_t)POPUP);
+
+    // windows with popups can be hit anywhere
+    if (!m_pWindowOwner.expired())
+        g_pCompositor->updateWindowHitIndex(m_pWindowOwner.lock());
 }
 
 void CPopup::onDestroy() {
@@ -67,7 +71,13 @@ void CPopup::onDestroy() {
     if (!m_pParent)
         return; // head node
 
+    // erasing can free this
+    const auto PWINDOW = m_pWindowOwner.lock();
+
     std::erase_if(m_pParent->m_vChildren, [this](const auto& other) { return other.get() == this; });
+
+    if (PWINDOW)
+        g_pCompositor->updateWindowHitIndex(PWINDOW);
 }
 
 void CPopup::onMap() {
@@ -254,6 +264,10 @@ Vector2D CPopup::t1ParentCoords() {
     return {};
 }
 
+bool CPopup::hasChildren() {
+    return !m_vChildren.empty();
+}
+
 void CPopup::recheckTree() {
     CPopup* curr = this;
     while (curr->m_pParent) {
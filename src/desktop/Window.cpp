@@ -19,8 +19,9 @@ using namespace Hyprutils::String;
 PHLWINDOW CWindow::create(SP<CXWaylandSurface> surface) {
     PHLWINDOW pWindow = SP<CWindow>(new CWindow(surface));
 
-    pWindow->m_pSelf  = pWindow;
-    pWindow->m_bIsX11 = true;
+    pWindow->m_pSelf       = pWindow;
+    pWindow->m_bIsX11      = true;
+    pWindow->m_iStackOrder = ++g_pCompositor->m_iTopStackOrder; // new windows go on top
 
     pWindow->m_vRealPosition.create(g_pConfigManager->getAnimationPropertyConfig("windowsIn"), pWindow, AVARDAMAGE_ENTIRE);
     pWindow->m_vRealSize.create(g_pConfigManager->getAnimationPropertyConfig("windowsIn"), pWindow, AVARDAMAGE_ENTIRE);
@@ -43,6 +44,7 @@ PHLWINDOW CWindow::create(SP<CXDGSurfaceResource> resource) {
 
     pWindow->m_pSelf           = pWindow;
     resource->toplevel->window = pWindow;
+    pWindow->m_iStackOrder     = ++g_pCompositor->m_iTopStackOrder; // new windows go on top
 
     pWindow->m_vRealPosition.create(g_pConfigManager->getAnimationPropertyConfig("windowsIn"), pWindow, AVARDAMAGE_ENTIRE);
     pWindow->m_vRealSize.create(g_pConfigManager->getAnimationPropertyConfig("windowsIn"), pWindow, AVARDAMAGE_ENTIRE);
@@ -516,6 +518,12 @@ void CWindow::onUnmap() {
 
     std::erase_if(g_pCompositor->m_vWindowFocusHistory, [&](const auto& other) { return other.expired() || other.lock().get() == this; });
 
+    // the ones after it moved up
+    for (auto const& w : g_pCompositor->m_vWindowFocusHistory) {
+        if (const auto PWINDOW = w.lock())
+            PWINDOW->markStateChanged();
+    }
+
     if (*PCLOSEONLASTSPECIAL && g_pCompositor->getWindowsOnWorkspace(workspaceID()) == 0 && onSpecialWorkspace()) {
         const auto PMONITOR = m_pMonitor.lock();
         if (PMONITOR && PMONITOR->activeSpecialWorkspace && PMONITOR->activeSpecialWorkspace == m_pWorkspace)
@@ -569,6 +577,7 @@ void CWindow::onMap() {
     m_fBorderAngleAnimationProgress = 1.f;
 
     g_pCompositor->m_vWindowFocusHistory.push_back(m_pSelf);
+    markStateChanged();
 
     m_vReportedSize = m_vPendingReportedSize;
     m_bAnimatingIn  = true;
@@ -618,9 +627,10 @@ void CWindow::applyDynamicRule(const SWindowRule& r) {
     if (r.szRule.starts_with("tag")) {
         CVarList vars{r.szRule, 0, 's', true};
 
-        if (vars.size() == 2 && vars[0] == "tag")
+        if (vars.size() == 2 && vars[0] == "tag") {
             m_tags.applyTag(vars[1], true);
-        else
+            markStateChanged();
+        } else
             Debug::log(ERR, "Tag rule invalid: {}", r.szRule);
     } else if (r.szRule.starts_with("opacity")) {
         try {
@@ -782,6 +792,7 @@ void CWindow::updateDynamicRules() {
     m_eIdleInhibitMode = IDLEINHIBIT_NONE;
 
     m_tags.removeDynamicTags();
+    markStateChanged();
 
     m_vMatchedRules = g_pConfigManager->getMatchingRules(m_pSelf.lock());
     for (auto const& r : m_vMatchedRules) {
@@ -791,6 +802,9 @@ void CWindow::updateDynamicRules() {
     EMIT_HOOK_EVENT("windowUpdateRules", m_pSelf.lock());
 
     g_pLayoutManager->getCurrentLayout()->recalculateMonitor(monitorID());
+
+    // dimaround may have changed
+    g_pCompositor->updateWindowHitIndex(m_pSelf.lock());
 }
 
 // check if the point is "hidden" under a rounded corner of the window
@@ -853,6 +867,8 @@ void CWindow::createGroup() {
         m_sGroupData.locked      = false;
         m_sGroupData.deny        = false;
 
+        markGroupStateChanged();
+
         addWindowDeco(std::make_unique<CHyprGroupBarDecoration>(m_pSelf.lock()));
 
         g_pCompositor->updateWorkspaceWindows(workspaceID());
@@ -872,6 +888,7 @@ void CWindow::destroyGroup() {
         }
         m_sGroupData.pNextWindow.reset();
         m_sGroupData.head = false;
+        markStateChanged();
         updateWindowDecos();
         g_pCompositor->updateWorkspaceWindows(workspaceID());
         g_pCompositor->updateWorkspaceWindowData(workspaceID());
@@ -899,6 +916,7 @@ void CWindow::destroyGroup() {
         if (w->m_sGroupData.head)
             g_pLayoutManager->getCurrentLayout()->onWindowRemoved(curr);
         w->m_sGroupData.head = false;
+        w->markStateChanged();
     }
 
     const bool GROUPSLOCKEDPREV        = g_pKeybindManager->m_bGroupsLocked;
@@ -1035,6 +1053,7 @@ void CWindow::insertWindowToGroup(PHLWINDOW pWindow) {
         BEGINAT->m_sGroupData.pNextWindow = pWindow;
         pWindow->m_sGroupData.pNextWindow = ENDAT;
         pWindow->m_sGroupData.head        = false;
+        markGroupStateChanged();
         return;
     }
 
@@ -1044,6 +1063,8 @@ void CWindow::insertWindowToGroup(PHLWINDOW pWindow) {
     SHEAD->m_sGroupData.head          = false;
     BEGINAT->m_sGroupData.pNextWindow = SHEAD;
     STAIL->m_sGroupData.pNextWindow   = ENDAT;
+
+    markGroupStateChanged();
 }
 
 PHLWINDOW CWindow::getGroupPrevious() {
@@ -1076,6 +1097,27 @@ void CWindow::switchWithWindowInGroup(PHLWINDOW pWindow) {
 
     std::swap(m_sGroupData.head, pWindow->m_sGroupData.head);
     std::swap(m_sGroupData.locked, pWindow->m_sGroupData.locked);
+
+    // they can be in different groups
+    markGroupStateChanged();
+    pWindow->markGroupStateChanged();
+}
+
+uint64_t CWindow::nextStateGeneration() {
+    static uint64_t generation = 0;
+    return ++generation;
+}
+
+void CWindow::markStateChanged() {
+    m_iStateGeneration = nextStateGeneration();
+}
+
+void CWindow::markGroupStateChanged() {
+    markStateChanged();
+
+    for (auto curr = m_sGroupData.pNextWindow.lock(); curr && curr.get() != this; curr = curr->m_sGroupData.pNextWindow.lock()) {
+        curr->markStateChanged();
+    }
 }
 
 void CWindow::updateGroupOutputs() {
@@ -1290,39 +1332,7 @@ std::unordered_map<std::string, std::string> CWindow::getEnv() {
     if (PID <= 1)
         return {};
 
-    std::unordered_map<std::string, std::string> results;
-
-    //
-    std::string   environFile = "/proc/" + std::to_string(PID) + "/environ";
-    std::ifstream ifs(environFile, std::ios::binary);
-
-    if (!ifs.good())
-        return {};
-
-    std::vector<char> buffer;
-    size_t            needle = 0;
-    buffer.resize(512, '\0');
-    while (ifs.read(buffer.data() + needle, 512)) {
-        buffer.resize(buffer.size() + 512, '\0');
-        needle += 512;
-    }
-
-    if (needle <= 1)
-        return {};
-
-    std::replace(buffer.begin(), buffer.end() - 1, '\0', '\n');
-
-    CVarList envs(std::string{buffer.data(), buffer.size() - 1}, 0, '\n', true);
-
-    for (auto const& e : envs) {
-        if (!e.contains('='))
-            continue;
-
-        const auto EQ            = e.find_first_of('=');
-        results[e.substr(0, EQ)] = e.substr(EQ + 1);
-    }
-
-    return results;
+    return g_pProcessManager->getEnv(PID);
 }
 
 void CWindow::activate(bool force) {
@@ -1377,6 +1387,7 @@ void CWindow::onUpdateMeta() {
 
     if (m_szTitle != NEWTITLE) {
         m_szTitle = NEWTITLE;
+        markStateChanged();
         g_pEventManager->postEvent(SHyprIPCEvent{"windowtitle", std::format("{:x}", (uintptr_t)this)});
         g_pEventManager->postEvent(SHyprIPCEvent{"windowtitlev2", std::format("{:x},{}", (uintptr_t)this, m_szTitle)});
         EMIT_HOOK_EVENT("windowTitle", m_pSelf.lock());
@@ -1394,6 +1405,7 @@ void CWindow::onUpdateMeta() {
     const auto NEWCLASS = fetchClass();
     if (m_szClass != NEWCLASS) {
         m_szClass = NEWCLASS;
+        markStateChanged();
 
         if (m_pSelf == g_pCompositor->m_pLastWindow) { // if it's the active, let's post an event to update others
             g_pEventManager->postEvent(SHyprIPCEvent{"activewindow", m_szClass + "," + m_szTitle});
@@ -1437,13 +1449,31 @@ std::string CWindow::fetchClass() {
 }
 
 void CWindow::onAck(uint32_t serial) {
-    const auto SERIAL = std::find_if(m_vPendingSizeAcks.rbegin(), m_vPendingSizeAcks.rend(), [serial](const auto& e) { return e.first == serial; });
+    // acking a configure acks the ones before it, clients may skip to the newest one
+    const auto SERIAL = std::find_if(m_vPendingSizeAcks.rbegin(), m_vPendingSizeAcks.rend(), [serial](const auto& e) { return e.first <= serial; });
 
     if (SERIAL == m_vPendingSizeAcks.rend())
         return;
 
     m_pPendingSizeAck = *SERIAL;
-    std::erase_if(m_vPendingSizeAcks, [&](const auto& el) { return el.first <= SERIAL->first; });
+    std::erase_if(m_vPendingSizeAcks, [this](const auto& el) { return el.first <= m_pPendingSizeAck->first; });
+
+    if (!m_vPendingSizeAcks.empty())
+        return;
+
+    const auto LATENCY  = m_tConfigureSent.getMillis();
+    m_fConfigureLatency = m_fConfigureLatency == 0.f ? LATENCY : m_fConfigureLatency * 0.8f + LATENCY * 0.2f;
+
+    if (m_vQueuedSize)
+        g_pXWaylandManager->setWindowSize(m_pSelf.lock(), *m_vQueuedSize);
+}
+
+bool CWindow::configureInFlight() {
+    if (m_vPendingSizeAcks.empty())
+        return false;
+
+    // a client that doesn't ack at all shouldn't be stuck with an old size
+    return m_tConfigureSent.getMillis() < std::clamp(m_fConfigureLatency * 4.f, 50.f, 1000.f);
 }
 
 void CWindow::onResourceChangeX11() {
@@ -1535,6 +1565,10 @@ PHLWINDOW CWindow::getSwallower() {
     static auto PSWALLOWEXREGEX = CConfigValue<std::string>("misc:swallow_exception_regex");
     static auto PSWALLOW        = CConfigValue<Hyprlang::INT>("misc:enable_swallow");
 
+    // compiled once per value
+    static std::string swallowRegexStr, swallowExRegexStr;
+    static std::regex  swallowRegex, swallowExRegex;
+
     if (!*PSWALLOW || std::string{*PSWALLOWREGEX} == STRVAL_EMPTY || (*PSWALLOWREGEX).empty())
         return nullptr;
 
@@ -1543,28 +1577,37 @@ PHLWINDOW CWindow::getSwallower() {
     pid_t                  currentPid = getPID();
     // walk up the tree until we find someone, 25 iterations max.
     for (size_t i = 0; i < 25; ++i) {
-        currentPid = getPPIDof(currentPid);
+        currentPid = g_pProcessManager->getPPID(currentPid);
 
         if (!currentPid)
             break;
 
-        for (auto const& w : g_pCompositor->m_vWindows) {
-            if (!w->m_bIsMapped || w->isHidden())
-                continue;
-
-            if (w->getPID() == currentPid)
+        for (auto const& w : g_pProcessManager->getWindows(currentPid)) {
+            if (!w->isHidden())
                 candidates.push_back(w);
         }
     }
 
-    if (!(*PSWALLOWREGEX).empty())
-        std::erase_if(candidates, [&](const auto& other) { return !std::regex_match(other->m_szClass, std::regex(*PSWALLOWREGEX)); });
+    if (!(*PSWALLOWREGEX).empty()) {
+        if (swallowRegexStr != *PSWALLOWREGEX) {
+            swallowRegex    = std::regex(*PSWALLOWREGEX);
+            swallowRegexStr = *PSWALLOWREGEX;
+        }
+
+        std::erase_if(candidates, [&](const auto& other) { return !std::regex_match(other->m_szClass, swallowRegex); });
+    }
 
     if (candidates.size() <= 0)
         return nullptr;
 
-    if (!(*PSWALLOWEXREGEX).empty())
-        std::erase_if(candidates, [&](const auto& other) { return std::regex_match(other->m_szTitle, std::regex(*PSWALLOWEXREGEX)); });
+    if (!(*PSWALLOWEXREGEX).empty()) {
+        if (swallowExRegexStr != *PSWALLOWEXREGEX) {
+            swallowExRegex    = std::regex(*PSWALLOWEXREGEX);
+            swallowExRegexStr = *PSWALLOWEXREGEX;
+        }
+
+        std::erase_if(candidates, [&](const auto& other) { return std::regex_match(other->m_szTitle, swallowExRegex); });
+    }
 
     if (candidates.size() <= 0)
         return nullptr;
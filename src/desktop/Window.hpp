@@ -9,6 +9,7 @@
 #include "../helpers/math/Math.hpp"
 #include "../helpers/signal/Signal.hpp"
 #include "../helpers/TagKeeper.hpp"
+#include "../helpers/Timer.hpp"
 #include "../macros.hpp"
 #include "../managers/XWaylandManager.hpp"
 #include "../render/decorations/IHyprWindowDecoration.hpp"
@@ -214,6 +215,13 @@ struct SWindowRule {
     std::string szWorkspace       = ""; // empty means any
 };
 
+// which window rules' class / title patterns matched, see CWindowRuleMatcher
+struct SWindowRuleMatchCache {
+    uint64_t            generation = 0;
+    std::string         szClass, szTitle, szInitialClass, szInitialTitle;
+    std::vector<size_t> candidates;
+};
+
 struct SInitialWorkspaceToken {
     PHLWINDOWREF primaryOwner;
     std::string  workspace;
@@ -260,6 +268,11 @@ class CWindow {
     std::optional<std::pair<uint32_t, Vector2D>> m_pPendingSizeAck;
     std::vector<std::pair<uint32_t, Vector2D>>   m_vPendingSizeAcks;
 
+    // configure throttling, see CHyprXWaylandManager::setWindowSize
+    std::optional<Vector2D> m_vQueuedSize;             // the newest size, waiting for the client to ack the one in flight
+    CTimer                  m_tConfigureSent;          // since the last size was sent
+    float                   m_fConfigureLatency = 0.f; // ms from a size to its ack, averaged
+
     // for restoring floating statuses
     Vector2D m_vLastFloatingSize;
     Vector2D m_vLastFloatingPosition;
@@ -293,6 +306,9 @@ class CWindow {
     // This is for fullscreen apps
     bool m_bCreatedOverFullscreen = false;
 
+    // sorts like g_pCompositor->m_vWindows (bottom to top), without having to find the window in it
+    int64_t m_iStackOrder = 0;
+
     // XWayland stuff
     bool         m_bIsX11 = false;
     PHLWINDOWREF m_pX11Parent;
@@ -392,10 +408,15 @@ class CWindow {
 
     // stores the currently matched window rules
     std::vector<SWindowRule> m_vMatchedRules;
+    SWindowRuleMatchCache    m_sRuleMatchCache;
 
     // window tags
     CTagKeeper m_tags;
 
+    // changes when its title, class, tags, group, focus history index or workspace name do, see markStateChanged.
+    // hyprctl rebuilds a window's listing when this or one of its plain fields changes, see CHyprCtl
+    uint64_t m_iStateGeneration = nextStateGeneration();
+
     // For the list lookup
     bool operator==(const CWindow& rhs) {
         return m_pXDGSurface == rhs.m_pXDGSurface && m_pXWaylandSurface == rhs.m_pXWaylandSurface && m_vPosition == rhs.m_vPosition && m_vSize == rhs.m_vSize &&
@@ -468,6 +489,8 @@ class CWindow {
     void                   insertWindowToGroup(PHLWINDOW pWindow);
     void                   updateGroupOutputs();
     void                   switchWithWindowInGroup(PHLWINDOW pWindow);
+    void                   markStateChanged();
+    void                   markGroupStateChanged(); // for this window and everything grouped with it, after the group changed
     void                   setAnimationsToMove();
     void                   onWorkspaceAnimUpdate();
     void                   onUpdateState();
@@ -481,6 +504,7 @@ class CWindow {
     void                   unsetWindowData(eOverridePriority priority);
     bool                   isX11OverrideRedirect();
     bool                   isModal();
+    bool                   configureInFlight(); // if a size waits for an ack, and the client isn't taking too long with it
 
     // listeners
     void onAck(uint32_t serial);
@@ -511,6 +535,9 @@ class CWindow {
     bool        m_bHidden        = false;
     bool        m_bSuspended     = false;
     WORKSPACEID m_iLastWorkspace = WORKSPACE_INVALID;
+
+    // shared by all windows, so a new window at a freed one's address never matches its old listing
+    static uint64_t nextStateGeneration();
 };
 
 inline bool valid(PHLWINDOW w) {
@@ -0,0 +1,120 @@
+#include "WindowHitIndex.hpp"
+#include "Window.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+constexpr double  HIT_INDEX_CELL_SIZE = 256;
+constexpr int64_t HIT_INDEX_MAX_CELLS = 1024; // per window, bigger windows are candidates everywhere
+
+uint64_t CWindowHitIndex::cellKey(int64_t x, int64_t y) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+void CWindowHitIndex::addBox(const CBox& box, CWindow* pWindow, SEntry& entry) {
+    if (!std::isfinite(box.x) || !std::isfinite(box.y) || !std::isfinite(box.width) || !std::isfinite(box.height)) {
+        entry.always = true;
+        return;
+    }
+
+    const int64_t X1 = std::floor(box.x / HIT_INDEX_CELL_SIZE), Y1 = std::floor(box.y / HIT_INDEX_CELL_SIZE);
+    const int64_t X2 = std::floor((box.x + box.width) / HIT_INDEX_CELL_SIZE), Y2 = std::floor((box.y + box.height) / HIT_INDEX_CELL_SIZE);
+
+    if ((X2 - X1 + 1) * (Y2 - Y1 + 1) > HIT_INDEX_MAX_CELLS) {
+        entry.always = true;
+        return;
+    }
+
+    for (int64_t x = X1; x <= X2; ++x) {
+        for (int64_t y = Y1; y <= Y2; ++y) {
+            const auto KEY  = cellKey(x, y);
+            auto&      cell = m_mCells[KEY];
+
+            // a window can cover a cell twice (window box and layout box)
+            if (!cell.empty() && cell.back() == pWindow)
+                continue;
+
+            cell.push_back(pWindow);
+            entry.cells.push_back(KEY);
+        }
+    }
+}
+
+void CWindowHitIndex::insert(PHLWINDOW pWindow, const std::vector<CBox>& boxes, bool always) {
+    remove(pWindow.get());
+
+    auto& entry  = m_mEntries[pWindow.get()];
+    entry.window = pWindow;
+    entry.always = always;
+
+    for (auto const& b : boxes) {
+        if (entry.always)
+            break;
+
+        addBox(b, pWindow.get(), entry);
+    }
+
+    if (!entry.always)
+        return;
+
+    // too big or unbounded after all, don't keep its cells around
+    for (auto const& key : entry.cells) {
+        auto& cell = m_mCells[key];
+        std::erase(cell, pWindow.get());
+        if (cell.empty())
+            m_mCells.erase(key);
+    }
+    entry.cells.clear();
+
+    m_vAlways.push_back(pWindow.get());
+}
+
+void CWindowHitIndex::remove(CWindow* pWindow) {
+    const auto IT = m_mEntries.find(pWindow);
+    if (IT == m_mEntries.end())
+        return;
+
+    for (auto const& key : IT->second.cells) {
+        const auto CELL = m_mCells.find(key);
+        if (CELL == m_mCells.end())
+            continue;
+
+        std::erase(CELL->second, pWindow);
+        if (CELL->second.empty())
+            m_mCells.erase(CELL);
+    }
+
+    if (IT->second.always)
+        std::erase(m_vAlways, pWindow);
+
+    m_mEntries.erase(IT);
+}
+
+void CWindowHitIndex::clear() {
+    m_mEntries.clear();
+    m_mCells.clear();
+    m_vAlways.clear();
+}
+
+void CWindowHitIndex::collect(const Vector2D& pos, std::vector<PHLWINDOW>& out) const {
+    auto add = [&](CWindow* pWindow) {
+        const auto IT = m_mEntries.find(pWindow);
+        if (IT == m_mEntries.end())
+            return;
+
+        if (const auto PWINDOW = IT->second.window.lock())
+            out.emplace_back(PWINDOW);
+    };
+
+    for (auto const& w : m_vAlways) {
+        add(w);
+    }
+
+    const auto IT = m_mCells.find(cellKey((int64_t)std::floor(pos.x / HIT_INDEX_CELL_SIZE), (int64_t)std::floor(pos.y / HIT_INDEX_CELL_SIZE)));
+    if (IT == m_mCells.end())
+        return;
+
+    for (auto const& w : IT->second) {
+        add(w);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "DesktopTypes.hpp"
+#include "../helpers/math/Math.hpp"
+
+class CWindow;
+
+/*
+    Per-monitor grid over layout coordinates with the conservative input boxes of the windows
+    that can be hit on that monitor (window box + all decoration extents + border grab area, and the layout box).
+    Hit testing only needs to look at the windows collect() returns.
+
+    Entries are replaced one window at a time by CCompositor::updateWindowHitIndex, nothing here
+    looks at windows that didn't change.
+*/
+class CWindowHitIndex {
+  public:
+    // replaces the window's entry. With always set, it can be hit anywhere on this monitor and boxes are ignored.
+    void insert(PHLWINDOW pWindow, const std::vector<CBox>& boxes, bool always);
+    void remove(CWindow* pWindow);
+    void clear();
+
+    // appends the windows that may be hit at pos, in no particular order
+    void collect(const Vector2D& pos, std::vector<PHLWINDOW>& out) const;
+
+  private:
+    struct SEntry {
+        PHLWINDOWREF          window;
+        std::vector<uint64_t> cells;
+        bool                  always = false;
+    };
+
+    static uint64_t                                      cellKey(int64_t x, int64_t y);
+
+    void                                                 addBox(const CBox& box, CWindow* pWindow, SEntry& entry);
+
+    std::unordered_map<CWindow*, SEntry>                 m_mEntries;
+    std::unordered_map<uint64_t, std::vector<CWindow*>> m_mCells;
+    std::vector<CWindow*>                                m_vAlways;
+};
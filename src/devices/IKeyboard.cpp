@@ -4,7 +4,7 @@
 #include "../managers/input/InputManager.hpp"
 #include "../managers/SeatManager.hpp"
 #include "../config/ConfigManager.hpp"
-#include <sys/mman.h>
+#include "../managers/KeymapCache.hpp"
 #include <aquamarine/input/Input.hpp>
 #include <cstring>
 
@@ -41,8 +41,7 @@ void IKeyboard::clearManuallyAllocd() {
     if (xkbKeymap)
         xkb_keymap_unref(xkbKeymap);
 
-    if (xkbKeymapFD >= 0)
-        close(xkbKeymapFD);
+    sharedKeymap.reset();
 
     xkbKeymap      = nullptr;
     xkbState       = nullptr;
@@ -65,33 +64,19 @@ void IKeyboard::setKeymap(const SStringRuleNames& rules) {
         .options = rules.options.c_str(),
     };
 
-    const auto CONTEXT = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-
-    if (!CONTEXT) {
-        Debug::log(ERR, "setKeymap: CONTEXT null??");
-        return;
-    }
-
     clearManuallyAllocd();
 
     Debug::log(LOG, "Attempting to create a keymap for layout {} with variant {} (rules: {}, model: {}, options: {})", rules.layout, rules.variant, rules.rules, rules.model,
                rules.options);
 
-    if (!xkbFilePath.empty()) {
-        auto path = absolutePath(xkbFilePath, g_pConfigManager->configCurrentPath);
-
-        if (FILE* const KEYMAPFILE = fopen(path.c_str(), "r"); !KEYMAPFILE)
-            Debug::log(ERR, "Cannot open input:kb_file= file for reading");
-        else {
-            xkbKeymap = xkb_keymap_new_from_file(CONTEXT, KEYMAPFILE, XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
-            fclose(KEYMAPFILE);
-        }
-    }
+    // compiled once for all keyboards with the same rules or file
+    if (!xkbFilePath.empty())
+        sharedKeymap = g_pKeymapCache->fromFile(absolutePath(xkbFilePath, g_pConfigManager->configCurrentPath));
 
-    if (!xkbKeymap)
-        xkbKeymap = xkb_keymap_new_from_names(CONTEXT, &XKBRULES, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (!sharedKeymap)
+        sharedKeymap = g_pKeymapCache->fromNames(XKBRULES);
 
-    if (!xkbKeymap) {
+    if (!sharedKeymap) {
         g_pConfigManager->addParseError("Invalid keyboard layout passed. ( rules: " + rules.rules + ", model: " + rules.model + ", variant: " + rules.variant +
                                         ", options: " + rules.options + ", layout: " + rules.layout + " )");
 
@@ -105,9 +90,11 @@ void IKeyboard::setKeymap(const SStringRuleNames& rules) {
         currentRules.options = "";
         currentRules.layout  = "us";
 
-        xkbKeymap = xkb_keymap_new_from_names(CONTEXT, &XKBRULES, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        sharedKeymap = g_pKeymapCache->fromNames(XKBRULES);
     }
 
+    xkbKeymap = sharedKeymap ? xkb_keymap_ref(sharedKeymap->keymap()) : nullptr;
+
     updateXKBTranslationState(xkbKeymap);
 
     const auto NUMLOCKON = g_pConfigManager->getDeviceInt(hlName, "numlock_by_default", "input:numlock_by_default");
@@ -135,38 +122,25 @@ void IKeyboard::setKeymap(const SStringRuleNames& rules) {
 
     updateKeymapFD();
 
-    xkb_context_unref(CONTEXT);
-
     g_pSeatManager->updateActiveKeyboardData();
 }
 
 void IKeyboard::updateKeymapFD() {
     Debug::log(LOG, "Updating keymap fd for keyboard {}", deviceName);
 
-    if (xkbKeymapFD >= 0)
-        close(xkbKeymapFD);
     xkbKeymapFD = -1;
 
-    auto cKeymapStr = xkb_keymap_get_as_string(xkbKeymap, XKB_KEYMAP_FORMAT_TEXT_V1);
-    xkbKeymapString = cKeymapStr;
-    free(cKeymapStr);
-
-    int rw, ro;
-    if (!allocateSHMFilePair(xkbKeymapString.length() + 1, &rw, &ro))
-        Debug::log(ERR, "IKeyboard: failed to allocate shm pair for the keymap");
-    else {
-        auto keymapFDDest = mmap(nullptr, xkbKeymapString.length() + 1, PROT_READ | PROT_WRITE, MAP_SHARED, rw, 0);
-        close(rw);
-        if (keymapFDDest == MAP_FAILED) {
-            Debug::log(ERR, "IKeyboard: failed to mmap a shm pair for the keymap");
-            close(ro);
-        } else {
-            memcpy(keymapFDDest, xkbKeymapString.c_str(), xkbKeymapString.length());
-            munmap(keymapFDDest, xkbKeymapString.length() + 1);
-            xkbKeymapFD = ro;
-        }
+    if (!xkbKeymap) {
+        sharedKeymap.reset();
+        xkbKeymapString = "";
+        return;
     }
 
+    // shared with every keyboard with the same keymap, it's serialized once
+    sharedKeymap    = g_pKeymapCache->fromKeymap(xkbKeymap);
+    xkbKeymapString = sharedKeymap->string();
+    xkbKeymapFD     = sharedKeymap->fd();
+
     Debug::log(LOG, "Updated keymap fd to {}", xkbKeymapFD);
 }
 
@@ -197,8 +171,6 @@ void IKeyboard::updateXKBTranslationState(xkb_keymap* const keymap) {
     const auto STATE      = xkbState;
     const auto LAYOUTSNUM = xkb_keymap_num_layouts(KEYMAP);
 
-    const auto PCONTEXT = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-
     for (uint32_t i = 0; i < LAYOUTSNUM; ++i) {
         if (xkb_state_layout_index_is_active(STATE, i, XKB_STATE_LAYOUT_EFFECTIVE) == 1) {
             Debug::log(LOG, "Updating keyboard {:x}'s translation state from an active index {}", (uintptr_t)this, i);
@@ -218,27 +190,29 @@ void IKeyboard::updateXKBTranslationState(xkb_keymap* const keymap) {
             rules.model   = model.c_str();
             rules.variant = variant.c_str();
 
-            auto KEYMAP = xkb_keymap_new_from_names(PCONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
+            auto KEYMAP = g_pKeymapCache->fromNames(rules);
 
             if (!KEYMAP) {
                 Debug::log(ERR, "updateXKBTranslationState: keymap failed 1, fallback without model/variant");
                 rules.model   = "";
                 rules.variant = "";
-                KEYMAP        = xkb_keymap_new_from_names(PCONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
+                KEYMAP        = g_pKeymapCache->fromNames(rules);
             }
 
             if (!KEYMAP) {
                 Debug::log(ERR, "updateXKBTranslationState: keymap failed 2, fallback to us");
                 rules.layout = "us";
-                KEYMAP       = xkb_keymap_new_from_names(PCONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
+                KEYMAP       = g_pKeymapCache->fromNames(rules);
             }
 
-            xkbState       = xkb_state_new(KEYMAP);
-            xkbStaticState = xkb_state_new(KEYMAP);
-            xkbSymState    = xkb_state_new(KEYMAP);
+            if (!KEYMAP) {
+                Debug::log(ERR, "updateXKBTranslationState: keymap failed 3, no translation state");
+                return;
+            }
 
-            xkb_keymap_unref(KEYMAP);
-            xkb_context_unref(PCONTEXT);
+            xkbState       = xkb_state_new(KEYMAP->keymap());
+            xkbStaticState = xkb_state_new(KEYMAP->keymap());
+            xkbSymState    = xkb_state_new(KEYMAP->keymap());
 
             return;
         }
@@ -254,14 +228,16 @@ void IKeyboard::updateXKBTranslationState(xkb_keymap* const keymap) {
         .options = currentRules.options.c_str(),
     };
 
-    const auto NEWKEYMAP = xkb_keymap_new_from_names(PCONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    const auto NEWKEYMAP = g_pKeymapCache->fromNames(rules);
 
-    xkbState       = xkb_state_new(NEWKEYMAP);
-    xkbStaticState = xkb_state_new(NEWKEYMAP);
-    xkbSymState    = xkb_state_new(NEWKEYMAP);
+    if (!NEWKEYMAP) {
+        Debug::log(ERR, "updateXKBTranslationState: keymap failed, no translation state");
+        return;
+    }
 
-    xkb_keymap_unref(NEWKEYMAP);
-    xkb_context_unref(PCONTEXT);
+    xkbState       = xkb_state_new(NEWKEYMAP->keymap());
+    xkbStaticState = xkb_state_new(NEWKEYMAP->keymap());
+    xkbSymState    = xkb_state_new(NEWKEYMAP->keymap());
 }
 
 std::string IKeyboard::getActiveLayout() {
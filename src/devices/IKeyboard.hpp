@@ -9,6 +9,8 @@
 
 AQUAMARINE_FORWARD(IKeyboard);
 
+class CKeymap;
+
 enum eKeyboardModifiers {
     HL_MODIFIER_SHIFT = (1 << 0),
     HL_MODIFIER_CAPS  = (1 << 1),
@@ -96,7 +98,8 @@ class IKeyboard : public IHID {
 
     std::string                    xkbFilePath     = "";
     std::string                    xkbKeymapString = "";
-    int                            xkbKeymapFD     = -1;
+    int                            xkbKeymapFD     = -1; // owned by sharedKeymap
+    SP<CKeymap>                    sharedKeymap;
 
     SStringRuleNames               currentRules;
     int                            repeatRate        = 0;
@@ -607,6 +607,8 @@ void Events::listener_mapWindow(void* owner, void* data) {
 
     if (PMONITOR && PWINDOW->isX11OverrideRedirect())
         PWINDOW->m_fX11SurfaceScaledBy = PMONITOR->scale;
+
+    g_pCompositor->updateWindowHitIndex(PWINDOW);
 }
 
 void Events::listener_unmapWindow(void* owner, void* data) {
@@ -681,6 +683,7 @@ void Events::listener_unmapWindow(void* owner, void* data) {
 
     // do this after onWindowRemoved because otherwise it'll think the window is invalid
     PWINDOW->m_bIsMapped = false;
+    g_pCompositor->updateWindowHitIndex(PWINDOW);
 
     // refocus on a new window if needed
     if (wasLastWindow) {
@@ -752,6 +755,10 @@ void Events::listener_commitWindow(void* owner, void* data) {
 
     PWINDOW->m_vReportedSize = PWINDOW->m_vPendingReportedSize; // apply pending size. We pinged, the window ponged.
 
+    // the client didn't ack the size in flight in time, see CWindow::configureInFlight
+    if (PWINDOW->m_vQueuedSize && !PWINDOW->configureInFlight())
+        g_pXWaylandManager->setWindowSize(PWINDOW, *PWINDOW->m_vQueuedSize);
+
     if (!PWINDOW->m_bIsX11 && !PWINDOW->isFullscreen() && PWINDOW->m_bIsFloating) {
         const auto MINSIZE = PWINDOW->m_pXDGSurface->toplevel->current.minSize;
         const auto MAXSIZE = PWINDOW->m_pXDGSurface->toplevel->current.maxSize;
@@ -1,6 +1,7 @@
 #include "AnimatedVariable.hpp"
 #include "../managers/AnimationManager.hpp"
 #include "../config/ConfigManager.hpp"
+#include "../Compositor.hpp"
 
 CBaseAnimatedVariable::CBaseAnimatedVariable(ANIMATEDVARTYPE type) : m_Type(type) {
     ; // dummy var
@@ -74,19 +75,39 @@ float CBaseAnimatedVariable::getCurveValue() {
     if (SPENT >= 1.f)
         return 1.f;
 
-    return g_pAnimationManager->getBezier(m_pConfig->pValues->internalBezier)->getYForPoint(SPENT);
+    return g_pAnimationManager->getBezierHandle(m_pConfig->pValues)->getYForPoint(SPENT);
+}
+
+void CBaseAnimatedVariable::setConfig(SAnimationPropertyConfig* pConfig) {
+    m_pConfig = pConfig;
+
+    // the active list keeps its own copy
+    if (m_bIsConnectedToActive)
+        g_pAnimationManager->activateVariable(this);
 }
 
 void CBaseAnimatedVariable::connectToActive() {
     g_pAnimationManager->scheduleTick(); // otherwise the animation manager will never pick this up
 
-    if (!m_bIsConnectedToActive)
-        g_pAnimationManager->m_vActiveAnimatedVariables.push_back(this);
+    // adds this, or updates the begin / goal of an already running animation
+    g_pAnimationManager->activateVariable(this);
 
     m_bIsConnectedToActive = true;
 }
 
 void CBaseAnimatedVariable::disconnectFromActive() {
-    std::erase_if(g_pAnimationManager->m_vActiveAnimatedVariables, [&](const auto& other) { return other == this; });
+    if (!m_bIsConnectedToActive)
+        return;
+
+    g_pAnimationManager->deactivateVariable(this);
     m_bIsConnectedToActive = false;
 }
+
+void CBaseAnimatedVariable::updateWindowHitIndex() {
+    // only a window's position and size move its input box
+    if (m_Type != AVARTYPE_VECTOR || m_eDamagePolicy != AVARDAMAGE_ENTIRE || !g_pCompositor)
+        return;
+
+    if (const auto PWINDOW = m_pWindow.lock(); PWINDOW)
+        g_pCompositor->updateWindowHitIndex(PWINDOW);
+}
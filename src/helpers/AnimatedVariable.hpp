@@ -65,6 +65,9 @@ concept OneOf = (... or std::same_as<T, U>);
 template <class T>
 concept Animable = OneOf<T, Vector2D, float, CColor>;
 
+template <Animable T>
+struct SActiveAnimations;
+
 class CBaseAnimatedVariable {
   public:
     CBaseAnimatedVariable(ANIMATEDVARTYPE type);
@@ -86,9 +89,7 @@ class CBaseAnimatedVariable {
     virtual void warp(bool endCallback = true) = 0;
 
     //
-    void setConfig(SAnimationPropertyConfig* pConfig) {
-        m_pConfig = pConfig;
-    }
+    void setConfig(SAnimationPropertyConfig* pConfig);
 
     SAnimationPropertyConfig* getConfig() {
         return m_pConfig;
@@ -167,15 +168,19 @@ class CBaseAnimatedVariable {
     std::function<void(void* thisptr)>    m_fUpdateCallback;
 
     bool                                  m_bIsConnectedToActive = false;
+    size_t                                m_iActiveSlot          = 0; // in the animation manager's active list for this type
 
     void                                  connectToActive();
 
     void                                  disconnectFromActive();
 
+    void                                  updateWindowHitIndex();
+
     // methods
     void onAnimationEnd() {
         m_bIsBeingAnimated = false;
         disconnectFromActive();
+        updateWindowHitIndex();
 
         if (m_fEndCallback) {
             // loading m_bRemoveEndAfterRan before calling the callback allows the callback to delete this animation safely if it is false.
@@ -189,6 +194,7 @@ class CBaseAnimatedVariable {
     void onAnimationBegin() {
         m_bIsBeingAnimated = true;
         connectToActive();
+        updateWindowHitIndex();
 
         if (m_fBeginCallback) {
             m_fBeginCallback(this);
@@ -198,6 +204,8 @@ class CBaseAnimatedVariable {
     }
 
     friend class CAnimationManager;
+    template <Animable T>
+    friend struct SActiveAnimations;
     friend class CWorkspace;
     friend class CLayerSurface;
     friend class CHyprRenderer;
@@ -303,6 +311,8 @@ class CAnimatedVariable : public CBaseAnimatedVariable {
     // owners
 
     friend class CAnimationManager;
+    template <Animable T>
+    friend struct SActiveAnimations;
     friend class CWorkspace;
     friend class CLayerSurface;
     friend class CHyprRenderer;
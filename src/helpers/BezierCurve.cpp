@@ -4,6 +4,7 @@
 
 #include <chrono>
 #include <algorithm>
+#include <cmath>
 
 void CBezierCurve::setup(std::vector<Vector2D>* pVec) {
     m_dPoints.clear();
@@ -20,14 +21,19 @@ void CBezierCurve::setup(std::vector<Vector2D>* pVec) {
 
     RASSERT(m_dPoints.size() == 4, "CBezierCurve only supports cubic beziers! (points num: {})", m_dPoints.size());
 
-    // bake BAKEDPOINTS points for faster lookups
-    // T -> X ( / BAKEDPOINTS )
-    for (int i = 0; i < BAKEDPOINTS; ++i) {
-        m_aPointsBaked[i] = Vector2D(getXForT((i + 1) / (float)BAKEDPOINTS), getYForT((i + 1) / (float)BAKEDPOINTS));
+    m_fCX = 3.f * m_dPoints[1].x;
+    m_fBX = 3.f * (m_dPoints[2].x - m_dPoints[1].x) - m_fCX;
+    m_fAX = 1.f - m_fCX - m_fBX;
+
+    m_fCY = 3.f * m_dPoints[1].y;
+    m_fBY = 3.f * (m_dPoints[2].y - m_dPoints[1].y) - m_fCY;
+    m_fAY = 1.f - m_fCY - m_fBY;
+
+    for (int i = 0; i < BEZIER_SAMPLES; ++i) {
+        m_aSamplesX[i] = sampleX(i * BEZIER_SAMPLE_STEP);
     }
 
-    const auto ELAPSEDUS  = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - BEGIN).count() / 1000.f;
-    const auto POINTSSIZE = m_aPointsBaked.size() * sizeof(m_aPointsBaked[0]) / 1000.f;
+    const auto ELAPSEDUS = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - BEGIN).count() / 1000.f;
 
     const auto BEGINCALC = std::chrono::high_resolution_clock::now();
     for (int j = 1; j < 10; ++j) {
@@ -36,44 +42,110 @@ void CBezierCurve::setup(std::vector<Vector2D>* pVec) {
     }
     const auto ELAPSEDCALCAVG = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - BEGINCALC).count() / 1000.f / 10.f;
 
-    Debug::log(LOG, "Created a bezier curve, baked {} points, mem usage: {:.2f}kB, time to bake: {:.2f}µs. Estimated average calc time: {:.2f}µs.", BAKEDPOINTS, POINTSSIZE,
-               ELAPSEDUS, ELAPSEDCALCAVG);
+    Debug::log(LOG, "Created a bezier curve, {} samples, time to setup: {:.2f}µs. Estimated average calc time: {:.2f}µs.", BEZIER_SAMPLES, ELAPSEDUS, ELAPSEDCALCAVG);
 }
 
 float CBezierCurve::getYForT(float t) {
-    return 3 * t * pow(1 - t, 2) * m_dPoints[1].y + 3 * pow(t, 2) * (1 - t) * m_dPoints[2].y + pow(t, 3);
+    return sampleY(t);
 }
 
 float CBezierCurve::getXForT(float t) {
-    return 3 * t * pow(1 - t, 2) * m_dPoints[1].x + 3 * pow(t, 2) * (1 - t) * m_dPoints[2].x + pow(t, 3);
+    return sampleX(t);
+}
+
+float CBezierCurve::sampleX(float t) const {
+    return ((m_fAX * t + m_fBX) * t + m_fCX) * t;
+}
+
+float CBezierCurve::sampleY(float t) const {
+    return ((m_fAY * t + m_fBY) * t + m_fCY) * t;
+}
+
+float CBezierCurve::sampleDX(float t) const {
+    return (3.f * m_fAX * t + 2.f * m_fBX) * t + m_fCX;
 }
 
-// Todo: this probably can be done better and faster
-float CBezierCurve::getYForPoint(float x) {
-    if (x >= 1.f)
-        return 1.f;
+float CBezierCurve::guessT(float x) const {
+    // x(t) is monotonic for valid curves, find the sample interval and interpolate
+    int i = 1;
+    while (i < BEZIER_SAMPLES - 1 && m_aSamplesX[i] <= x) {
+        ++i;
+    }
+
+    const float LOWER = m_aSamplesX[i - 1];
+    const float UPPER = m_aSamplesX[i];
+    const float DELTA = UPPER - LOWER;
+
+    return (i - 1 + (DELTA > 0.f ? (x - LOWER) / DELTA : 0.f)) * BEZIER_SAMPLE_STEP;
+}
+
+float CBezierCurve::bisectT(float x, float precision) const {
+    float lower = 0.f, upper = 1.f, t = x;
+
+    for (int i = 0; i < 32; ++i) {
+        const float CURRENT = sampleX(t);
+        if (std::abs(CURRENT - x) < precision)
+            break;
 
-    int  index = 0;
-    bool below = true;
-    for (int step = (BAKEDPOINTS + 1) / 2; step > 0; step /= 2) {
-        if (below)
-            index += step;
+        if (CURRENT < x)
+            lower = t;
         else
-            index -= step;
+            upper = t;
 
-        below = m_aPointsBaked[index].x < x;
+        t = (lower + upper) / 2.f;
     }
 
-    int lowerIndex = index - (!below || index == BAKEDPOINTS - 1);
+    return t;
+}
+
+float CBezierCurve::getYForPoint(float x, float precision) {
+    float y = 0.f;
+    getYForPoints(std::span<const float>{&x, 1}, std::span<float>{&y, 1}, precision);
+    return y;
+}
 
-    // in the name of performance i shall make a hack
-    const auto LOWERPOINT = &m_aPointsBaked[lowerIndex];
-    const auto UPPERPOINT = &m_aPointsBaked[lowerIndex + 1];
+void CBezierCurve::getYForPoints(std::span<const float> xs, std::span<float> ys, float precision) {
+    const size_t N = std::min(xs.size(), ys.size());
 
-    const auto PERCINDELTA = (x - LOWERPOINT->x) / (UPPERPOINT->x - LOWERPOINT->x);
+    // ys holds t until the end
+    for (size_t i = 0; i < N; ++i) {
+        ys[i] = guessT(xs[i]);
+    }
 
-    if (std::isnan(PERCINDELTA) || std::isinf(PERCINDELTA)) // can sometimes happen for VERY small x
-        return 0.f;
+    for (int iteration = 0; iteration < BEZIER_NEWTON_ITERATIONS; ++iteration) {
+        float maxError = 0.f;
 
-    return LOWERPOINT->y + (UPPERPOINT->y - LOWERPOINT->y) * PERCINDELTA;
+        for (size_t i = 0; i < N; ++i) {
+            const float T    = ys[i];
+            const float DIFF = sampleX(T) - xs[i];
+            const float D    = sampleDX(T);
+
+            ys[i]    = std::clamp(std::abs(D) > 1e-6f ? T - DIFF / D : T, 0.f, 1.f);
+            maxError = std::max(maxError, std::abs(DIFF));
+        }
+
+        if (maxError < precision)
+            break;
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        const float X = xs[i];
+
+        if (X >= 1.f) {
+            ys[i] = 1.f;
+            continue;
+        }
+
+        if (X <= 0.f) {
+            ys[i] = 0.f;
+            continue;
+        }
+
+        // flat spots in x(t) can stall Newton's method
+        float t = ys[i];
+        if (std::abs(sampleX(t) - X) >= precision)
+            t = bisectT(X, precision);
+
+        ys[i] = sampleY(t);
+    }
 }
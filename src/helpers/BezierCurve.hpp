@@ -3,13 +3,16 @@
 #include <deque>
 #include <array>
 #include <vector>
+#include <span>
 #include "math/Math.hpp"
 
-constexpr int   BAKEDPOINTS    = 255;
-constexpr float INVBAKEDPOINTS = 1.f / BAKEDPOINTS;
+// initial guesses for t are interpolated from this many samples of x(t)
+constexpr int   BEZIER_SAMPLES           = 11;
+constexpr float BEZIER_SAMPLE_STEP       = 1.f / (BEZIER_SAMPLES - 1);
+constexpr int   BEZIER_NEWTON_ITERATIONS = 8;
+constexpr float BEZIER_DEFAULT_PRECISION = 0.0001f;
 
 // an implementation of a cubic bezier curve
-// might do better later
 class CBezierCurve {
   public:
     // sets up the bezier curve.
@@ -18,11 +21,27 @@ class CBezierCurve {
 
     float getYForT(float t);
     float getXForT(float t);
-    float getYForPoint(float x);
+
+    // solves x(t) = x with Newton's method until the error in x is below precision
+    float getYForPoint(float x, float precision = BEZIER_DEFAULT_PRECISION);
+
+    // same as getYForPoint, for many points at once. ys has to be as large as xs.
+    // Iterates all points in lockstep, which the compiler can vectorize.
+    void  getYForPoints(std::span<const float> xs, std::span<float> ys, float precision = BEZIER_DEFAULT_PRECISION);
 
   private:
+    float sampleX(float t) const;
+    float sampleY(float t) const;
+    float sampleDX(float t) const;
+    float guessT(float x) const;
+    float bisectT(float x, float precision) const;
+
     // this INCLUDES the 0,0 and 1,1 points.
-    std::deque<Vector2D>              m_dPoints;
+    std::deque<Vector2D> m_dPoints;
+
+    // polynomial coefficients, x(t) = ((ax * t + bx) * t + cx) * t
+    float                             m_fAX = 0, m_fBX = 0, m_fCX = 0;
+    float                             m_fAY = 0, m_fBY = 0, m_fCY = 0;
 
-    std::array<Vector2D, BAKEDPOINTS> m_aPointsBaked;
+    std::array<float, BEZIER_SAMPLES> m_aSamplesX = {};
 };
@@ -1,5 +1,27 @@
 #include "DamageRing.hpp"
 
+// every rect costs about as much as this many pixels: its geometry, and a clip for every element drawn
+constexpr static double DAMAGE_RECT_COST = 64 * 64;
+constexpr static size_t DAMAGE_MAX_RECTS = 64;
+
+// a fragmented region is cheaper as its bounding box, when that doesn't add much area
+static CRegion simplify(const CRegion& region) {
+    const auto RECTS = region.getRects();
+    if (RECTS.size() <= 1)
+        return region;
+
+    double area = 0;
+    for (auto const& RECT : RECTS) {
+        area += (double)(RECT.x2 - RECT.x1) * (RECT.y2 - RECT.y1);
+    }
+
+    const auto EXTENTS = region.getExtents();
+    if (RECTS.size() > DAMAGE_MAX_RECTS || EXTENTS.w * EXTENTS.h <= area + (RECTS.size() - 1) * DAMAGE_RECT_COST)
+        return EXTENTS;
+
+    return region;
+}
+
 void CDamageRing::setSize(const Vector2D& size_) {
     if (size_ == size)
         return;
@@ -9,6 +31,17 @@ void CDamageRing::setSize(const Vector2D& size_) {
     damageEntire();
 }
 
+void CDamageRing::setLength(size_t length) {
+    length = std::max(length, (size_t)DAMAGE_RING_PREVIOUS_LEN);
+
+    if (length == previous.size())
+        return;
+
+    // what the kept damage refers to is lost, every buffer has to be redrawn
+    previous.assign(length, CBox{{}, size});
+    previousIdx = 0;
+}
+
 bool CDamageRing::damage(const CRegion& rg) {
     CRegion clipped = rg.copy().intersect(CBox{{}, size});
     if (clipped.empty())
@@ -23,30 +56,53 @@ void CDamageRing::damageEntire() {
 }
 
 void CDamageRing::rotate() {
-    previousIdx = (previousIdx + DAMAGE_RING_PREVIOUS_LEN - 1) % DAMAGE_RING_PREVIOUS_LEN;
+    previousIdx = (previousIdx + previous.size() - 1) % previous.size();
 
-    previous[previousIdx] = current;
+    // kept for as many frames as the ring is long, don't let it stay fragmented
+    previous[previousIdx] = simplify(current);
     current.clear();
+
+    frameCount++;
 }
 
 CRegion CDamageRing::getBufferDamage(int age) {
-    if (age <= 0 || age > DAMAGE_RING_PREVIOUS_LEN + 1)
+    if (age <= 0 || age > (int)previous.size() + 1) {
+        addFallback();
         return CBox{{}, size};
+    }
 
     CRegion damage = current;
 
     for (int i = 0; i < age - 1; ++i) {
-        int j = (previousIdx + i) % DAMAGE_RING_PREVIOUS_LEN;
+        int j = (previousIdx + i) % previous.size();
         damage.add(previous.at(j));
     }
 
-    // don't return a ludicrous amount of rects
-    if (damage.getRects().size() > 8)
-        return damage.getExtents();
-
-    return damage;
+    return simplify(damage);
 }
 
 bool CDamageRing::hasChanged() {
     return !current.empty();
 }
+
+uint64_t CDamageRing::frames() const {
+    return frameCount;
+}
+
+void CDamageRing::addFallback() {
+    fullDamageFallbacks(); // roll over the second first
+    fallbacks.thisSecond++;
+}
+
+size_t CDamageRing::fullDamageFallbacks() {
+    const auto NOW = std::chrono::steady_clock::now();
+
+    if (NOW - fallbacks.secondStart >= std::chrono::seconds(1)) {
+        // nothing in the last second if more than a second passed since this one started
+        fallbacks.lastSecond  = NOW - fallbacks.secondStart >= std::chrono::seconds(2) ? 0 : fallbacks.thisSecond;
+        fallbacks.thisSecond  = 0;
+        fallbacks.secondStart = NOW;
+    }
+
+    return fallbacks.lastSecond;
+}
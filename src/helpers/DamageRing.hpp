@@ -1,8 +1,10 @@
 #pragma once
 
 #include "./math/Math.hpp"
-#include <array>
+#include <chrono>
+#include <vector>
 
+// frames of damage kept by default, enough for double buffering
 constexpr static int DAMAGE_RING_PREVIOUS_LEN = 2;
 
 class CDamageRing {
@@ -14,9 +16,25 @@ class CDamageRing {
     CRegion getBufferDamage(int age);
     bool    hasChanged();
 
+    // frames of damage kept, should be at least the swapchain length. Older buffers are damaged entirely.
+    void     setLength(size_t length);
+    uint64_t frames() const; // rotations so far, for telling buffer ages
+
+    // how often getBufferDamage had to return everything for a buffer of unknown or too old age, in the last second
+    size_t fullDamageFallbacks();
+
   private:
-    Vector2D                                      size;
-    CRegion                                       current;
-    std::array<CRegion, DAMAGE_RING_PREVIOUS_LEN> previous;
-    size_t                                        previousIdx = 0;
+    Vector2D             size;
+    CRegion              current;
+    std::vector<CRegion> previous    = std::vector<CRegion>(DAMAGE_RING_PREVIOUS_LEN);
+    size_t               previousIdx = 0;
+    uint64_t             frameCount  = 0;
+
+    struct {
+        size_t                                lastSecond = 0;
+        size_t                                thisSecond = 0;
+        std::chrono::steady_clock::time_point secondStart;
+    } fallbacks;
+
+    void                 addFallback();
 };
@@ -58,6 +58,7 @@ void CMonitor::onConnect(bool noRule) {
 
     listeners.presented = output->events.present.registerListener([this](std::any d) {
         auto E = std::any_cast<Aquamarine::IOutput::SPresentEvent>(d);
+        frameTimes.onPresented(E.when, E.refresh, refreshRate);
         PROTO::presentation->onPresented(self.lock(), E.when, E.refresh, E.seq, E.flags);
     });
 
@@ -237,6 +238,21 @@ void CMonitor::onConnect(bool noRule) {
     EMIT_HOOK_EVENT("monitorAdded", self.lock());
 }
 
+void CMonitor::cancelPendingCommit() {
+    if (!pendingCommit.source)
+        return;
+
+    wl_event_source_remove(pendingCommit.source);
+    pendingCommit.source = nullptr;
+    pendingCommit.sync.reset();
+
+    // nothing commits its buffer now, and its swapchain slot is free again
+    output->state->setBuffer(nullptr);
+    output->swapchain->rollback();
+    damage.damageEntire();
+    pendingFrame = false;
+}
+
 void CMonitor::onDisconnect(bool destroy) {
     CScopeGuard x = {[this]() {
         if (g_pCompositor->m_bIsShuttingDown)
@@ -251,6 +267,9 @@ void CMonitor::onDisconnect(bool destroy) {
         renderTimer = nullptr;
     }
 
+    // going away, the frame waiting for its fence is never shown
+    cancelPendingCommit();
+
     if (!m_bEnabled || g_pCompositor->m_bIsShuttingDown)
         return;
 
@@ -369,11 +388,18 @@ void CMonitor::addDamage(const pixman_region32_t* rg) {
 }
 
 void CMonitor::addDamage(const CRegion* rg) {
+    if (g_pHyprOpenGL)
+        g_pHyprOpenGL->damageBlurCaches(self.lock(), *rg);
+
     addDamage(const_cast<CRegion*>(rg)->pixman());
 }
 
 void CMonitor::addDamage(const CBox* box) {
     static auto PZOOMFACTOR = CConfigValue<Hyprlang::FLOAT>("cursor:zoom_factor");
+
+    if (g_pHyprOpenGL)
+        g_pHyprOpenGL->damageBlurCaches(self.lock(), *box);
+
     if (*PZOOMFACTOR != 1.f && g_pCompositor->getMonitorFromCursor() == self) {
         damage.damageEntire();
         g_pCompositor->scheduleFrameForMonitor(self.lock(), Aquamarine::IOutput::AQ_SCHEDULE_DAMAGE);
@@ -1068,5 +1094,11 @@ bool CMonitorState::updateSwapchain() {
     options.scanout = true;
     options.length  = 2;
     options.size    = MODE->pixelSize;
-    return m_pOwner->output->swapchain->reconfigure(options);
+
+    if (!m_pOwner->output->swapchain->reconfigure(options))
+        return false;
+
+    // buffer damage has to go back as many frames as there are buffers
+    m_pOwner->damage.setLength(options.length);
+    return true;
 }
@@ -12,6 +12,8 @@
 #include <optional>
 #include "signal/Signal.hpp"
 #include "DamageRing.hpp"
+#include "../debug/FrameTimes.hpp"
+#include "../desktop/WindowHitIndex.hpp"
 #include <aquamarine/output/Output.hpp>
 #include <aquamarine/allocator/Swapchain.hpp>
 
@@ -41,6 +43,7 @@ struct SMonitorRule {
 
 class CMonitor;
 class CSyncTimeline;
+class CEGLSync;
 
 class CMonitorState {
   public:
@@ -115,6 +118,8 @@ class CMonitor {
     wl_event_source*            renderTimer  = nullptr; // for RAT
     bool                        RATScheduled = false;
     CTimer                      lastPresentationTimer;
+    CFrameTimes                 frameTimes;
+    CWindowHitIndex             hitIndex;
 
     bool                        isBeingLeased = false;
 
@@ -125,7 +130,13 @@ class CMonitor {
     SP<CSyncTimeline> outTimeline;
     uint64_t          commitSeq = 0;
 
-    PHLMONITORREF     self;
+    // a rendered frame waiting for its fence before being committed, see render:async_commit
+    struct {
+        SP<CEGLSync>     sync;
+        wl_event_source* source = nullptr;
+    } pendingCommit;
+
+    PHLMONITORREF self;
 
     // mirroring
     PHLMONITORREF              pMirrorOf;
@@ -184,6 +195,7 @@ class CMonitor {
     void        scheduleDone();
     bool        attemptDirectScanout();
     void        setCTM(const Mat3x3& ctm);
+    void        cancelPendingCommit(); // drops the frame in pendingCommit and its buffer, for when it'd never be shown anyway
 
     void        debugLastPresentation(const std::string& message);
     void        onMonitorFrame();
@@ -38,9 +38,10 @@ void IHyprLayout::onWindowRemoved(PHLWINDOW pWindow) {
         g_pCompositor->setWindowFullscreenInternal(pWindow, FSMODE_NONE);
 
     if (!pWindow->m_sGroupData.pNextWindow.expired()) {
-        if (pWindow->m_sGroupData.pNextWindow.lock() == pWindow)
+        if (pWindow->m_sGroupData.pNextWindow.lock() == pWindow) {
             pWindow->m_sGroupData.pNextWindow.reset();
-        else {
+            pWindow->markStateChanged();
+        } else {
             // find last window and update
             PHLWINDOW  PWINDOWPREV     = pWindow->getGroupPrevious();
             const auto WINDOWISVISIBLE = pWindow->getGroupCurrent() == pWindow;
@@ -57,6 +58,9 @@ void IHyprLayout::onWindowRemoved(PHLWINDOW pWindow) {
                 std::swap(PWINDOWPREV->m_sGroupData.pNextWindow->m_sGroupData.locked, pWindow->m_sGroupData.locked);
             }
 
+            pWindow->markStateChanged();
+            PWINDOWPREV->markGroupStateChanged();
+
             if (pWindow == m_pLastTiledWindow)
                 m_pLastTiledWindow.reset();
 
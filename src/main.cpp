@@ -4,6 +4,7 @@
 #include "config/ConfigManager.hpp"
 #include "init/initHelpers.hpp"
 #include "debug/HyprCtl.hpp"
+#include "debug/Benchmark.hpp"
 
 #include <cstdio>
 #include <hyprutils/string/String.hpp>
@@ -27,6 +28,8 @@ void help() {
     --wayland-fd FD              - Sets the Wayland socket fd (for Wayland socket handover)
     --systeminfo                 - Prints system infos
     --i-am-really-stupid         - Omits root user privileges check (why would you do that?)
+    --benchmark SCENARIO         - Runs SCENARIO (tiled, floats, swipe, scroll or all) with test windows and a fixed config on a headless output, prints the timings as JSON and exits
+    --benchmark-frames N         - Frames measured per benchmark scenario, 600 by default
     --version           -v       - Print this binary's version)");
 }
 
@@ -46,12 +49,14 @@ int main(int argc, char** argv) {
     setenv("MOZ_ENABLE_WAYLAND", "1", 1);
 
     // parse some args
-    std::string              configPath;
-    std::string              socketName;
-    int                      socketFd   = -1;
-    bool                     ignoreSudo = false;
+    std::string                                    configPath;
+    std::string                                    socketName;
+    int                                            socketFd   = -1;
+    bool                                           ignoreSudo = false;
+    std::optional<std::vector<eBenchmarkScenario>> benchmarkScenarios;
+    size_t                                         benchmarkFrames = 600;
 
-    std::vector<std::string> args{argv + 1, argv + argc};
+    std::vector<std::string>                       args{argv + 1, argv + argc};
 
     for (auto it = args.begin(); it != args.end(); it++) {
         if (it->compare("--i-am-really-stupid") == 0 && !ignoreSudo) {
@@ -87,6 +92,43 @@ int main(int argc, char** argv) {
                 return 1;
             }
 
+            it++;
+        } else if (it->compare("--benchmark") == 0) {
+            if (std::next(it) == args.end()) {
+                help();
+
+                return 1;
+            }
+
+            benchmarkScenarios = CBenchmark::parseScenarios(*std::next(it));
+
+            if (!benchmarkScenarios) {
+                std::println(stderr, "[ ERROR ] Unknown benchmark scenario '{}'!", *std::next(it));
+                help();
+
+                return 1;
+            }
+
+            it++;
+        } else if (it->compare("--benchmark-frames") == 0) {
+            if (std::next(it) == args.end()) {
+                help();
+
+                return 1;
+            }
+
+            try {
+                benchmarkFrames = std::stoull(*std::next(it));
+
+                if (benchmarkFrames == 0)
+                    throw std::exception();
+            } catch (...) {
+                std::println(stderr, "[ ERROR ] Invalid benchmark frame count!");
+                help();
+
+                return 1;
+            }
+
             it++;
         } else if (it->compare("-c") == 0 || it->compare("--config") == 0) {
             if (std::next(it) == args.end()) {
@@ -150,7 +192,28 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::println("Welcome to Hyprland!");
+    if (benchmarkScenarios) {
+        if (!configPath.empty()) {
+            std::println(stderr, "[ ERROR ] --benchmark runs with a config of its own, it can't be combined with --config!");
+            help();
+
+            return 1;
+        }
+
+        // comparable on any machine, unless asked for the gpu
+        setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+        g_pBenchmark = std::make_unique<CBenchmark>(*benchmarkScenarios, benchmarkFrames);
+
+        // only the results go to stdout
+        Debug::disableStdout = true;
+
+        configPath = g_pBenchmark->writeConfig();
+        if (configPath.empty()) {
+            std::println(stderr, "[ ERROR ] Couldn't write the benchmark config!");
+            return 1;
+        }
+    } else
+        std::println("Welcome to Hyprland!");
 
     // let's init the compositor.
     // it initializes basic Wayland stuff in the constructor.
@@ -14,8 +14,13 @@ int wlTick(SP<CEventLoopTimer> self, void* data) {
 
     if (g_pCompositor->m_bSessionActive && g_pAnimationManager && g_pHookSystem && !g_pCompositor->m_bUnsafeState &&
         std::ranges::any_of(g_pCompositor->m_vMonitors, [](const auto& mon) { return mon->m_bEnabled && mon->output; })) {
+        CTimer tickTimer;
+        tickTimer.reset();
+
         g_pAnimationManager->tick();
         EMIT_HOOK_EVENT("tick", nullptr);
+
+        g_pAnimationManager->m_hTickTimes.add(tickTimer.getMillis());
     }
 
     if (g_pAnimationManager && g_pAnimationManager->shouldTickForNext())
@@ -34,6 +39,7 @@ CAnimationManager::CAnimationManager() {
 
 void CAnimationManager::removeAllBeziers() {
     m_mBezierCurves.clear();
+    m_iBezierGeneration++;
 
     // add the default one
     std::vector<Vector2D> points = {Vector2D(0.0, 0.75), Vector2D(0.15, 1.0)};
@@ -43,229 +49,447 @@ void CAnimationManager::removeAllBeziers() {
 void CAnimationManager::addBezierWithName(std::string name, const Vector2D& p1, const Vector2D& p2) {
     std::vector points = {p1, p2};
     m_mBezierCurves[name].setup(&points);
+    m_iBezierGeneration++;
 }
 
 void CAnimationManager::onTicked() {
     m_bTickScheduled = false;
 }
 
+template <Animable T>
+void SActiveAnimations<T>::add(CAnimatedVariable<T>* av) {
+    av->m_iActiveSlot = vars.size();
+
+    eAnimationOwnerKind kind  = AVAROWNER_NONE;
+    uintptr_t           owner = 0;
+    if (av->m_pWindow.get()) {
+        kind  = AVAROWNER_WINDOW;
+        owner = (uintptr_t)av->m_pWindow.get();
+    } else if (av->m_pWorkspace.get()) {
+        kind  = AVAROWNER_WORKSPACE;
+        owner = (uintptr_t)av->m_pWorkspace.get();
+    } else if (av->m_pLayer.get()) {
+        kind  = AVAROWNER_LAYER;
+        owner = (uintptr_t)av->m_pLayer.get();
+    }
+
+    vars.push_back(av);
+    begun.push_back(av->m_Begun);
+    goal.push_back(av->m_Goal);
+    start.push_back(av->animationBegin);
+    configs.push_back(av->m_pConfig);
+    owners.push_back(owner);
+    ownerKinds.push_back(kind);
+    policies.push_back(av->m_eDamagePolicy);
+}
+
+template <Animable T>
+void SActiveAnimations<T>::refresh(CAnimatedVariable<T>* av) {
+    const auto SLOT = av->m_iActiveSlot;
+
+    begun[SLOT]   = av->m_Begun;
+    goal[SLOT]    = av->m_Goal;
+    start[SLOT]   = av->animationBegin;
+    configs[SLOT] = av->m_pConfig;
+}
+
+template <Animable T>
+void SActiveAnimations<T>::remove(size_t slot) {
+    const size_t LAST = vars.size() - 1;
+
+    if (slot != LAST) {
+        vars[slot]       = vars[LAST];
+        begun[slot]      = begun[LAST];
+        goal[slot]       = goal[LAST];
+        start[slot]      = start[LAST];
+        configs[slot]    = configs[LAST];
+        owners[slot]     = owners[LAST];
+        ownerKinds[slot] = ownerKinds[LAST];
+        policies[slot]   = policies[LAST];
+
+        if (vars[slot])
+            vars[slot]->m_iActiveSlot = slot;
+    }
+
+    vars.pop_back();
+    begun.pop_back();
+    goal.pop_back();
+    start.pop_back();
+    configs.pop_back();
+    owners.pop_back();
+    ownerKinds.pop_back();
+    policies.pop_back();
+}
+
+template <Animable T>
+void SActiveAnimations<T>::compact() {
+    for (size_t i = vars.size(); i > 0; --i) {
+        if (!vars[i - 1])
+            remove(i - 1);
+    }
+}
+
+void CAnimationManager::activateVariable(CBaseAnimatedVariable* pav) {
+    const bool REFRESH = pav->m_bIsConnectedToActive;
+
+    switch (pav->m_Type) {
+        case AVARTYPE_FLOAT: {
+            auto av = static_cast<CAnimatedVariable<float>*>(pav);
+            if (REFRESH)
+                m_sActiveFloats.refresh(av);
+            else
+                m_sActiveFloats.add(av);
+            break;
+        }
+        case AVARTYPE_VECTOR: {
+            auto av = static_cast<CAnimatedVariable<Vector2D>*>(pav);
+            if (REFRESH)
+                m_sActiveVectors.refresh(av);
+            else
+                m_sActiveVectors.add(av);
+            break;
+        }
+        case AVARTYPE_COLOR: {
+            auto av = static_cast<CAnimatedVariable<CColor>*>(pav);
+            if (REFRESH)
+                m_sActiveColors.refresh(av);
+            else
+                m_sActiveColors.add(av);
+            break;
+        }
+        default: UNREACHABLE();
+    }
+}
+
+void CAnimationManager::deactivateVariable(CBaseAnimatedVariable* pav) {
+    const auto SLOT = pav->m_iActiveSlot;
+
+    // a tick is iterating the lists, only clear the slot
+    if (m_bTickInProgress) {
+        switch (pav->m_Type) {
+            case AVARTYPE_FLOAT: m_sActiveFloats.vars[SLOT] = nullptr; break;
+            case AVARTYPE_VECTOR: m_sActiveVectors.vars[SLOT] = nullptr; break;
+            case AVARTYPE_COLOR: m_sActiveColors.vars[SLOT] = nullptr; break;
+            default: UNREACHABLE();
+        }
+
+        m_bNeedsCompact = true;
+        return;
+    }
+
+    switch (pav->m_Type) {
+        case AVARTYPE_FLOAT: m_sActiveFloats.remove(SLOT); break;
+        case AVARTYPE_VECTOR: m_sActiveVectors.remove(SLOT); break;
+        case AVARTYPE_COLOR: m_sActiveColors.remove(SLOT); break;
+        default: UNREACHABLE();
+    }
+}
+
+size_t CAnimationManager::activeVariablesCount() const {
+    return m_sActiveFloats.vars.size() + m_sActiveVectors.vars.size() + m_sActiveColors.vars.size();
+}
+
 void CAnimationManager::tick() {
     static std::chrono::time_point lastTick = std::chrono::high_resolution_clock::now();
     m_fLastTickTime                         = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - lastTick).count() / 1000.0;
     lastTick                                = std::chrono::high_resolution_clock::now();
 
-    if (m_vActiveAnimatedVariables.empty())
+    if (activeVariablesCount() == 0)
         return;
 
-    bool        animGlobalDisabled = false;
+    static auto        PANIMENABLED    = CConfigValue<Hyprlang::INT>("animations:enabled");
+    static auto* const PSHADOWSENABLED = (Hyprlang::INT* const*)g_pConfigManager->getConfigValuePtr("decoration:shadow:enabled");
+    static auto        PPRECISION      = CConfigValue<Hyprlang::FLOAT>("animations:bezier_precision");
 
-    static auto PANIMENABLED = CConfigValue<Hyprlang::INT>("animations:enabled");
+    const auto         NOW            = std::chrono::steady_clock::now();
+    const float        PRECISION      = std::clamp((float)*PPRECISION, 0.000001F, 0.01F);
+    const bool         SHADOWSENABLED = **PSHADOWSENABLED;
 
-    if (!*PANIMENABLED)
-        animGlobalDisabled = true;
+    m_bTickInProgress = true;
 
-    static auto* const                  PSHADOWSENABLED = (Hyprlang::INT* const*)g_pConfigManager->getConfigValuePtr("decoration:shadow:enabled");
+    // every window / workspace / layer is looked up and damaged once, no matter how many of its properties animate
+    m_vTickOwners.clear();
+    m_mTickOwnerIndices.clear();
 
-    const auto                          DEFAULTBEZIER = m_mBezierCurves.find("default");
+    collectOwners(m_sActiveFloats, SHADOWSENABLED);
+    collectOwners(m_sActiveVectors, SHADOWSENABLED);
+    collectOwners(m_sActiveColors, SHADOWSENABLED);
+
+    for (auto& owner : m_vTickOwners) {
+        prepareOwner(owner, !*PANIMENABLED);
+    }
 
     std::vector<CBaseAnimatedVariable*> animationEndedVars;
 
-    for (auto const& av : m_vActiveAnimatedVariables) {
+    tickAnimations(m_sActiveFloats, NOW, PRECISION, SHADOWSENABLED, animationEndedVars);
+    tickAnimations(m_sActiveVectors, NOW, PRECISION, SHADOWSENABLED, animationEndedVars);
+    tickAnimations(m_sActiveColors, NOW, PRECISION, SHADOWSENABLED, animationEndedVars);
 
-        if (av->m_eDamagePolicy == AVARDAMAGE_SHADOW && !*PSHADOWSENABLED) {
-            av->warp(false);
-            animationEndedVars.push_back(av);
-            continue;
+    for (auto& owner : m_vTickOwners) {
+        damageOwner(owner);
+    }
+
+    // don't keep the owners alive until the next tick
+    m_vTickOwners.clear();
+
+    m_bTickInProgress = false;
+
+    if (m_bNeedsCompact) {
+        m_sActiveFloats.compact();
+        m_sActiveVectors.compact();
+        m_sActiveColors.compact();
+        m_bNeedsCompact = false;
+    }
+
+    // do it here, because if this alters the active lists we would be in trouble above.
+    for (auto const& ave : animationEndedVars) {
+        ave->onAnimationEnd();
+    }
+}
+
+template <Animable T>
+void CAnimationManager::collectOwners(SActiveAnimations<T>& list, bool shadowsEnabled) {
+    list.tickOwners.resize(list.vars.size());
+
+    for (size_t i = 0; i < list.vars.size(); ++i) {
+        const auto KEY = list.owners[i];
+        auto       IT  = m_mTickOwnerIndices.find(KEY);
+
+        if (IT == m_mTickOwnerIndices.end()) {
+            IT = m_mTickOwnerIndices.emplace(KEY, m_vTickOwners.size()).first;
+            m_vTickOwners.emplace_back(SAnimationTickOwner{.kind = list.ownerKinds[i], .first = list.vars[i]});
         }
 
-        // get the spent % (0 - 1)
-        const float SPENT = av->getPercent();
-
-        // window stuff
-        PHLWINDOW    PWINDOW            = av->m_pWindow.lock();
-        PHLWORKSPACE PWORKSPACE         = av->m_pWorkspace.lock();
-        PHLLS        PLAYER             = av->m_pLayer.lock();
-        PHLMONITOR   PMONITOR           = nullptr;
-        bool         animationsDisabled = animGlobalDisabled;
-
-        if (PWINDOW) {
-            if (av->m_eDamagePolicy == AVARDAMAGE_ENTIRE) {
-                g_pHyprRenderer->damageWindow(PWINDOW);
-            } else if (av->m_eDamagePolicy == AVARDAMAGE_BORDER) {
-                const auto PDECO = PWINDOW->getDecorationByType(DECORATION_BORDER);
-                PDECO->damageEntire();
-            } else if (av->m_eDamagePolicy == AVARDAMAGE_SHADOW) {
-                const auto PDECO = PWINDOW->getDecorationByType(DECORATION_SHADOW);
-                PDECO->damageEntire();
-            }
+        list.tickOwners[i] = IT->second;
 
-            PMONITOR = PWINDOW->m_pMonitor.lock();
-            if (!PMONITOR)
-                continue;
-            animationsDisabled = PWINDOW->m_sWindowData.noAnim.valueOr(animationsDisabled);
-        } else if (PWORKSPACE) {
-            PMONITOR = PWORKSPACE->m_pMonitor.lock();
-            if (!PMONITOR)
-                continue;
+        // shadow animations are warped right away with shadows off, don't damage for them
+        if (list.policies[i] != AVARDAMAGE_NONE && (list.policies[i] != AVARDAMAGE_SHADOW || shadowsEnabled))
+            m_vTickOwners[IT->second].policies |= 1 << list.policies[i];
+    }
+}
 
-            // dont damage the whole monitor on workspace change, unless it's a special workspace, because dim/blur etc
-            if (PWORKSPACE->m_bIsSpecialWorkspace)
-                g_pHyprRenderer->damageMonitor(PMONITOR);
+void CAnimationManager::prepareOwner(SAnimationTickOwner& owner, bool animationsDisabled) {
+    owner.animationsDisabled = animationsDisabled;
 
-            // TODO: just make this into a damn callback already vax...
-            for (auto const& w : g_pCompositor->m_vWindows) {
-                if (!w->m_bIsMapped || w->isHidden() || w->m_pWorkspace != PWORKSPACE)
-                    continue;
+    switch (owner.kind) {
+        case AVAROWNER_WINDOW: owner.window = owner.first->m_pWindow.lock(); break;
+        case AVAROWNER_WORKSPACE: owner.workspace = owner.first->m_pWorkspace.lock(); break;
+        case AVAROWNER_LAYER: owner.layer = owner.first->m_pLayer.lock(); break;
+        default: break;
+    }
 
-                if (w->m_bIsFloating && !w->m_bPinned) {
-                    // still doing the full damage hack for floating because sometimes when the window
-                    // goes through multiple monitors the last rendered frame is missing damage somehow??
-                    const CBox windowBoxNoOffset = w->getFullWindowBoundingBox();
-                    const CBox monitorBox        = {PMONITOR->vecPosition, PMONITOR->vecSize};
-                    if (windowBoxNoOffset.intersection(monitorBox) != windowBoxNoOffset) // on edges between multiple monitors
-                        g_pHyprRenderer->damageWindow(w, true);
-                }
+    if (owner.window) {
+        if (owner.policies & (1 << AVARDAMAGE_ENTIRE))
+            g_pHyprRenderer->damageWindow(owner.window);
+        else {
+            if (owner.policies & (1 << AVARDAMAGE_BORDER))
+                owner.window->getDecorationByType(DECORATION_BORDER)->damageEntire();
+            if (owner.policies & (1 << AVARDAMAGE_SHADOW))
+                owner.window->getDecorationByType(DECORATION_SHADOW)->damageEntire();
+        }
 
-                if (PWORKSPACE->m_bIsSpecialWorkspace)
-                    g_pHyprRenderer->damageWindow(w, true); // hack for special too because it can cross multiple monitors
-            }
+        owner.monitor = owner.window->m_pMonitor.lock();
+        if (!owner.monitor) {
+            owner.skip = true;
+            return;
+        }
 
-            // damage any workspace window that is on any monitor
-            for (auto const& w : g_pCompositor->m_vWindows) {
-                if (!validMapped(w) || w->m_pWorkspace != PWORKSPACE || w->m_bPinned)
-                    continue;
+        owner.animationsDisabled = owner.window->m_sWindowData.noAnim.valueOr(owner.animationsDisabled);
+        owner.visible            = owner.window->m_pWorkspace ? g_pCompositor->isWorkspaceVisible(owner.window->m_pWorkspace) : true;
+    } else if (owner.workspace) {
+        owner.monitor = owner.workspace->m_pMonitor.lock();
+        if (!owner.monitor) {
+            owner.skip = true;
+            return;
+        }
+
+        // dont damage the whole monitor on workspace change, unless it's a special workspace, because dim/blur etc
+        if (owner.workspace->m_bIsSpecialWorkspace)
+            g_pHyprRenderer->damageMonitor(owner.monitor);
+
+        // TODO: just make this into a damn callback already vax...
+        for (auto const& w : g_pCompositor->m_vWindows) {
+            if (!w->m_bIsMapped || w->isHidden() || w->m_pWorkspace != owner.workspace)
+                continue;
 
-                g_pHyprRenderer->damageWindow(w);
+            if (w->m_bIsFloating && !w->m_bPinned) {
+                // still doing the full damage hack for floating because sometimes when the window
+                // goes through multiple monitors the last rendered frame is missing damage somehow??
+                const CBox windowBoxNoOffset = w->getFullWindowBoundingBox();
+                const CBox monitorBox        = {owner.monitor->vecPosition, owner.monitor->vecSize};
+                if (windowBoxNoOffset.intersection(monitorBox) != windowBoxNoOffset) // on edges between multiple monitors
+                    g_pHyprRenderer->damageWindow(w, true);
             }
-        } else if (PLAYER) {
-            // "some fucking layers miss 1 pixel???" -- vaxry
-            CBox expandBox = CBox{PLAYER->realPosition.value(), PLAYER->realSize.value()};
-            expandBox.expand(5);
-            g_pHyprRenderer->damageBox(&expandBox);
 
-            PMONITOR = g_pCompositor->getMonitorFromVector(PLAYER->realPosition.goal() + PLAYER->realSize.goal() / 2.F);
-            if (!PMONITOR)
+            if (owner.workspace->m_bIsSpecialWorkspace)
+                g_pHyprRenderer->damageWindow(w, true); // hack for special too because it can cross multiple monitors
+        }
+
+        // damage any workspace window that is on any monitor
+        for (auto const& w : g_pCompositor->m_vWindows) {
+            if (!validMapped(w) || w->m_pWorkspace != owner.workspace || w->m_bPinned)
                 continue;
-            animationsDisabled = animationsDisabled || PLAYER->noAnimations;
+
+            g_pHyprRenderer->damageWindow(w);
+        }
+    } else if (owner.layer) {
+        // "some fucking layers miss 1 pixel???" -- vaxry
+        CBox expandBox = CBox{owner.layer->realPosition.value(), owner.layer->realSize.value()};
+        expandBox.expand(5);
+        g_pHyprRenderer->damageBox(&expandBox);
+
+        owner.monitor = g_pCompositor->getMonitorFromVector(owner.layer->realPosition.goal() + owner.layer->realSize.goal() / 2.F);
+        if (!owner.monitor) {
+            owner.skip = true;
+            return;
         }
 
-        const bool VISIBLE = PWINDOW && PWINDOW->m_pWorkspace ? g_pCompositor->isWorkspaceVisible(PWINDOW->m_pWorkspace) : true;
+        owner.animationsDisabled = owner.animationsDisabled || owner.layer->noAnimations;
+    } else
+        owner.kind = AVAROWNER_NONE; // gone, or never had one
+}
 
-        // beziers are with a switch unforto
-        // TODO: maybe do something cleaner
+template <Animable T>
+void CAnimationManager::evaluateCurves(SActiveAnimations<T>& list, float precision) {
+    const size_t N = list.vars.size();
 
-        auto updateVariable = [&]<Animable T>(CAnimatedVariable<T>& av) {
-            // for disabled anims just warp
-            if (av.m_pConfig->pValues->internalEnabled == 0 || animationsDisabled) {
-                av.warp(false);
-                return;
-            }
+    list.curveValues.resize(N);
+    m_vTickCurves.resize(N);
 
-            if (SPENT >= 1.f || av.m_Begun == av.m_Goal) {
-                av.warp(false);
-                return;
-            }
+    for (size_t i = 0; i < N; ++i) {
+        m_vTickCurves[i] = {getBezierHandle(list.configs[i]->pValues), i};
+    }
 
-            const auto DELTA  = av.m_Goal - av.m_Begun;
-            const auto BEZIER = m_mBezierCurves.find(av.m_pConfig->pValues->internalBezier);
+    // evaluate every curve once, for all animations using it
+    std::ranges::sort(m_vTickCurves, [](const auto& a, const auto& b) { return a.first < b.first; });
 
-            if (BEZIER != m_mBezierCurves.end())
-                av.m_Value = av.m_Begun + DELTA * BEZIER->second.getYForPoint(SPENT);
-            else
-                av.m_Value = av.m_Begun + DELTA * DEFAULTBEZIER->second.getYForPoint(SPENT);
-        };
-
-        switch (av->m_Type) {
-            case AVARTYPE_FLOAT: {
-                auto typedAv = static_cast<CAnimatedVariable<float>*>(av);
-                updateVariable(*typedAv);
-                break;
-            }
-            case AVARTYPE_VECTOR: {
-                auto typedAv = static_cast<CAnimatedVariable<Vector2D>*>(av);
-                updateVariable(*typedAv);
-                break;
-            }
-            case AVARTYPE_COLOR: {
-                auto typedAv = static_cast<CAnimatedVariable<CColor>*>(av);
-                updateVariable(*typedAv);
-                break;
-            }
-            default: UNREACHABLE();
+    for (size_t begin = 0; begin < N;) {
+        size_t end = begin;
+        while (end < N && m_vTickCurves[end].first == m_vTickCurves[begin].first) {
+            ++end;
+        }
+
+        m_vBatchX.resize(end - begin);
+        m_vBatchY.resize(end - begin);
+
+        for (size_t i = begin; i < end; ++i) {
+            m_vBatchX[i - begin] = list.percents[m_vTickCurves[i].second];
         }
-        // set size and pos if valid, but only if damage policy entire (dont if border for example)
-        if (validMapped(PWINDOW) && av->m_eDamagePolicy == AVARDAMAGE_ENTIRE && !PWINDOW->isX11OverrideRedirect())
-            g_pXWaylandManager->setWindowSize(PWINDOW, PWINDOW->m_vRealSize.goal());
+
+        m_vTickCurves[begin].first->getYForPoints(m_vBatchX, m_vBatchY, precision);
+
+        for (size_t i = begin; i < end; ++i) {
+            list.curveValues[m_vTickCurves[i].second] = m_vBatchY[i - begin];
+        }
+
+        begin = end;
+    }
+}
+
+template <Animable T>
+void CAnimationManager::tickAnimations(SActiveAnimations<T>& list, std::chrono::steady_clock::time_point now, float precision, bool shadowsEnabled,
+                                       std::vector<CBaseAnimatedVariable*>& ended) {
+    // animations started by callbacks below are appended, they'll be picked up next tick
+    const size_t N = list.vars.size();
+
+    list.percents.resize(N);
+    for (size_t i = 0; i < N; ++i) {
+        const auto DURATIONPASSED = std::chrono::duration_cast<std::chrono::milliseconds>(now - list.start[i]).count();
+        list.percents[i]          = std::clamp((DURATIONPASSED / 100.f) / list.configs[i]->pValues->internalSpeed, 0.f, 1.f);
+    }
+
+    evaluateCurves(list, precision);
+
+    for (size_t i = 0; i < N; ++i) {
+        const auto av = list.vars[i];
+
+        // stopped by a callback this tick
+        if (!av)
+            continue;
+
+        const auto POLICY = list.policies[i];
+        auto&      owner  = m_vTickOwners[list.tickOwners[i]];
+
+        if (POLICY == AVARDAMAGE_SHADOW && !shadowsEnabled) {
+            av->warp(false);
+            ended.push_back(av);
+            continue;
+        }
+
+        if (owner.skip)
+            continue;
+
+        // for disabled anims just warp
+        if (list.configs[i]->pValues->internalEnabled == 0 || owner.animationsDisabled || list.percents[i] >= 1.f || list.begun[i] == list.goal[i])
+            av->warp(false);
+        else
+            av->m_Value = list.begun[i] + (list.goal[i] - list.begun[i]) * list.curveValues[i];
+
+        if (POLICY == AVARDAMAGE_ENTIRE)
+            owner.resized = true;
 
         // check if we did not finish animating. If so, trigger onAnimationEnd.
         if (!av->isBeingAnimated())
-            animationEndedVars.push_back(av);
+            ended.push_back(av);
 
         // lastly, handle damage, but only if whatever we are animating is visible.
-        if (!VISIBLE)
+        if (!owner.visible)
             continue;
 
+        if (POLICY != AVARDAMAGE_NONE)
+            owner.damage |= 1 << POLICY;
+
         if (av->m_fUpdateCallback)
             av->m_fUpdateCallback(av);
+    }
+}
 
-        switch (av->m_eDamagePolicy) {
-            case AVARDAMAGE_ENTIRE: {
-                if (PWINDOW) {
-                    PWINDOW->updateWindowDecos();
-                    g_pHyprRenderer->damageWindow(PWINDOW);
-                } else if (PWORKSPACE) {
-                    for (auto const& w : g_pCompositor->m_vWindows) {
-                        if (!validMapped(w) || w->m_pWorkspace != PWORKSPACE)
-                            continue;
-
-                        w->updateWindowDecos();
-
-                        // damage any workspace window that is on any monitor
-                        if (!w->m_bPinned)
-                            g_pHyprRenderer->damageWindow(w);
-                    }
-                } else if (PLAYER) {
-                    if (PLAYER->layer <= 1)
-                        g_pHyprOpenGL->markBlurDirtyForMonitor(PMONITOR);
-
-                    // some fucking layers miss 1 pixel???
-                    CBox expandBox = CBox{PLAYER->realPosition.value(), PLAYER->realSize.value()};
-                    expandBox.expand(5);
-                    g_pHyprRenderer->damageBox(&expandBox);
-                }
-                break;
-            }
-            case AVARDAMAGE_BORDER: {
-                RASSERT(PWINDOW, "Tried to AVARDAMAGE_BORDER a non-window AVAR!");
+void CAnimationManager::damageOwner(SAnimationTickOwner& owner) {
+    if (owner.skip)
+        return;
 
-                const auto PDECO = PWINDOW->getDecorationByType(DECORATION_BORDER);
-                PDECO->damageEntire();
+    // set size and pos if valid, but only if damage policy entire (dont if border for example)
+    if (owner.resized && validMapped(owner.window) && !owner.window->isX11OverrideRedirect())
+        g_pXWaylandManager->setWindowSize(owner.window, owner.window->m_vRealSize.goal());
 
-                break;
-            }
-            case AVARDAMAGE_SHADOW: {
-                RASSERT(PWINDOW, "Tried to AVARDAMAGE_SHADOW a non-window AVAR!");
+    if (!owner.visible)
+        return;
 
-                const auto PDECO = PWINDOW->getDecorationByType(DECORATION_SHADOW);
+    if (owner.damage & (1 << AVARDAMAGE_ENTIRE)) {
+        if (owner.window) {
+            owner.window->updateWindowDecos();
+            g_pHyprRenderer->damageWindow(owner.window);
+        } else if (owner.workspace) {
+            for (auto const& w : g_pCompositor->m_vWindows) {
+                if (!validMapped(w) || w->m_pWorkspace != owner.workspace)
+                    continue;
 
-                PDECO->damageEntire();
+                w->updateWindowDecos();
 
-                break;
+                // damage any workspace window that is on any monitor
+                if (!w->m_bPinned)
+                    g_pHyprRenderer->damageWindow(w);
             }
-            default: {
-                break;
-            }
-        }
+        } else if (owner.layer) {
+            if (owner.layer->layer <= 1)
+                g_pHyprOpenGL->markBlurDirtyForMonitor(owner.monitor);
 
-        // manually schedule a frame
-        if (PMONITOR)
-            g_pCompositor->scheduleFrameForMonitor(PMONITOR, Aquamarine::IOutput::AQ_SCHEDULE_ANIMATION);
+            // some fucking layers miss 1 pixel???
+            CBox expandBox = CBox{owner.layer->realPosition.value(), owner.layer->realSize.value()};
+            expandBox.expand(5);
+            g_pHyprRenderer->damageBox(&expandBox);
+        }
+    } else if (owner.window) {
+        // damageWindow above already covers the decorations
+        if (owner.damage & (1 << AVARDAMAGE_BORDER))
+            owner.window->getDecorationByType(DECORATION_BORDER)->damageEntire();
+        if (owner.damage & (1 << AVARDAMAGE_SHADOW))
+            owner.window->getDecorationByType(DECORATION_SHADOW)->damageEntire();
     }
 
-    // do it here, because if this alters the animation vars deque we would be in trouble above.
-    for (auto const& ave : animationEndedVars) {
-        ave->onAnimationEnd();
-    }
+    // manually schedule a frame
+    if (owner.monitor)
+        g_pCompositor->scheduleFrameForMonitor(owner.monitor, Aquamarine::IOutput::AQ_SCHEDULE_ANIMATION);
 }
 
 bool CAnimationManager::deltaSmallToFlip(const Vector2D& a, const Vector2D& b) {
@@ -524,6 +748,16 @@ std::string CAnimationManager::styleValidInConfigVar(const std::string& config,
     return "";
 }
 
+CBezierCurve* CAnimationManager::getBezierHandle(SAnimationPropertyConfig* pConfig) {
+    if (!pConfig->internalBezierHandle || pConfig->internalBezierGeneration != m_iBezierGeneration) {
+        const auto IT                     = m_mBezierCurves.find(pConfig->internalBezier);
+        pConfig->internalBezierHandle     = IT == m_mBezierCurves.end() ? &m_mBezierCurves["default"] : &IT->second;
+        pConfig->internalBezierGeneration = m_iBezierGeneration;
+    }
+
+    return pConfig->internalBezierHandle;
+}
+
 CBezierCurve* CAnimationManager::getBezier(const std::string& name) {
     const auto BEZIER = std::find_if(m_mBezierCurves.begin(), m_mBezierCurves.end(), [&](const auto& other) { return other.first == name; });
 
@@ -535,7 +769,7 @@ std::unordered_map<std::string, CBezierCurve> CAnimationManager::getAllBeziers()
 }
 
 bool CAnimationManager::shouldTickForNext() {
-    return !m_vActiveAnimatedVariables.empty();
+    return activeVariablesCount() > 0;
 }
 
 void CAnimationManager::scheduleTick() {
@@ -6,10 +6,56 @@
 #include "../helpers/AnimatedVariable.hpp"
 #include "../helpers/BezierCurve.hpp"
 #include "../helpers/Timer.hpp"
+#include "../debug/FrameTimes.hpp"
 #include "eventLoop/EventLoopTimer.hpp"
 
 class CWindow;
 
+enum eAnimationOwnerKind : uint8_t {
+    AVAROWNER_NONE = 0,
+    AVAROWNER_WINDOW,
+    AVAROWNER_WORKSPACE,
+    AVAROWNER_LAYER,
+};
+
+// Running animations of one type, as parallel arrays. Slot i of every array belongs to vars[i].
+template <Animable T>
+struct SActiveAnimations {
+    std::vector<CAnimatedVariable<T>*>                 vars;
+    std::vector<T>                                     begun;
+    std::vector<T>                                     goal;
+    std::vector<std::chrono::steady_clock::time_point> start;
+    std::vector<SAnimationPropertyConfig*>             configs;
+    std::vector<uintptr_t>                             owners;
+    std::vector<eAnimationOwnerKind>                   ownerKinds;
+    std::vector<AVARDAMAGEPOLICY>                      policies;
+
+    std::vector<float>                                 percents; // per tick scratch
+    std::vector<float>                                 curveValues;
+    std::vector<uint32_t>                              tickOwners;
+
+    void                                               add(CAnimatedVariable<T>* av);
+    void                                               refresh(CAnimatedVariable<T>* av);
+    void                                               remove(size_t slot);
+    void                                               compact();
+};
+
+// an owner's state for one tick, shared by all its animations
+struct SAnimationTickOwner {
+    eAnimationOwnerKind    kind  = AVAROWNER_NONE;
+    CBaseAnimatedVariable* first = nullptr;
+    PHLWINDOW              window;
+    PHLWORKSPACE           workspace;
+    PHLLS                  layer;
+    PHLMONITOR             monitor;
+    uint8_t                policies           = 0; // 1 << AVARDAMAGEPOLICY of its animations
+    uint8_t                damage             = 0; // same, for those that were updated
+    bool                   skip               = false;
+    bool                   animationsDisabled = false;
+    bool                   visible            = true;
+    bool                   resized            = false;
+};
+
 class CAnimationManager {
   public:
     CAnimationManager();
@@ -25,17 +71,22 @@ class CAnimationManager {
 
     bool                                          bezierExists(const std::string&);
     CBezierCurve*                                 getBezier(const std::string&);
+    CBezierCurve*                                 getBezierHandle(SAnimationPropertyConfig*); // cached in the config until beziers change
 
     std::string                                   styleValidInConfigVar(const std::string&, const std::string&);
 
     std::unordered_map<std::string, CBezierCurve> getAllBeziers();
 
     std::vector<CBaseAnimatedVariable*>           m_vAnimatedVariables;
-    std::vector<CBaseAnimatedVariable*>           m_vActiveAnimatedVariables;
+
+    void                                          activateVariable(CBaseAnimatedVariable*); // called by the variables when they start / stop animating
+    void                                          deactivateVariable(CBaseAnimatedVariable*);
+    size_t                                        activeVariablesCount() const;
 
     SP<CEventLoopTimer>                           m_pAnimationTimer;
 
     float                                         m_fLastTickTime; // in ms
+    CTimeHistogram                                m_hTickTimes;    // how long ticks take, see hyprctl frametimes
 
   private:
     bool                                          deltaSmallToFlip(const Vector2D& a, const Vector2D& b);
@@ -44,8 +95,30 @@ class CAnimationManager {
     bool                                          deltazero(const Vector2D& a, const Vector2D& b);
     bool                                          deltazero(const CColor& a, const CColor& b);
     bool                                          deltazero(const float& a, const float& b);
+    void                                          prepareOwner(SAnimationTickOwner& owner, bool animationsDisabled);
+    void                                          damageOwner(SAnimationTickOwner& owner);
+
+    template <Animable T>
+    void collectOwners(SActiveAnimations<T>& list, bool shadowsEnabled);
+    template <Animable T>
+    void evaluateCurves(SActiveAnimations<T>& list, float precision);
+    template <Animable T>
+    void tickAnimations(SActiveAnimations<T>& list, std::chrono::steady_clock::time_point now, float precision, bool shadowsEnabled, std::vector<CBaseAnimatedVariable*>& ended);
 
     std::unordered_map<std::string, CBezierCurve> m_mBezierCurves;
+    uint64_t                                      m_iBezierGeneration = 1;
+
+    SActiveAnimations<float>                      m_sActiveFloats;
+    SActiveAnimations<Vector2D>                   m_sActiveVectors;
+    SActiveAnimations<CColor>                     m_sActiveColors;
+
+    bool                                          m_bTickInProgress = false; // while ticking, stopped animations leave an empty slot
+    bool                                          m_bNeedsCompact   = false;
+
+    std::vector<SAnimationTickOwner>              m_vTickOwners; // per tick scratch
+    std::unordered_map<uintptr_t, uint32_t>       m_mTickOwnerIndices;
+    std::vector<std::pair<CBezierCurve*, size_t>> m_vTickCurves;
+    std::vector<float>                            m_vBatchX, m_vBatchY;
 
     bool                                          m_bTickScheduled = false;
 
@@ -7,8 +7,26 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <cstring>
+#include <sstream>
+
+// per client, queued events past this drop the client
+constexpr size_t MAX_QUEUED_BYTES   = 1024 * 1024;
+constexpr size_t MAX_WRITEV_EVENTS  = 64;
+constexpr size_t MAX_SUBSCRIBE_LINE = 4096;
+
+// events which only carry the current state of something, an older queued one is useless once a new one comes in
+static std::string coalesceKeyFor(const SHyprIPCEvent& event) {
+    if (event.event == "windowtitle" || event.event == "windowtitlev2" || event.event == "activelayout")
+        return event.event + ">>" + event.data.substr(0, event.data.find(','));
+
+    if (event.event == "activewindow" || event.event == "activewindowv2" || event.event == "submap")
+        return event.event;
+
+    return "";
+}
 
 CEventManager::CEventManager() {
     m_iSocketFD = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
@@ -91,11 +109,11 @@ int CEventManager::onServerEvent(int fd, uint32_t mask) {
     Debug::log(LOG, "Socket2 accepted a new client at FD {}", ACCEPTEDCONNECTION);
 
     // add to event loop so we can close it when we need to
-    auto* eventSource = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, ACCEPTEDCONNECTION, 0, onServerEvent, nullptr);
+    // readable for subscription requests
+    auto* eventSource = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, ACCEPTEDCONNECTION, WL_EVENT_READABLE, onServerEvent, nullptr);
     m_vClients.emplace_back(SClient{
-        ACCEPTEDCONNECTION,
-        {},
-        eventSource,
+        .fd          = ACCEPTEDCONNECTION,
+        .eventSource = eventSource,
     });
 
     return 0;
@@ -108,24 +126,141 @@ int CEventManager::onClientEvent(int fd, uint32_t mask) {
         return 0;
     }
 
-    if (mask & WL_EVENT_WRITABLE) {
-        const auto CLIENTIT = findClientByFD(fd);
+    const auto CLIENTIT = findClientByFD(fd);
+    if (CLIENTIT == m_vClients.end())
+        return 0;
+
+    if (mask & WL_EVENT_READABLE)
+        readSubscriptions(*CLIENTIT);
+
+    if (mask & WL_EVENT_WRITABLE && !flushClient(*CLIENTIT)) {
+        Debug::log(LOG, "Socket2 fd {} failed writing, removing", fd);
+        removeClientByFD(fd);
+        return 0;
+    }
+
+    updateClientMask(*CLIENTIT);
+
+    return 0;
+}
+
+bool CEventManager::wantsEvent(const SClient& client, const std::string& event) const {
+    return client.subscriptions.empty() || client.subscriptions.contains(event);
+}
+
+void CEventManager::readSubscriptions(SClient& client) {
+    char buf[1024];
+
+    while (true) {
+        const auto LEN = read(client.fd, buf, sizeof(buf));
+
+        if (LEN > 0) {
+            client.readBuffer.append(buf, LEN);
+            continue;
+        }
+
+        if (LEN == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            client.readClosed = true;
+
+        if (LEN < 0 && errno == EINTR)
+            continue;
+
+        break;
+    }
+
+    size_t newline = 0;
+    while ((newline = client.readBuffer.find('\n')) != std::string::npos) {
+        const auto LINE = client.readBuffer.substr(0, newline);
+        client.readBuffer.erase(0, newline + 1);
+
+        if (!LINE.starts_with("subscribe ")) {
+            Debug::log(WARN, "Socket2 fd {} sent an unknown request, ignoring", client.fd);
+            continue;
+        }
+
+        auto events = LINE.substr(10);
+        std::replace(events.begin(), events.end(), ',', ' ');
+
+        std::istringstream stream(events);
+        std::string        event;
+        while (stream >> event) {
+            client.subscriptions.insert(event);
+        }
+
+        Debug::log(LOG, "Socket2 fd {} subscribed to {} event types", client.fd, client.subscriptions.size());
+    }
+
+    if (client.readBuffer.length() > MAX_SUBSCRIBE_LINE) {
+        Debug::log(WARN, "Socket2 fd {} sent an overlong request, ignoring", client.fd);
+        client.readBuffer.clear();
+    }
+}
+
+void CEventManager::queueEvent(SClient& client, SP<std::string> data, const std::string& coalesceKey) {
+    if (!coalesceKey.empty()) {
+        // a partially written event has to go out whole
+        const auto BEGIN = client.events.begin() + (client.frontOffset > 0 ? 1 : 0);
+        const auto IT    = std::find_if(BEGIN, client.events.end(), [&coalesceKey](const auto& e) { return e.coalesceKey == coalesceKey; });
+
+        if (IT != client.events.end()) {
+            client.queuedBytes -= IT->data->length();
+            client.events.erase(IT);
+        }
+    }
+
+    client.queuedBytes += data->length();
+    client.events.emplace_back(SQueuedEvent{data, coalesceKey});
+}
+
+bool CEventManager::flushClient(SClient& client) {
+    while (!client.events.empty()) {
+        iovec  iov[MAX_WRITEV_EVENTS];
+        size_t count = 0;
+
+        for (auto it = client.events.begin(); it != client.events.end() && count < MAX_WRITEV_EVENTS; ++it, ++count) {
+            const size_t OFFSET = count == 0 ? client.frontOffset : 0;
+            iov[count].iov_base = it->data->data() + OFFSET;
+            iov[count].iov_len  = it->data->length() - OFFSET;
+        }
+
+        auto written = writev(client.fd, iov, count);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        while (written > 0 && !client.events.empty()) {
+            const size_t REMAINING = client.events.front().data->length() - client.frontOffset;
 
-        // send all queued events
-        while (!CLIENTIT->events.empty()) {
-            const auto& event = CLIENTIT->events.front();
-            if (write(CLIENTIT->fd, event->c_str(), event->length()) < 0)
+            if ((size_t)written < REMAINING) {
+                client.frontOffset += written;
                 break;
+            }
 
-            CLIENTIT->events.pop_front();
+            written -= REMAINING;
+            client.queuedBytes -= client.events.front().data->length();
+            client.frontOffset = 0;
+            client.events.pop_front();
         }
 
-        // stop polling when we sent all events
-        if (CLIENTIT->events.empty())
-            wl_event_source_fd_update(CLIENTIT->eventSource, 0);
+        // socket is full
+        if (client.frontOffset > 0)
+            break;
     }
 
-    return 0;
+    return true;
+}
+
+void CEventManager::updateClientMask(SClient& client) {
+    uint32_t mask = 0;
+    if (!client.readClosed)
+        mask |= WL_EVENT_READABLE;
+    if (!client.events.empty())
+        mask |= WL_EVENT_WRITABLE;
+
+    wl_event_source_fd_update(client.eventSource, mask);
 }
 
 std::vector<CEventManager::SClient>::iterator CEventManager::findClientByFD(int fd) {
@@ -153,25 +288,52 @@ void CEventManager::postEvent(const SHyprIPCEvent& event) {
         return;
     }
 
-    const size_t MAX_QUEUED_EVENTS = 64;
-    auto         sharedEvent       = makeShared<std::string>(formatEvent(event));
+    // only formatted if anyone is listening
+    SP<std::string> sharedEvent;
+    std::string     coalesceKey;
+
     for (auto it = m_vClients.begin(); it != m_vClients.end();) {
+        if (!wantsEvent(*it, event.event)) {
+            ++it;
+            continue;
+        }
+
+        if (!sharedEvent) {
+            sharedEvent = makeShared<std::string>(formatEvent(event));
+            coalesceKey = coalesceKeyFor(event);
+        }
+
         // try to send the event immediately if the queue is empty
-        const auto QUEUESIZE = it->events.size();
-        if (QUEUESIZE > 0 || write(it->fd, sharedEvent->c_str(), sharedEvent->length()) < 0) {
-            if (QUEUESIZE >= MAX_QUEUED_EVENTS) {
-                // too many events queued, remove the client
-                Debug::log(ERR, "Socket2 fd {} overflowed event queue, removing", it->fd);
+        if (it->events.empty()) {
+            const auto WRITTEN = write(it->fd, sharedEvent->c_str(), sharedEvent->length());
+
+            if (WRITTEN == (ssize_t)sharedEvent->length()) {
+                ++it;
+                continue;
+            }
+
+            if (WRITTEN < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                Debug::log(LOG, "Socket2 fd {} failed writing, removing", it->fd);
                 it = removeClientByFD(it->fd);
                 continue;
             }
 
-            // queue it to send later if failed
-            it->events.push_back(sharedEvent);
+            queueEvent(*it, sharedEvent, coalesceKey);
+            it->frontOffset = std::max(WRITTEN, (ssize_t)0);
+
+            // poll for write
+            updateClientMask(*it);
+            ++it;
+            continue;
+        }
+
+        queueEvent(*it, sharedEvent, coalesceKey);
 
-            // poll for write if queue was empty
-            if (QUEUESIZE == 0)
-                wl_event_source_fd_update(it->eventSource, WL_EVENT_WRITABLE);
+        if (it->queuedBytes > MAX_QUEUED_BYTES) {
+            // client isn't reading, remove it
+            Debug::log(ERR, "Socket2 fd {} overflowed event queue ({} events, {} bytes), removing", it->fd, it->events.size(), it->queuedBytes);
+            it = removeClientByFD(it->fd);
+            continue;
         }
 
         ++it;
@@ -1,6 +1,7 @@
 #pragma once
 #include <deque>
 #include <vector>
+#include <set>
 
 #include "../defines.hpp"
 #include "../helpers/memory/Memory.hpp"
@@ -10,6 +11,16 @@ struct SHyprIPCEvent {
     std::string data;
 };
 
+/*
+    Socket2 event bus.
+
+    A client may send "subscribe <event>[,<event>...]\n" lines after connecting
+    to only receive those events. Without any subscription, it gets everything.
+
+    Events that can't be written right away are queued per client. Queued events that
+    only describe a current state (window title, active window...) are superseded
+    by newer ones of the same kind.
+*/
 class CEventManager {
   public:
     CEventManager();
@@ -26,15 +37,32 @@ class CEventManager {
     int         onServerEvent(int fd, uint32_t mask);
     int         onClientEvent(int fd, uint32_t mask);
 
+    struct SQueuedEvent {
+        SP<std::string> data;
+        std::string     coalesceKey; // empty if the event can't be superseded
+    };
+
     struct SClient {
-        int                         fd = -1;
-        std::deque<SP<std::string>> events;
-        wl_event_source*            eventSource = nullptr;
+        int                      fd = -1;
+        std::deque<SQueuedEvent> events;
+        size_t                   queuedBytes = 0;
+        size_t                   frontOffset = 0; // bytes of the first event already written
+        wl_event_source*         eventSource = nullptr;
+
+        std::set<std::string>    subscriptions; // empty means all
+        std::string              readBuffer;
+        bool                     readClosed = false;
     };
 
     std::vector<SClient>::iterator findClientByFD(int fd);
     std::vector<SClient>::iterator removeClientByFD(int fd);
 
+    bool                           wantsEvent(const SClient& client, const std::string& event) const;
+    void                           readSubscriptions(SClient& client);
+    void                           queueEvent(SClient& client, SP<std::string> data, const std::string& coalesceKey);
+    bool                           flushClient(SClient& client);
+    void                           updateClientMask(SClient& client);
+
   private:
     int                  m_iSocketFD    = -1;
     wl_event_source*     m_pEventSource = nullptr;
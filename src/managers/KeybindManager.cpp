@@ -7,6 +7,7 @@
 #include "../render/decorations/CHyprGroupBarDecoration.hpp"
 #include "../devices/IKeyboard.hpp"
 #include "KeybindManager.hpp"
+#include "KeymapCache.hpp"
 #include "PointerManager.hpp"
 #include "Compositor.hpp"
 #include "TokenManager.hpp"
@@ -26,6 +27,7 @@ using namespace Hyprutils::String;
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <vector>
+#include <algorithm>
 #if defined(__linux__)
 #include <linux/vt.h>
 #elif defined(__NetBSD__) || defined(__OpenBSD__)
@@ -142,23 +144,98 @@ CKeybindManager::~CKeybindManager() {
         xkb_state_unref(m_pXKBTranslationState);
 }
 
+uint64_t CKeybindIndex::packKey(uint32_t modmask, uint32_t key) {
+    return ((uint64_t)modmask << 32) | key;
+}
+
+void CKeybindIndex::rebuild(std::list<SKeybind>& binds) {
+    m_mSubmaps.clear();
+
+    size_t order = 0;
+    for (auto& k : binds) {
+        k.order = order++;
+
+        auto&          submap  = m_mSubmaps[k.submap];
+        const uint32_t MODMASK = k.ignoreMods ? MODMASK_ANY : k.modmask;
+
+        if (k.multiKey) {
+            submap.always.push_back(&k);
+            continue;
+        }
+
+        // mirrors the match order in handleKeybinds: key name, keycode, catchall, keysym
+        submap.byName[k.key].push_back(&k);
+
+        if (k.keycode != 0)
+            submap.byKeycode[packKey(MODMASK, k.keycode)].push_back(&k);
+        else if (k.catchAll)
+            submap.always.push_back(&k);
+        else {
+            if (k.keysym != XKB_KEY_NoSymbol)
+                submap.byKeysym[packKey(MODMASK, k.keysym)].push_back(&k);
+            if (k.keysymCaseInsensitive != XKB_KEY_NoSymbol && k.keysymCaseInsensitive != k.keysym)
+                submap.byKeysym[packKey(MODMASK, k.keysymCaseInsensitive)].push_back(&k);
+        }
+    }
+}
+
+void CKeybindIndex::collect(const std::string& submap, uint32_t modmask, const SPressedKeyWithMods& key, std::vector<SKeybind*>& out) const {
+    const auto IT = m_mSubmaps.find(submap);
+
+    if (IT != m_mSubmaps.end()) {
+        const auto& BINDS = IT->second;
+
+        const auto  add = [&out](const auto& map, const auto& k) {
+            const auto FOUND = map.find(k);
+            if (FOUND != map.end())
+                out.insert(out.end(), FOUND->second.begin(), FOUND->second.end());
+        };
+
+        out.insert(out.end(), BINDS.always.begin(), BINDS.always.end());
+
+        if (!key.keyName.empty())
+            add(BINDS.byName, key.keyName);
+        else {
+            add(BINDS.byKeycode, packKey(modmask, key.keycode));
+            add(BINDS.byKeycode, packKey(MODMASK_ANY, key.keycode));
+
+            if (key.keysym != XKB_KEY_NoSymbol) {
+                add(BINDS.byKeysym, packKey(modmask, key.keysym));
+                add(BINDS.byKeysym, packKey(MODMASK_ANY, key.keysym));
+            }
+        }
+    }
+
+    std::ranges::sort(out, {}, [](const SKeybind* k) { return k->order; });
+    const auto [FIRST, LAST] = std::ranges::unique(out);
+    out.erase(FIRST, LAST);
+}
+
 void CKeybindManager::addKeybind(SKeybind kb) {
+    // resolve once here, not on every key event
+    kb.keysym                = xkb_keysym_from_name(kb.key.c_str(), XKB_KEYSYM_NO_FLAGS);
+    kb.keysymCaseInsensitive = xkb_keysym_from_name(kb.key.c_str(), XKB_KEYSYM_CASE_INSENSITIVE);
+    kb.keysymUpper           = xkb_keysym_to_upper(kb.keysymCaseInsensitive);
+    kb.specialDispatcher     = kb.handler == "global" || kb.handler == "pass" || kb.handler == "sendshortcut" || kb.handler == "mouse";
+
     m_lKeybinds.push_back(kb);
 
-    m_pActiveKeybind = nullptr;
+    m_pActiveKeybind     = nullptr;
+    m_bKeybindIndexDirty = true;
 }
 
 void CKeybindManager::removeKeybind(uint32_t mod, const SParsedKey& key) {
-    for (auto it = m_lKeybinds.begin(); it != m_lKeybinds.end(); ++it) {
+    for (auto it = m_lKeybinds.begin(); it != m_lKeybinds.end();) {
         if (it->modmask == mod && it->key == key.key && it->keycode == key.keycode && it->catchAll == key.catchAll) {
+            // held special binds are dereferenced on release
+            std::erase(m_vPressedSpecialBinds, &*it);
             it = m_lKeybinds.erase(it);
-
-            if (it == m_lKeybinds.end())
-                break;
-        }
+        } else
+            ++it;
     }
 
-    m_pActiveKeybind = nullptr;
+    m_pActiveKeybind     = nullptr;
+    m_bKeybindIndexDirty = true;
 }
 
 uint32_t CKeybindManager::stringToModMask(std::string mods) {
@@ -224,14 +301,15 @@ void CKeybindManager::updateXKBTranslationState() {
     const std::string VARIANT  = std::string{*PVARIANT} == STRVAL_EMPTY ? "" : *PVARIANT;
     const std::string OPTIONS  = std::string{*POPTIONS} == STRVAL_EMPTY ? "" : *POPTIONS;
 
-    xkb_rule_names    rules      = {.rules = RULES.c_str(), .model = MODEL.c_str(), .layout = LAYOUT.c_str(), .variant = VARIANT.c_str(), .options = OPTIONS.c_str()};
-    const auto        PCONTEXT   = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-    FILE* const       KEYMAPFILE = FILEPATH == "" ? NULL : fopen(absolutePath(FILEPATH, g_pConfigManager->configCurrentPath).c_str(), "r");
+    xkb_rule_names    rules = {.rules = RULES.c_str(), .model = MODEL.c_str(), .layout = LAYOUT.c_str(), .variant = VARIANT.c_str(), .options = OPTIONS.c_str()};
+
+    // the same keymap the keyboards use, it's only compiled once
+    SP<CKeymap> PKEYMAP;
+    if (FILEPATH != "")
+        PKEYMAP = g_pKeymapCache->fromFile(absolutePath(FILEPATH, g_pConfigManager->configCurrentPath));
 
-    auto              PKEYMAP = KEYMAPFILE ? xkb_keymap_new_from_file(PCONTEXT, KEYMAPFILE, XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS) :
-                                             xkb_keymap_new_from_names(PCONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
-    if (KEYMAPFILE)
-        fclose(KEYMAPFILE);
+    if (!PKEYMAP)
+        PKEYMAP = g_pKeymapCache->fromNames(rules);
 
     if (!PKEYMAP) {
         g_pHyprError->queueCreate("[Runtime Error] Invalid keyboard layout passed. ( rules: " + RULES + ", model: " + MODEL + ", variant: " + VARIANT + ", options: " + OPTIONS +
@@ -242,12 +320,15 @@ void CKeybindManager::updateXKBTranslationState() {
                    rules.rules, rules.model, rules.options);
         memset(&rules, 0, sizeof(rules));
 
-        PKEYMAP = xkb_keymap_new_from_names(PCONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        PKEYMAP = g_pKeymapCache->fromNames(rules);
     }
 
-    xkb_context_unref(PCONTEXT);
-    m_pXKBTranslationState = xkb_state_new(PKEYMAP);
-    xkb_keymap_unref(PKEYMAP);
+    if (!PKEYMAP) {
+        Debug::log(ERR, "[XKBTranslationState] The default keymap couldn't have been loaded either, binds won't translate");
+        return;
+    }
+
+    m_pXKBTranslationState = xkb_state_new(PKEYMAP->keymap());
 }
 
 bool CKeybindManager::ensureMouseBindState() {
@@ -620,8 +701,21 @@ SDispatchResult CKeybindManager::handleKeybinds(const uint32_t modmask, const SP
             m_sMkKeys.erase(key.keysym);
     }
 
-    for (auto& k : m_lKeybinds) {
-        const bool SPECIALDISPATCHER = k.handler == "global" || k.handler == "pass" || k.handler == "sendshortcut" || k.handler == "mouse";
+    if (m_bKeybindIndexDirty) {
+        m_keybindIndex.rebuild(m_lKeybinds);
+        m_bKeybindIndexDirty = false;
+    }
+
+    // released special binds are handled regardless of mods and submap, see IGNORECONDITIONS
+    std::vector<SKeybind*> candidates;
+    if (!pressed)
+        candidates = m_vPressedSpecialBinds;
+
+    m_keybindIndex.collect(m_szCurrentSelectedSubmap, modmask, key, candidates);
+
+    for (auto* const pBind : candidates) {
+        auto&      k                 = *pBind;
+        const bool SPECIALDISPATCHER = k.specialDispatcher;
         const bool SPECIALTRIGGERED =
             std::find_if(m_vPressedSpecialBinds.begin(), m_vPressedSpecialBinds.end(), [&](const auto& other) { return other == &k; }) != m_vPressedSpecialBinds.end();
         const bool IGNORECONDITIONS =
@@ -657,10 +751,8 @@ SDispatchResult CKeybindManager::handleKeybinds(const uint32_t modmask, const SP
             if (key.keysym == XKB_KEY_NoSymbol)
                 continue;
 
-            // oMg such performance hit!!11!
-            // this little maneouver is gonna cost us 4µs
-            const auto KBKEY      = xkb_keysym_from_name(k.key.c_str(), XKB_KEYSYM_NO_FLAGS);
-            const auto KBKEYLOWER = xkb_keysym_from_name(k.key.c_str(), XKB_KEYSYM_CASE_INSENSITIVE);
+            const auto KBKEY      = k.keysym;
+            const auto KBKEYLOWER = k.keysymCaseInsensitive;
 
             if (KBKEY == XKB_KEY_NoSymbol && KBKEYLOWER == XKB_KEY_NoSymbol) {
                 // Keysym failed to resolve from the key name of the currently iterated bind.
@@ -775,8 +867,8 @@ void CKeybindManager::shadowKeybinds(const xkb_keysym_t& doesntHave, const uint3
         if (k.multiKey && (mkBindMatches(k) == MK_FULL_MATCH))
             shadow = true;
         else {
-            const auto KBKEY      = xkb_keysym_from_name(k.key.c_str(), XKB_KEYSYM_CASE_INSENSITIVE);
-            const auto KBKEYUPPER = xkb_keysym_to_upper(KBKEY);
+            const auto KBKEY      = k.keysymCaseInsensitive;
+            const auto KBKEYUPPER = k.keysymUpper;
 
             for (auto const& pk : m_dPressedKeys) {
                 if ((pk.keysym != 0 && (pk.keysym == KBKEY || pk.keysym == KBKEYUPPER))) {
@@ -978,6 +1070,9 @@ SDispatchResult CKeybindManager::kill(std::string args) {
 
 void CKeybindManager::clearKeybinds() {
     m_lKeybinds.clear();
+    m_vPressedSpecialBinds.clear();
+    m_pActiveKeybind     = nullptr;
+    m_bKeybindIndexDirty = true;
 }
 
 static SDispatchResult toggleActiveFloatingCore(std::string args, std::optional<bool> floatState) {
@@ -2424,6 +2519,8 @@ SDispatchResult CKeybindManager::dpms(std::string arg) {
         if (isToggle)
             enable = !m->dpmsStatus;
 
+        g_pHyprRenderer->finishPendingCommit(m);
+
         m->output->state->resetExplicitFences();
         m->output->state->setEnabled(enable);
 
@@ -2887,6 +2984,7 @@ SDispatchResult CKeybindManager::moveGroupWindow(std::string args) {
     if ((!BACK && PLASTWINDOW->m_sGroupData.pNextWindow->m_sGroupData.head) || (BACK && PLASTWINDOW->m_sGroupData.head)) {
         std::swap(PLASTWINDOW->m_sGroupData.head, PLASTWINDOW->m_sGroupData.pNextWindow->m_sGroupData.head);
         std::swap(PLASTWINDOW->m_sGroupData.locked, PLASTWINDOW->m_sGroupData.pNextWindow->m_sGroupData.locked);
+        PLASTWINDOW->markGroupStateChanged();
     } else
         PLASTWINDOW->switchWithWindowInGroup(BACK ? PLASTWINDOW->getGroupPrevious() : PLASTWINDOW->m_sGroupData.pNextWindow.lock());
 
@@ -2981,6 +3079,7 @@ SDispatchResult CKeybindManager::setProp(std::string args) {
     } catch (std::exception& e) { return {.success = false, .error = std::format("Error parsing prop value: {}", std::string(e.what()))}; }
 
     g_pCompositor->updateAllWindowsAnimatedDecorationValues();
+    g_pCompositor->updateWindowHitIndex(PWINDOW);
 
     if (!(PWINDOW->m_sWindowData.noFocus.valueOrDefault() == noFocus)) {
         g_pCompositor->focusWindow(nullptr);
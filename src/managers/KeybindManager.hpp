@@ -14,6 +14,15 @@ class CConfigManager;
 class CPluginSystem;
 class IKeyboard;
 
+struct SPressedKeyWithMods {
+    std::string  keyName            = "";
+    xkb_keysym_t keysym             = 0;
+    uint32_t     keycode            = 0;
+    uint32_t     modmaskAtPressTime = 0;
+    bool         sent               = false;
+    std::string  submapAtPress      = "";
+};
+
 struct SKeybind {
     std::string            key            = "";
     std::set<xkb_keysym_t> sMkKeys        = {};
@@ -38,6 +47,37 @@ struct SKeybind {
 
     // DO NOT INITIALIZE
     bool shadowed = false;
+
+    // resolved in addKeybind
+    xkb_keysym_t keysym                = XKB_KEY_NoSymbol; // key as a keysym
+    xkb_keysym_t keysymCaseInsensitive = XKB_KEY_NoSymbol;
+    xkb_keysym_t keysymUpper           = XKB_KEY_NoSymbol; // upper of the case insensitive one
+    bool         specialDispatcher     = false;            // global, pass, sendshortcut, mouse
+    size_t       order                 = 0;                // position in m_lKeybinds, set by the index
+};
+
+/*
+    Binds of a submap, bucketed by (modmask, key) so a key event only looks at the binds it can trigger.
+    Binds with ignoreMods are bucketed under MODMASK_ANY. Candidates are returned in bind order.
+*/
+class CKeybindIndex {
+  public:
+    static constexpr uint32_t MODMASK_ANY = UINT32_MAX;
+
+    void                      rebuild(std::list<SKeybind>& binds);
+    void                      collect(const std::string& submap, uint32_t modmask, const SPressedKeyWithMods& key, std::vector<SKeybind*>& out) const;
+
+  private:
+    static uint64_t packKey(uint32_t modmask, uint32_t key);
+
+    struct SSubmapBinds {
+        std::unordered_map<uint64_t, std::vector<SKeybind*>>    byKeysym;
+        std::unordered_map<uint64_t, std::vector<SKeybind*>>    byKeycode;
+        std::unordered_map<std::string, std::vector<SKeybind*>> byName; // modmask is matched by the caller
+        std::vector<SKeybind*>                                  always; // multikey and catchall
+    };
+
+    std::unordered_map<std::string, SSubmapBinds> m_mSubmaps;
 };
 
 enum eFocusWindowMode {
@@ -50,15 +90,6 @@ enum eFocusWindowMode {
     MODE_ACTIVE_WINDOW
 };
 
-struct SPressedKeyWithMods {
-    std::string  keyName            = "";
-    xkb_keysym_t keysym             = 0;
-    uint32_t     keycode            = 0;
-    uint32_t     modmaskAtPressTime = 0;
-    bool         sent               = false;
-    std::string  submapAtPress      = "";
-};
-
 struct SParsedKey {
     std::string key      = "";
     uint32_t    keycode  = 0;
@@ -127,6 +158,9 @@ class CKeybindManager {
 
     std::vector<SKeybind*>          m_vPressedSpecialBinds;
 
+    CKeybindIndex                   m_keybindIndex;
+    bool                            m_bKeybindIndexDirty = true;
+
     int                             m_iPassPressed = -1; // used for pass
 
     CTimer                          m_tScrollTimer;
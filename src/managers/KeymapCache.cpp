@@ -0,0 +1,188 @@
+#include "KeymapCache.hpp"
+#include "../debug/Log.hpp"
+#include "../helpers/MiscFunctions.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+constexpr size_t KEYMAP_CACHE_MAX = 16;
+
+CKeymap::CKeymap(xkb_keymap* keymap) : m_pKeymap(keymap) {
+    ;
+}
+
+CKeymap::~CKeymap() {
+    if (m_pKeymap)
+        xkb_keymap_unref(m_pKeymap);
+
+    if (m_iFD.value_or(-1) >= 0)
+        close(*m_iFD);
+}
+
+xkb_keymap* CKeymap::keymap() const {
+    return m_pKeymap;
+}
+
+const std::string& CKeymap::string() {
+    if (m_szString)
+        return *m_szString;
+
+    const auto STR = xkb_keymap_get_as_string(m_pKeymap, XKB_KEYMAP_FORMAT_TEXT_V1);
+    m_szString     = STR ? std::string{STR} : std::string{};
+    free(STR);
+
+    return *m_szString;
+}
+
+int CKeymap::fd() {
+    if (m_iFD)
+        return *m_iFD;
+
+    m_iFD = -1;
+
+    const auto& STR  = string();
+    const auto  SIZE = STR.length() + 1;
+
+#ifdef MFD_ALLOW_SEALING
+    // one fd for all clients, they can't change it under each other
+    int fd = memfd_create("hyprland-keymap", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd >= 0) {
+        if (ftruncate(fd, SIZE) == 0 && pwrite(fd, STR.c_str(), SIZE, 0) == (ssize_t)SIZE &&
+            fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == 0) {
+            m_iFD = fd;
+            return fd;
+        }
+
+        Debug::log(ERR, "CKeymap: couldn't write a sealed memfd, falling back to shm");
+        close(fd);
+    }
+#endif
+
+    int rw, ro;
+    if (!allocateSHMFilePair(SIZE, &rw, &ro)) {
+        Debug::log(ERR, "CKeymap: failed to allocate shm pair for the keymap");
+        return -1;
+    }
+
+    auto dest = mmap(nullptr, SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, rw, 0);
+    close(rw);
+    if (dest == MAP_FAILED) {
+        Debug::log(ERR, "CKeymap: failed to mmap a shm pair for the keymap");
+        close(ro);
+        return -1;
+    }
+
+    memcpy(dest, STR.c_str(), STR.length());
+    munmap(dest, SIZE);
+    m_iFD = ro;
+
+    return ro;
+}
+
+CKeymapCache::CKeymapCache() {
+    m_pContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+
+    if (!m_pContext)
+        Debug::log(ERR, "CKeymapCache: couldn't create an xkb context, keymaps won't compile");
+}
+
+CKeymapCache::~CKeymapCache() {
+    // entries still in use outlive us, the context is refcounted by their keymaps
+    m_mKeymaps.clear();
+
+    if (m_pContext)
+        xkb_context_unref(m_pContext);
+}
+
+SP<CKeymap> CKeymapCache::find(const std::string& key) {
+    const auto IT = m_mKeymaps.find(key);
+
+    if (IT == m_mKeymaps.end())
+        return nullptr;
+
+    IT->second.lastUsed = ++m_iUses;
+    return IT->second.keymap;
+}
+
+SP<CKeymap> CKeymapCache::add(const std::string& key, SP<CKeymap> keymap) {
+    if (!keymap->keymap())
+        return nullptr;
+
+    if (m_mKeymaps.size() >= KEYMAP_CACHE_MAX) {
+        const auto OLDEST = std::min_element(m_mKeymaps.begin(), m_mKeymaps.end(), [](const auto& a, const auto& b) { return a.second.lastUsed < b.second.lastUsed; });
+        m_mKeymaps.erase(OLDEST);
+    }
+
+    m_mKeymaps[key] = SEntry{keymap, ++m_iUses};
+
+    return keymap;
+}
+
+SP<CKeymap> CKeymapCache::fromNames(const xkb_rule_names& names) {
+    const auto KEY = std::format("names:{}\n{}\n{}\n{}\n{}", names.rules ? names.rules : "", names.model ? names.model : "", names.layout ? names.layout : "",
+                                 names.variant ? names.variant : "", names.options ? names.options : "");
+
+    if (const auto CACHED = find(KEY); CACHED)
+        return CACHED;
+
+    if (!m_pContext)
+        return nullptr;
+
+    Debug::log(LOG, "CKeymapCache: compiling a keymap for layout {} with variant {} (rules: {}, model: {}, options: {})", names.layout ? names.layout : "",
+               names.variant ? names.variant : "", names.rules ? names.rules : "", names.model ? names.model : "", names.options ? names.options : "");
+
+    return add(KEY, makeShared<CKeymap>(xkb_keymap_new_from_names(m_pContext, &names, XKB_KEYMAP_COMPILE_NO_FLAGS)));
+}
+
+SP<CKeymap> CKeymapCache::fromFile(const std::string& path) {
+    std::ifstream ifs(path);
+
+    if (!ifs.good()) {
+        Debug::log(ERR, "CKeymapCache: cannot open {} for reading", path);
+        return nullptr;
+    }
+
+    std::stringstream text;
+    text << ifs.rdbuf();
+
+    return fromString(text.str());
+}
+
+SP<CKeymap> CKeymapCache::fromString(const std::string& text) {
+    // the whole text, not a hash of it: different keymaps never share an entry
+    const auto KEY = "text:" + text;
+
+    if (const auto CACHED = find(KEY); CACHED)
+        return CACHED;
+
+    if (!m_pContext)
+        return nullptr;
+
+    Debug::log(LOG, "CKeymapCache: compiling a keymap of {} bytes", text.length());
+
+    return add(KEY, makeShared<CKeymap>(xkb_keymap_new_from_string(m_pContext, text.c_str(), XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS)));
+}
+
+SP<CKeymap> CKeymapCache::fromKeymap(xkb_keymap* keymap) {
+    // usually, it came from here
+    for (auto& [key, entry] : m_mKeymaps) {
+        if (entry.keymap->keymap() != keymap)
+            continue;
+
+        entry.lastUsed = ++m_iUses;
+        return entry.keymap;
+    }
+
+    auto       newKeymap = makeShared<CKeymap>(xkb_keymap_ref(keymap));
+    const auto KEY       = "text:" + newKeymap->string();
+
+    // the same text compiled by someone else, reuse its fd
+    if (const auto CACHED = find(KEY); CACHED)
+        return CACHED;
+
+    return add(KEY, newKeymap);
+}
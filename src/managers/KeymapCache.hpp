@@ -0,0 +1,58 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <xkbcommon/xkbcommon.h>
+
+#include "../helpers/memory/Memory.hpp"
+
+/*
+    A compiled keymap shared by every keyboard using it, with its serialized form and the fd clients get it from.
+*/
+class CKeymap {
+  public:
+    CKeymap(xkb_keymap* keymap); // takes over the reference
+    ~CKeymap();
+
+    xkb_keymap*        keymap() const;
+    const std::string& string(); // serialized once
+    int                fd();     // a sealed, read only memfd of string(), made once. -1 if that failed
+
+  private:
+    xkb_keymap*                m_pKeymap = nullptr;
+    std::optional<std::string> m_szString;
+    std::optional<int>         m_iFD;
+};
+
+/*
+    Keymaps are compiled once per RMLVO set or keymap text, for all keyboards, virtual ones, and the keybind translation state.
+    The last KEYMAP_CACHE_MAX used ones are kept around, so reloads and hotplugs don't compile anything they had before.
+*/
+class CKeymapCache {
+  public:
+    CKeymapCache();
+    ~CKeymapCache();
+
+    // nullptr if it doesn't compile
+    SP<CKeymap> fromNames(const xkb_rule_names& names);
+    SP<CKeymap> fromFile(const std::string& path);
+    SP<CKeymap> fromString(const std::string& text);
+    // for keymaps compiled elsewhere. Never nullptr
+    SP<CKeymap> fromKeymap(xkb_keymap* keymap);
+
+  private:
+    struct SEntry {
+        SP<CKeymap> keymap;
+        uint64_t    lastUsed = 0;
+    };
+
+    SP<CKeymap>                             find(const std::string& key);
+    SP<CKeymap>                             add(const std::string& key, SP<CKeymap> keymap); // nullptr if it didn't compile
+
+    xkb_context*                            m_pContext = nullptr;
+    std::unordered_map<std::string, SEntry> m_mKeymaps;
+    uint64_t                                m_iUses = 0;
+};
+
+inline std::unique_ptr<CKeymapCache> g_pKeymapCache;
@@ -0,0 +1,234 @@
+#include "ProcessManager.hpp"
+#include "../Compositor.hpp"
+#include "../helpers/MiscFunctions.hpp"
+#include "../helpers/varlist/VarList.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// without pidfds, dead processes are only noticed when looked up again
+constexpr size_t PROCESS_CACHE_MAX = 1024;
+
+// ppid and start time, from /proc/<pid>/stat
+static bool readStat(pid_t pid, pid_t& ppid, uint64_t& startTime) {
+#ifdef __linux__
+    std::ifstream ifs("/proc/" + std::to_string(pid) + "/stat");
+    std::string   stat;
+
+    if (!ifs.good() || !std::getline(ifs, stat))
+        return false;
+
+    // the name is in parens and can have anything in it, the fields we want come after it
+    const auto NAMEEND = stat.rfind(')');
+    if (NAMEEND == std::string::npos || NAMEEND + 2 >= stat.size())
+        return false;
+
+    std::istringstream fields(stat.substr(NAMEEND + 2));
+    std::string        field;
+
+    // state, then ppid, then 17 fields to the start time
+    fields >> field >> ppid;
+    for (size_t i = 0; i < 17; ++i) {
+        fields >> field;
+    }
+    fields >> startTime;
+
+    return !fields.fail();
+#else
+    ppid      = getPPIDof(pid);
+    startTime = 0;
+    return ppid != 0;
+#endif
+}
+
+static int pidfdOpen(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return syscall(SYS_pidfd_open, pid, 0);
+#else
+    return -1;
+#endif
+}
+
+int onProcessExit(int fd, uint32_t mask, void* data) {
+    const auto PID = (pid_t)(intptr_t)data;
+
+    g_pProcessManager->remove(PID);
+
+    // children were reparented, read their parent again
+    std::vector<pid_t> children;
+    for (auto const& [pid, process] : g_pProcessManager->m_mProcesses) {
+        if (process.ppid == PID)
+            children.push_back(pid);
+    }
+
+    for (auto const& c : children) {
+        g_pProcessManager->remove(c);
+    }
+
+    return 0;
+}
+
+CProcessManager::CProcessManager() {
+    m_pOpenWindowHook = g_pHookSystem->hookDynamic("openWindow", [this](void* self, SCallbackInfo& info, std::any param) {
+        const auto PWINDOW = std::any_cast<PHLWINDOW>(param);
+        m_mWindows[PWINDOW->getPID()].emplace_back(PWINDOW);
+    });
+
+    m_pCloseWindowHook = g_pHookSystem->hookDynamic("closeWindow", [this](void* self, SCallbackInfo& info, std::any param) {
+        const auto PWINDOW = std::any_cast<PHLWINDOW>(param);
+
+        // the pid can't be asked for anymore at this point
+        for (auto& [pid, windows] : m_mWindows) {
+            std::erase_if(windows, [PWINDOW](const auto& w) { return w.expired() || w.lock() == PWINDOW; });
+        }
+
+        std::erase_if(m_mWindows, [](const auto& e) { return e.second.empty(); });
+    });
+}
+
+CProcessManager::~CProcessManager() {
+    for (auto& [pid, process] : m_mProcesses) {
+        if (process.exitSource)
+            wl_event_source_remove(process.exitSource);
+        if (process.pidfd >= 0)
+            close(process.pidfd);
+    }
+}
+
+CProcessManager::SProcess* CProcessManager::get(pid_t pid) {
+    if (pid <= 0)
+        return nullptr;
+
+    const auto IT = m_mProcesses.find(pid);
+
+    // removed once it exits
+    if (IT != m_mProcesses.end() && IT->second.pidfd >= 0)
+        return &IT->second;
+
+    pid_t    ppid      = 0;
+    uint64_t startTime = 0;
+
+    if (!readStat(pid, ppid, startTime)) {
+        remove(pid);
+        return nullptr;
+    }
+
+    if (IT != m_mProcesses.end() && IT->second.startTime == startTime) {
+        IT->second.ppid = ppid;
+        return &IT->second;
+    }
+
+    // new, or the pid was reused
+    remove(pid);
+
+    if (m_mProcesses.size() >= PROCESS_CACHE_MAX)
+        std::erase_if(m_mProcesses, [](const auto& e) { return e.second.pidfd < 0; });
+
+    auto& process     = m_mProcesses[pid];
+    process.ppid      = ppid;
+    process.startTime = startTime;
+    process.pidfd     = pidfdOpen(pid);
+
+    if (process.pidfd < 0)
+        return &process;
+
+    // it could've exited and had its pid reused before we opened it
+    pid_t    ppidNow      = 0;
+    uint64_t startTimeNow = 0;
+    if (!readStat(pid, ppidNow, startTimeNow) || startTimeNow != startTime) {
+        remove(pid);
+        return nullptr;
+    }
+
+    process.exitSource = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, process.pidfd, WL_EVENT_READABLE, ::onProcessExit, (void*)(intptr_t)pid);
+
+    if (!process.exitSource) {
+        close(process.pidfd);
+        process.pidfd = -1;
+    }
+
+    return &process;
+}
+
+void CProcessManager::remove(pid_t pid) {
+    const auto IT = m_mProcesses.find(pid);
+
+    if (IT == m_mProcesses.end())
+        return;
+
+    if (IT->second.exitSource)
+        wl_event_source_remove(IT->second.exitSource);
+    if (IT->second.pidfd >= 0)
+        close(IT->second.pidfd);
+
+    m_mProcesses.erase(IT);
+}
+
+pid_t CProcessManager::getPPID(pid_t pid) {
+    const auto PPROCESS = get(pid);
+    return PPROCESS ? PPROCESS->ppid : 0;
+}
+
+const std::unordered_map<std::string, std::string>& CProcessManager::getEnv(pid_t pid) {
+    static const std::unordered_map<std::string, std::string> EMPTY;
+
+    const auto                                                 PPROCESS = get(pid);
+
+    if (!PPROCESS)
+        return EMPTY;
+
+    if (PPROCESS->env)
+        return *PPROCESS->env;
+
+    auto&         results = PPROCESS->env.emplace();
+
+    std::ifstream ifs("/proc/" + std::to_string(pid) + "/environ", std::ios::binary);
+
+    if (!ifs.good())
+        return results;
+
+    std::vector<char> buffer;
+    size_t            needle = 0;
+    buffer.resize(512, '\0');
+    while (ifs.read(buffer.data() + needle, 512)) {
+        buffer.resize(buffer.size() + 512, '\0');
+        needle += 512;
+    }
+
+    if (needle <= 1)
+        return results;
+
+    std::replace(buffer.begin(), buffer.end() - 1, '\0', '\n');
+
+    CVarList envs(std::string{buffer.data(), buffer.size() - 1}, 0, '\n', true);
+
+    for (auto const& e : envs) {
+        if (!e.contains('='))
+            continue;
+
+        const auto EQ            = e.find_first_of('=');
+        results[e.substr(0, EQ)] = e.substr(EQ + 1);
+    }
+
+    return results;
+}
+
+std::vector<PHLWINDOW> CProcessManager::getWindows(pid_t pid) {
+    std::vector<PHLWINDOW> windows;
+
+    const auto             IT = m_mWindows.find(pid);
+
+    if (IT == m_mWindows.end())
+        return windows;
+
+    for (auto const& w : IT->second) {
+        const auto PWINDOW = w.lock();
+
+        if (PWINDOW && PWINDOW->m_bIsMapped)
+            windows.push_back(PWINDOW);
+    }
+
+    return windows;
+}
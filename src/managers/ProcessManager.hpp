@@ -0,0 +1,53 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/types.h>
+
+#include "../desktop/DesktopTypes.hpp"
+#include "HookSystemManager.hpp"
+
+struct wl_event_source;
+
+/*
+    Caches what window mapping needs to know about processes: their parents for swallowing and exec rules, and their environment.
+    A process is read from /proc once. Its entry goes away when it exits, which a pidfd tells us,
+    or, without pidfds, when its start time no longer matches the one of the pid.
+*/
+class CProcessManager {
+  public:
+    CProcessManager();
+    ~CProcessManager();
+
+    // 0 if unknown or gone
+    pid_t                                               getPPID(pid_t pid);
+    // /proc/<pid>/environ, empty if unknown or gone
+    const std::unordered_map<std::string, std::string>& getEnv(pid_t pid);
+    // mapped windows of a process
+    std::vector<PHLWINDOW>                              getWindows(pid_t pid);
+
+  private:
+    struct SProcess {
+        pid_t                                                       ppid      = 0;
+        uint64_t                                                    startTime = 0; // in clock ticks after boot, 0 if unknown
+        std::optional<std::unordered_map<std::string, std::string>> env;
+
+        int                                                         pidfd      = -1;
+        wl_event_source*                                            exitSource = nullptr;
+    };
+
+    SProcess*                                            get(pid_t pid); // nullptr if it's gone
+    void                                                 remove(pid_t pid);
+
+    std::unordered_map<pid_t, SProcess>                  m_mProcesses;
+    std::unordered_map<pid_t, std::vector<PHLWINDOWREF>> m_mWindows;
+
+    SP<HOOK_CALLBACK_FN>                                 m_pOpenWindowHook;
+    SP<HOOK_CALLBACK_FN>                                 m_pCloseWindowHook;
+
+    friend int onProcessExit(int fd, uint32_t mask, void* data);
+};
+
+inline std::unique_ptr<CProcessManager> g_pProcessManager;
@@ -2,9 +2,18 @@
 #include "../debug/HyprCtl.hpp"
 #include "../Compositor.hpp"
 #include "../config/ConfigValue.hpp"
+#include <cstring>
+#include <filesystem>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 
 int slowUpdate = 0;
 
+// editors save in a few steps, reload once they're done
+constexpr int CONFIG_WATCH_DEBOUNCE_MS = 50;
+
 int handleTimer(void* data) {
     const auto  PTM = (CThreadManager*)data;
 
@@ -13,7 +22,65 @@ int handleTimer(void* data) {
     if (*PDISABLECFGRELOAD != 1)
         g_pConfigManager->tick();
 
-    wl_event_source_timer_update(PTM->m_esConfigTimer, 1000);
+    // a dir that's gone might be back
+    if (PTM->m_iConfigWatchFD >= 0 && PTM->m_bConfigWatchIncomplete)
+        PTM->updateConfigWatch();
+
+    // with a complete watch, changes arm the timer
+    if (PTM->m_iConfigWatchFD < 0 || PTM->m_bConfigWatchIncomplete)
+        wl_event_source_timer_update(PTM->m_esConfigTimer, 1000);
+
+    return 0;
+}
+
+int handleConfigWatch(int fd, uint32_t mask, void* data) {
+#ifdef __linux__
+    const auto PTM = (CThreadManager*)data;
+
+    alignas(inotify_event) char buffer[4096];
+    ssize_t                     len     = 0;
+    bool                        changed = false;
+    bool                        rewatch = false;
+
+    while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+        for (char* p = buffer; p < buffer + len;) {
+            const auto EVENT = (inotify_event*)p;
+            p += sizeof(inotify_event) + EVENT->len;
+
+            // lost events, could've been ours
+            if (EVENT->mask & IN_Q_OVERFLOW) {
+                changed = true;
+                continue;
+            }
+
+            const auto DIR = PTM->m_mConfigWatchDirs.find(EVENT->wd);
+
+            if (DIR == PTM->m_mConfigWatchDirs.end())
+                continue;
+
+            // the dir itself is gone or elsewhere, and its watch with it
+            if (EVENT->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+                changed = true;
+                rewatch = true;
+                continue;
+            }
+
+            if (EVENT->len == 0)
+                continue;
+
+            if (PTM->m_sConfigWatchFiles.contains(DIR->second + "/" + EVENT->name))
+                changed = true;
+        }
+    }
+
+    if (rewatch)
+        PTM->updateConfigWatch();
+
+    if (changed) {
+        g_pConfigManager->m_bFilesChanged = true;
+        wl_event_source_timer_update(PTM->m_esConfigTimer, CONFIG_WATCH_DEBOUNCE_MS);
+    }
+#endif
 
     return 0;
 }
@@ -21,10 +88,82 @@ int handleTimer(void* data) {
 CThreadManager::CThreadManager() {
     m_esConfigTimer = wl_event_loop_add_timer(g_pCompositor->m_sWLEventLoop, handleTimer, this);
 
-    wl_event_source_timer_update(m_esConfigTimer, 1000);
+#ifdef __linux__
+    m_iConfigWatchFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_iConfigWatchFD >= 0)
+        m_esConfigWatch = wl_event_loop_add_fd(g_pCompositor->m_sWLEventLoop, m_iConfigWatchFD, WL_EVENT_READABLE, handleConfigWatch, this);
+#endif
+
+    if (!m_esConfigWatch) {
+        Debug::log(WARN, "Couldn't watch the config with inotify, checking it every second instead");
+
+        if (m_iConfigWatchFD >= 0)
+            close(m_iConfigWatchFD);
+        m_iConfigWatchFD = -1;
+
+        wl_event_source_timer_update(m_esConfigTimer, 1000);
+        return;
+    }
+
+    updateConfigWatch();
+
+    // sourced files can come and go
+    m_pConfigReloadedHook = g_pHookSystem->hookDynamic("configReloaded", [this](void* self, SCallbackInfo& info, std::any param) { updateConfigWatch(); });
 }
 
 CThreadManager::~CThreadManager() {
     if (m_esConfigTimer)
         wl_event_source_remove(m_esConfigTimer);
-}
\ No newline at end of file
+    if (m_esConfigWatch)
+        wl_event_source_remove(m_esConfigWatch);
+    if (m_iConfigWatchFD >= 0)
+        close(m_iConfigWatchFD);
+}
+
+void CThreadManager::updateConfigWatch() {
+#ifdef __linux__
+    for (auto const& [wd, dir] : m_mConfigWatchDirs) {
+        inotify_rm_watch(m_iConfigWatchFD, wd);
+    }
+
+    m_mConfigWatchDirs.clear();
+    m_sConfigWatchFiles.clear();
+
+    const bool WASINCOMPLETE = m_bConfigWatchIncomplete;
+    m_bConfigWatchIncomplete = false;
+
+    const auto watch = [this, WASINCOMPLETE](const std::filesystem::path& path) {
+        // one wd per dir however it's reached, so the dir has to be spelled the same way every time
+        std::error_code ec;
+        const auto      CANONICALDIR = std::filesystem::weakly_canonical(path.parent_path(), ec);
+        const auto      DIR          = ec ? path.parent_path().string() : CANONICALDIR.string();
+
+        // a deleted or recreated file is a change too, the dir going away needs a new watch
+        const auto WD = inotify_add_watch(m_iConfigWatchFD, DIR.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_DELETE_SELF | IN_MOVE_SELF);
+
+        if (WD < 0) {
+            // retried every second, only say it once
+            if (!WASINCOMPLETE)
+                Debug::log(WARN, "Couldn't watch {} for config changes, checking it every second instead: {}", DIR, strerror(errno));
+
+            m_bConfigWatchIncomplete = true;
+            return;
+        }
+
+        m_mConfigWatchDirs[WD] = DIR;
+        m_sConfigWatchFiles.insert(DIR + "/" + path.filename().string());
+    };
+
+    for (auto const& cf : g_pConfigManager->getConfigPaths()) {
+        const auto PATH = std::filesystem::path(cf).lexically_normal();
+
+        watch(PATH);
+
+        // for symlinked configs, changes happen where they point to
+        std::error_code ec;
+        const auto      CANONICAL = std::filesystem::canonical(PATH, ec);
+        if (!ec && CANONICAL != PATH)
+            watch(CANONICAL);
+    }
+#endif
+}
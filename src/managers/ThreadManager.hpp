@@ -2,6 +2,8 @@
 
 #include "../defines.hpp"
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include "../Compositor.hpp"
 
 class CThreadManager {
@@ -12,6 +14,18 @@ class CThreadManager {
     wl_event_source* m_esConfigTimer;
 
   private:
+    void                                 updateConfigWatch(); // watches the dirs of all config files, editors often replace them
+
+    int                                  m_iConfigWatchFD         = -1; // inotify. -1 if we stat every second instead
+    wl_event_source*                     m_esConfigWatch          = nullptr;
+    bool                                 m_bConfigWatchIncomplete = false; // a dir couldn't be watched, stat every second until it can
+    std::unordered_map<int, std::string> m_mConfigWatchDirs;  // wd -> canonical dir
+    std::unordered_set<std::string>      m_sConfigWatchFiles; // canonical dir + filename
+
+    SP<HOOK_CALLBACK_FN>                 m_pConfigReloadedHook;
+
+    friend int handleTimer(void* data);
+    friend int handleConfigWatch(int fd, uint32_t mask, void* data);
 };
 
-inline std::unique_ptr<CThreadManager> g_pThreadManager;
\ No newline at end of file
+inline std::unique_ptr<CThreadManager> g_pThreadManager;
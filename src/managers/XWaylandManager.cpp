@@ -132,8 +132,18 @@ void CHyprXWaylandManager::setWindowSize(PHLWINDOW pWindow, Vector2D size, bool
         windowPos += PMONITOR->vecXWaylandPosition; // move to correct position for xwayland
     }
 
-    if (!force && pWindow->m_vPendingReportedSize == size && (windowPos == pWindow->m_vReportedPosition || !pWindow->m_bIsX11))
+    if (!force && pWindow->m_vPendingReportedSize == size && (windowPos == pWindow->m_vReportedPosition || !pWindow->m_bIsX11)) {
+        pWindow->m_vQueuedSize.reset();
         return;
+    }
+
+    // slow clients can't keep up with a size every frame when animating or resizing, send them the newest size once they ack the last one
+    if (!force && !pWindow->m_bIsX11 && pWindow->configureInFlight()) {
+        pWindow->m_vQueuedSize = size;
+        return;
+    }
+
+    pWindow->m_vQueuedSize.reset();
 
     pWindow->m_vReportedPosition    = windowPos;
     pWindow->m_vPendingReportedSize = size;
@@ -147,8 +157,10 @@ void CHyprXWaylandManager::setWindowSize(PHLWINDOW pWindow, Vector2D size, bool
 
     if (pWindow->m_bIsX11)
         pWindow->m_pXWaylandSurface->configure({windowPos, size});
-    else if (pWindow->m_pXDGSurface->toplevel)
+    else if (pWindow->m_pXDGSurface->toplevel) {
         pWindow->m_vPendingSizeAcks.emplace_back(pWindow->m_pXDGSurface->toplevel->setSize(size), size.floor());
+        pWindow->m_tConfigureSent.reset();
+    }
 }
 
 bool CHyprXWaylandManager::shouldBeFloated(PHLWINDOW pWindow, bool pending) {
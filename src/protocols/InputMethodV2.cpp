@@ -33,25 +33,13 @@ void CInputMethodKeyboardGrabV2::sendKeyboardData(SP<IKeyboard> keyboard) {
 
     pLastKeyboard = keyboard;
 
-    int keymapFD = allocateSHMFile(keyboard->xkbKeymapString.length() + 1);
-    if (keymapFD < 0) {
-        LOGM(ERR, "Failed to create a keymap file for keyboard grab");
+    // the keyboard's shared, read only keymap fd
+    if (keyboard->xkbKeymapFD < 0) {
+        LOGM(ERR, "No keymap file for keyboard grab");
         return;
     }
 
-    void* data = mmap(nullptr, keyboard->xkbKeymapString.length() + 1, PROT_READ | PROT_WRITE, MAP_SHARED, keymapFD, 0);
-    if (data == MAP_FAILED) {
-        LOGM(ERR, "Failed to mmap a keymap file for keyboard grab");
-        close(keymapFD);
-        return;
-    }
-
-    memcpy(data, keyboard->xkbKeymapString.c_str(), keyboard->xkbKeymapString.length());
-    munmap(data, keyboard->xkbKeymapString.length() + 1);
-
-    resource->sendKeymap(WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1, keymapFD, keyboard->xkbKeymapString.length() + 1);
-
-    close(keymapFD);
+    resource->sendKeymap(WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1, keyboard->xkbKeymapFD, keyboard->xkbKeymapString.length() + 1);
 
     sendMods(keyboard->modifiersState.depressed, keyboard->modifiersState.latched, keyboard->modifiersState.locked, keyboard->modifiersState.group);
 
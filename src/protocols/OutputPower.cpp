@@ -13,6 +13,8 @@ COutputPower::COutputPower(SP<CZwlrOutputPowerV1> resource_, PHLMONITOR pMonitor
         if (!pMonitor)
             return;
 
+        g_pHyprRenderer->finishPendingCommit(pMonitor.lock());
+
         pMonitor->dpmsStatus = mode == ZWLR_OUTPUT_POWER_V1_MODE_ON;
 
         pMonitor->output->state->setEnabled(mode == ZWLR_OUTPUT_POWER_V1_MODE_ON);
@@ -1,6 +1,8 @@
 #include "VirtualKeyboard.hpp"
 #include <sys/mman.h>
 #include "../devices/IKeyboard.hpp"
+#include "../managers/KeymapCache.hpp"
+#include <cstring>
 
 CVirtualKeyboardV1Resource::CVirtualKeyboardV1Resource(SP<CZwpVirtualKeyboardV1> resource_) : resource(resource_) {
     if (!good())
@@ -51,41 +53,30 @@ CVirtualKeyboardV1Resource::CVirtualKeyboardV1Resource(SP<CZwpVirtualKeyboardV1>
     });
 
     resource->setKeymap([this](CZwpVirtualKeyboardV1* r, uint32_t fmt, int32_t fd, uint32_t len) {
-        auto xkbContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-        if (!xkbContext) {
-            LOGM(ERR, "xkbContext creation failed");
-            r->noMemory();
-            close(fd);
-            return;
-        }
-
         auto keymapData = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
         if (keymapData == MAP_FAILED) {
             LOGM(ERR, "keymapData alloc failed");
-            xkb_context_unref(xkbContext);
             r->noMemory();
             close(fd);
             return;
         }
 
-        auto xkbKeymap = xkb_keymap_new_from_string(xkbContext, (const char*)keymapData, XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        // clients like to send the same keymap again, compile it once
+        const auto KEYMAP = g_pKeymapCache->fromString(std::string{(const char*)keymapData, strnlen((const char*)keymapData, len)});
         munmap(keymapData, len);
 
-        if (!xkbKeymap) {
+        if (!KEYMAP) {
             LOGM(ERR, "xkbKeymap creation failed");
-            xkb_context_unref(xkbContext);
             r->noMemory();
             close(fd);
             return;
         }
 
         events.keymap.emit(IKeyboard::SKeymapEvent{
-            .keymap = xkbKeymap,
+            .keymap = KEYMAP->keymap(),
         });
         hasKeymap = true;
 
-        xkb_keymap_unref(xkbKeymap);
-        xkb_context_unref(xkbContext);
         close(fd);
     });
 
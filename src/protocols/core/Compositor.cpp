@@ -152,6 +152,8 @@ CWLSurfaceResource::~CWLSurfaceResource() {
 }
 
 void CWLSurfaceResource::destroy() {
+    invalidateSurfaceTree();
+
     if (mapped) {
         events.unmap.emit();
         unmap();
@@ -250,9 +252,12 @@ void CWLSurfaceResource::frame(timespec* now) {
 
 void CWLSurfaceResource::resetRole() {
     role = makeShared<CDefaultSurfaceRole>();
+
+    // it's no longer in its parent's tree, and is the root of its own
+    invalidateSurfaceTree(true);
 }
 
-void CWLSurfaceResource::bfHelper(std::vector<SP<CWLSurfaceResource>> const& nodes, std::function<void(SP<CWLSurfaceResource>, const Vector2D&, void*)> fn, void* data) {
+void CWLSurfaceResource::bfHelper(std::vector<SP<CWLSurfaceResource>> const& nodes, std::vector<SSurfaceTreeNode>& tree) {
 
     std::vector<SP<CWLSurfaceResource>> nodes2;
     nodes2.reserve(nodes.size() * 2);
@@ -271,7 +276,7 @@ void CWLSurfaceResource::bfHelper(std::vector<SP<CWLSurfaceResource>> const& nod
     }
 
     if (!nodes2.empty())
-        bfHelper(nodes2, fn, data);
+        bfHelper(nodes2, tree);
 
     nodes2.clear();
 
@@ -282,7 +287,12 @@ void CWLSurfaceResource::bfHelper(std::vector<SP<CWLSurfaceResource>> const& nod
             offset          = subsurface->posRelativeToParent();
         }
 
-        fn(n, offset, data);
+        tree.emplace_back(SSurfaceTreeNode{
+            .surface = n,
+            .offset  = offset,
+            .box     = CBox{offset, n->current.size},
+            .input   = n->current.input.copy().intersect(CBox{{}, n->current.size}).translate(offset),
+        });
     }
 
     for (auto const& n : nodes) {
@@ -296,30 +306,96 @@ void CWLSurfaceResource::bfHelper(std::vector<SP<CWLSurfaceResource>> const& nod
     }
 
     if (!nodes2.empty())
-        bfHelper(nodes2, fn, data);
+        bfHelper(nodes2, tree);
+}
+
+SP<std::vector<CWLSurfaceResource::SSurfaceTreeNode>> CWLSurfaceResource::surfaceTree() {
+    if (surfaceTreeCache)
+        return surfaceTreeCache;
+
+    surfaceTreeCache = makeShared<std::vector<SSurfaceTreeNode>>();
+    bfHelper({self.lock()}, *surfaceTreeCache);
+
+    return surfaceTreeCache;
+}
+
+void CWLSurfaceResource::invalidateSurfaceTree(bool withChildren) {
+    const auto SELF = self.lock();
+
+    if (!SELF)
+        return;
+
+    // cycles are possible, see CWLSubsurfaceResource::posRelativeToParent
+    std::vector<SP<CWLSurfaceResource>> surfacesVisited;
+
+    // the trees this surface is in
+    for (auto surf = SELF; surf && std::find(surfacesVisited.begin(), surfacesVisited.end(), surf) == surfacesVisited.end();) {
+        surfacesVisited.emplace_back(surf);
+        surf->surfaceTreeCache.reset();
+
+        if (surf->role->role() != SURFACE_ROLE_SUBSURFACE)
+            break;
+
+        auto subsurface = ((CSubsurfaceRole*)surf->role.get())->subsurface.lock();
+        if (!subsurface)
+            break;
+
+        surf = subsurface->parent.lock();
+    }
+
+    if (!withChildren)
+        return;
+
+    // offsets are relative to the root, so the trees of our subsurfaces moved with us
+    std::vector<SP<CWLSurfaceResource>> toVisit = {SELF};
+
+    while (!toVisit.empty()) {
+        const auto SURF = toVisit.back();
+        toVisit.pop_back();
+
+        for (auto const& c : SURF->subsurfaces) {
+            if (c.expired() || c->surface.expired())
+                continue;
+
+            auto child = c->surface.lock();
+
+            if (std::find(surfacesVisited.begin(), surfacesVisited.end(), child) != surfacesVisited.end())
+                continue;
+
+            surfacesVisited.emplace_back(child);
+            child->surfaceTreeCache.reset();
+            toVisit.emplace_back(child);
+        }
+    }
 }
 
 void CWLSurfaceResource::breadthfirst(std::function<void(SP<CWLSurfaceResource>, const Vector2D&, void*)> fn, void* data) {
-    std::vector<SP<CWLSurfaceResource>> surfs;
-    surfs.push_back(self.lock());
-    bfHelper(surfs, fn, data);
+    // keeps this tree alive if fn changes it
+    const auto TREE = surfaceTree();
+
+    for (auto const& n : *TREE) {
+        const auto SURF = n.surface.lock();
+
+        if (!SURF)
+            continue;
+
+        fn(SURF, n.offset, data);
+    }
 }
 
 std::pair<SP<CWLSurfaceResource>, Vector2D> CWLSurfaceResource::at(const Vector2D& localCoords, bool allowsInput) {
-    std::vector<std::pair<SP<CWLSurfaceResource>, Vector2D>> surfs;
-    breadthfirst([](SP<CWLSurfaceResource> surf, const Vector2D& offset,
-                    void* data) { ((std::vector<std::pair<SP<CWLSurfaceResource>, Vector2D>>*)data)->emplace_back(std::make_pair<>(surf, offset)); },
-                 &surfs);
+    const auto TREE = surfaceTree();
+
+    for (auto const& n : *TREE | std::views::reverse) {
+        if (n.surface.expired())
+            continue;
 
-    for (auto const& [surf, pos] : surfs | std::views::reverse) {
         if (!allowsInput) {
-            const auto BOX = CBox{pos, surf->current.size};
-            if (BOX.containsPoint(localCoords))
-                return {surf, localCoords - pos};
+            if (n.box.containsPoint(localCoords))
+                return {n.surface.lock(), localCoords - n.offset};
         } else {
-            const auto REGION = surf->current.input.copy().intersect(CBox{{}, surf->current.size}).translate(pos);
-            if (REGION.containsPoint(localCoords))
-                return {surf, localCoords - pos};
+            if (n.input.containsPoint(localCoords))
+                return {n.surface.lock(), localCoords - n.offset};
         }
     }
 
@@ -429,6 +505,9 @@ void CWLSurfaceResource::commitPendingState() {
     pending.bufferDamage.clear();
     pending.newBuffer = false;
 
+    // sizes and input regions in the trees are stale
+    invalidateSurfaceTree();
+
     events.roleCommit.emit();
 
     if (syncobj && syncobj->current.releaseTimeline && syncobj->current.releaseTimeline->timeline && current.buffer && current.buffer->buffer)
@@ -132,23 +132,38 @@ class CWLSurfaceResource {
     // localCoords param is relative to 0,0 of this surface
     std::pair<SP<CWLSurfaceResource>, Vector2D> at(const Vector2D& localCoords, bool allowsInput = false);
 
+    struct SSurfaceTreeNode {
+        WP<CWLSurfaceResource> surface;
+        Vector2D               offset; // relative to the root surface
+        CBox                   box;    // offset and size
+        CRegion                input;  // the input region, clipped to the size, at offset
+    };
+
+    // this surface and its subsurfaces, in the order breadthfirst visits them (lowest -> highest).
+    // Built once, until a surface in it commits, or subsurfaces are added, removed, moved or restacked.
+    SP<std::vector<SSurfaceTreeNode>> surfaceTree();
+    // withChildren if this surface moved, as the trees of its subsurfaces did too
+    void invalidateSurfaceTree(bool withChildren = false);
+
   private:
     SP<CWlSurface> resource;
     wl_client*     pClient = nullptr;
 
     // this is for cursor dumb copy. Due to our (and wayland's...) architecture,
     // this stupid-ass hack is used
-    WP<IHLBuffer> lastBuffer;
+    WP<IHLBuffer>                     lastBuffer;
+
+    int                               stateLocks = 0;
 
-    int           stateLocks = 0;
+    SP<std::vector<SSurfaceTreeNode>> surfaceTreeCache; // nullptr if it needs a rebuild
 
-    void          destroy();
-    void          releaseBuffers(bool onlyCurrent = true);
-    void          dropPendingBuffer();
-    void          dropCurrentBuffer();
-    void          commitPendingState();
-    void          bfHelper(std::vector<SP<CWLSurfaceResource>> const& nodes, std::function<void(SP<CWLSurfaceResource>, const Vector2D&, void*)> fn, void* data);
-    void          updateCursorShm();
+    void                              destroy();
+    void                              releaseBuffers(bool onlyCurrent = true);
+    void                              dropPendingBuffer();
+    void                              dropCurrentBuffer();
+    void                              commitPendingState();
+    void                              bfHelper(std::vector<SP<CWLSurfaceResource>> const& nodes, std::vector<SSurfaceTreeNode>& tree);
+    void                              updateCursorShm();
 
     friend class CWLPointerResource;
 };
@@ -10,7 +10,12 @@ CWLSubsurfaceResource::CWLSubsurfaceResource(SP<CWlSubsurface> resource_, SP<CWL
     resource->setOnDestroy([this](CWlSubsurface* r) { destroy(); });
     resource->setDestroy([this](CWlSubsurface* r) { destroy(); });
 
-    resource->setSetPosition([this](CWlSubsurface* r, int32_t x, int32_t y) { position = {x, y}; });
+    resource->setSetPosition([this](CWlSubsurface* r, int32_t x, int32_t y) {
+        position = {x, y};
+
+        if (surface)
+            surface->invalidateSurfaceTree(true);
+    });
 
     resource->setSetDesync([this](CWlSubsurface* r) { sync = false; });
     resource->setSetSync([this](CWlSubsurface* r) { sync = true; });
@@ -44,6 +49,8 @@ CWLSubsurfaceResource::CWLSubsurfaceResource(SP<CWlSubsurface> resource_, SP<CWL
         }
 
         std::sort(parent->subsurfaces.begin(), parent->subsurfaces.end(), [](const auto& a, const auto& b) { return a->zIndex < b->zIndex; });
+
+        parent->invalidateSurfaceTree();
     });
 
     resource->setPlaceBelow([this](CWlSubsurface* r, wl_resource* surf) {
@@ -75,6 +82,8 @@ CWLSubsurfaceResource::CWLSubsurfaceResource(SP<CWlSubsurface> resource_, SP<CWL
         }
 
         std::sort(parent->subsurfaces.begin(), parent->subsurfaces.end(), [](const auto& a, const auto& b) { return a->zIndex < b->zIndex; });
+
+        parent->invalidateSurfaceTree();
     });
 
     listeners.commitSurface = surface->events.commit.registerListener([this](std::any d) {
@@ -94,6 +103,8 @@ CWLSubsurfaceResource::CWLSubsurfaceResource(SP<CWlSubsurface> resource_, SP<CWL
 
 CWLSubsurfaceResource::~CWLSubsurfaceResource() {
     events.destroy.emit();
+    if (parent)
+        parent->invalidateSurfaceTree();
     if (surface)
         surface->resetRole();
 }
@@ -187,6 +198,7 @@ CWLSubcompositorResource::CWLSubcompositorResource(SP<CWlSubcompositor> resource
         RESOURCE->self = RESOURCE;
         SURF->role     = makeShared<CSubsurfaceRole>(RESOURCE);
         PARENT->subsurfaces.emplace_back(RESOURCE);
+        SURF->invalidateSurfaceTree(true);
 
         LOGM(LOG, "New wl_subsurface with id {} at {:x}", id, (uintptr_t)RESOURCE.get());
 
@@ -54,6 +54,9 @@ bool CFramebuffer::alloc(int w, int h, uint32_t drmFormat) {
         RASSERT((status == GL_FRAMEBUFFER_COMPLETE), "Framebuffer incomplete, couldn't create! (FB status: {}, GL Error: 0x{:x})", status, (int)glGetError());
 
         Debug::log(LOG, "Framebuffer created, status {}", status);
+
+        if (g_pHyprOpenGL)
+            g_pHyprOpenGL->m_sStats.fbAllocs++;
     }
 
     glBindTexture(GL_TEXTURE_2D, 0);
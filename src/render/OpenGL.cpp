@@ -330,6 +330,28 @@ CHyprOpenGLImpl::CHyprOpenGLImpl() {
     if (!m_sExts.EXT_image_dma_buf_import || !m_sExts.EXT_image_dma_buf_import_modifiers)
         Debug::log(WARN, "Your GPU does not support DMABUFs, this will possibly cause issues and will take a hit on the performance.");
 
+    m_sExts.KHR_parallel_shader_compile = m_szExtensions.contains("GL_KHR_parallel_shader_compile");
+
+    // let the driver compile on as many threads as it likes, see createPrograms
+    if (m_sExts.KHR_parallel_shader_compile) {
+        loadGLProc(&m_sProc.glMaxShaderCompilerThreadsKHR, "glMaxShaderCompilerThreadsKHR");
+        m_sProc.glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+
+    m_pShaderCache = std::make_unique<CShaderCache>();
+
+    m_sExts.EXT_disjoint_timer_query = m_szExtensions.contains("GL_EXT_disjoint_timer_query");
+
+    if (m_sExts.EXT_disjoint_timer_query) {
+        loadGLProc(&m_sProc.glGenQueriesEXT, "glGenQueriesEXT");
+        loadGLProc(&m_sProc.glDeleteQueriesEXT, "glDeleteQueriesEXT");
+        loadGLProc(&m_sProc.glBeginQueryEXT, "glBeginQueryEXT");
+        loadGLProc(&m_sProc.glEndQueryEXT, "glEndQueryEXT");
+        loadGLProc(&m_sProc.glGetQueryObjectuivEXT, "glGetQueryObjectuivEXT");
+        loadGLProc(&m_sProc.glGetQueryObjectui64vEXT, "glGetQueryObjectui64vEXT");
+    } else
+        Debug::log(LOG, "No GL_EXT_disjoint_timer_query, GPU frame times won't be available");
+
 #ifdef USE_TRACY_GPU
 
     loadGLProc(&glQueryCounter, "glQueryCounterEXT");
@@ -348,6 +370,8 @@ CHyprOpenGLImpl::CHyprOpenGLImpl() {
 
     initAssets();
 
+    initGeometry();
+
     static auto P = g_pHookSystem->hookDynamic("preRender", [&](void* self, SCallbackInfo& info, std::any data) { preRender(std::any_cast<PHLMONITOR>(data)); });
 
     RASSERT(eglMakeCurrent(m_pEglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT), "Couldn't unset current EGL!");
@@ -570,6 +594,9 @@ void CHyprOpenGLImpl::logShaderError(const GLuint& shader, bool program) {
 }
 
 GLuint CHyprOpenGLImpl::createProgram(const std::string& vert, const std::string& frag, bool dynamic) {
+    if (const auto CACHED = m_pShaderCache->load(vert, frag); CACHED)
+        return CACHED;
+
     auto vertCompiled = compileShader(GL_VERTEX_SHADER, vert, dynamic);
     if (dynamic) {
         if (vertCompiled == 0)
@@ -589,6 +616,10 @@ GLuint CHyprOpenGLImpl::createProgram(const std::string& vert, const std::string
     auto prog = glCreateProgram();
     glAttachShader(prog, vertCompiled);
     glAttachShader(prog, fragCompiled);
+#ifndef GLES2
+    if (m_pShaderCache->enabled())
+        glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
     glLinkProgram(prog);
 
     glDetachShader(prog, vertCompiled);
@@ -607,9 +638,84 @@ GLuint CHyprOpenGLImpl::createProgram(const std::string& vert, const std::string
         RASSERT(ok != GL_FALSE, "createProgram() failed! GL_LINK_STATUS not OK!");
     }
 
+    m_pShaderCache->store(prog, vert, frag);
+
     return prog;
 }
 
+std::vector<GLuint> CHyprOpenGLImpl::createPrograms(const std::vector<std::pair<std::string, std::string>>& sources) {
+    std::vector<GLuint> programs(sources.size(), 0);
+    std::vector<size_t> compiling;
+
+    // start everything that's not cached, without asking for the result. Drivers compile and link
+    // in the background meanwhile (with KHR_parallel_shader_compile on several threads), instead of
+    // one program after the other.
+    for (size_t i = 0; i < sources.size(); ++i) {
+        const auto& [VERT, FRAG] = sources[i];
+
+        programs[i] = m_pShaderCache->load(VERT, FRAG);
+        if (programs[i])
+            continue;
+
+        const GLuint SHADERS[2] = {glCreateShader(GL_VERTEX_SHADER), glCreateShader(GL_FRAGMENT_SHADER)};
+        const char*  SRCS[2]    = {VERT.c_str(), FRAG.c_str()};
+
+        programs[i] = glCreateProgram();
+
+        for (size_t j = 0; j < 2; ++j) {
+            glShaderSource(SHADERS[j], 1, (const GLchar**)&SRCS[j], nullptr);
+            glCompileShader(SHADERS[j]);
+            glAttachShader(programs[i], SHADERS[j]);
+            // only flagged for deletion, it's freed once detached
+            glDeleteShader(SHADERS[j]);
+        }
+
+#ifndef GLES2
+        if (m_pShaderCache->enabled())
+            glProgramParameteri(programs[i], GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+        glLinkProgram(programs[i]);
+
+        compiling.push_back(i);
+    }
+
+    // now wait for them
+    for (auto const& i : compiling) {
+        const auto& [VERT, FRAG] = sources[i];
+        const auto PROG          = programs[i];
+
+        GLint       ok = GL_FALSE;
+        glGetProgramiv(PROG, GL_LINK_STATUS, &ok);
+
+        GLuint  attached[2] = {0, 0};
+        GLsizei count       = 0;
+        glGetAttachedShaders(PROG, 2, &count, attached);
+
+        if (ok == GL_FALSE) {
+            // same errors as createProgram
+            for (GLsizei j = 0; j < count; ++j) {
+                GLint type = 0, compiled = GL_FALSE;
+                glGetShaderiv(attached[j], GL_SHADER_TYPE, &type);
+                glGetShaderiv(attached[j], GL_COMPILE_STATUS, &compiled);
+                RASSERT(compiled != GL_FALSE, "Compiling shader failed. {} NULL! Shader source:\n\n{}", type == GL_VERTEX_SHADER ? "VERTEX" : "FRAGMENT",
+                        (type == GL_VERTEX_SHADER ? VERT : FRAG).c_str());
+            }
+
+            RASSERT(false, "createProgram() failed! GL_LINK_STATUS not OK!");
+        }
+
+        for (GLsizei j = 0; j < count; ++j) {
+            glDetachShader(PROG, attached[j]);
+        }
+
+        m_pShaderCache->store(PROG, VERT, FRAG);
+    }
+
+    Debug::log(LOG, "Shaders: {} of {} programs loaded from the cache", sources.size() - compiling.size(), sources.size());
+
+    return programs;
+}
+
 GLuint CHyprOpenGLImpl::compileShader(const GLuint& type, std::string src, bool dynamic) {
     auto shader = glCreateShader(type);
 
@@ -827,6 +933,13 @@ void CHyprOpenGLImpl::begin(PHLMONITOR pMonitor, const CRegion& damage_, CFrameb
     if (!m_RenderData.pCurrentMonData->m_bShadersInitialized)
         initShaders();
 
+    if (m_sExts.EXT_disjoint_timer_query && !fb && g_pHyprRenderer->m_eRenderMode == RENDER_MODE_NORMAL)
+        beginGPUTimer(pMonitor);
+
+    // caches of closed windows and layers
+    std::erase_if(m_RenderData.pCurrentMonData->windowBlurCaches, [](const auto& el) { return el.first.expired(); });
+    std::erase_if(m_RenderData.pCurrentMonData->layerBlurCaches, [](const auto& el) { return el.first.expired(); });
+
     // ensure a framebuffer for the monitor exists
     if (m_RenderData.pCurrentMonData->offloadFB.m_vSize != pMonitor->vecPixelSize) {
         m_RenderData.pCurrentMonData->stencilTex->allocate();
@@ -848,6 +961,9 @@ void CHyprOpenGLImpl::begin(PHLMONITOR pMonitor, const CRegion& damage_, CFrameb
     m_RenderData.damage.set(damage_);
     m_RenderData.finalDamage.set(finalDamage.value_or(damage_));
 
+    // start every frame on fresh stream storage
+    m_sGeometry.streamOffset = m_sGeometry.streamCapacity;
+
     m_bFakeFrame = fb;
 
     if (m_bReloadScreenShader) {
@@ -935,6 +1051,8 @@ void CHyprOpenGLImpl::end() {
         m_bEndFrame                     = false;
     }
 
+    endGPUTimer();
+
     // reset our data
     m_RenderData.pMonitor.reset();
     m_RenderData.mouseZoomFactor    = 1.f;
@@ -962,7 +1080,20 @@ void CHyprOpenGLImpl::setDamage(const CRegion& damage_, std::optional<CRegion> f
 }
 
 void CHyprOpenGLImpl::initShaders() {
-    GLuint prog                                      = createProgram(QUADVERTSRC, QUADFRAGSRC);
+    const auto PROGRAMS = createPrograms({
+        {QUADVERTSRC, QUADFRAGSRC},
+        {TEXVERTSRC, TEXFRAGSRCRGBA},
+        {TEXVERTSRC, TEXFRAGSRCRGBAPASSTHRU},
+        {TEXVERTSRC, TEXFRAGSRCRGBX},
+        {TEXVERTSRC, FRAGBLUR1},
+        {TEXVERTSRC, FRAGBLUR2},
+        {TEXVERTSRC, FRAGBLURPREPARE},
+        {TEXVERTSRC, FRAGBLURFINISH},
+        {QUADVERTSRC, FRAGSHADOW},
+        {QUADVERTSRC, FRAGBORDER1},
+    });
+
+    GLuint prog                                      = PROGRAMS[0];
     m_RenderData.pCurrentMonData->m_shQUAD.program   = prog;
     m_RenderData.pCurrentMonData->m_shQUAD.proj      = glGetUniformLocation(prog, "proj");
     m_RenderData.pCurrentMonData->m_shQUAD.color     = glGetUniformLocation(prog, "color");
@@ -971,7 +1102,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shQUAD.fullSize  = glGetUniformLocation(prog, "fullSize");
     m_RenderData.pCurrentMonData->m_shQUAD.radius    = glGetUniformLocation(prog, "radius");
 
-    prog                                                     = createProgram(TEXVERTSRC, TEXFRAGSRCRGBA);
+    prog                                                     = PROGRAMS[1];
     m_RenderData.pCurrentMonData->m_shRGBA.program           = prog;
     m_RenderData.pCurrentMonData->m_shRGBA.proj              = glGetUniformLocation(prog, "proj");
     m_RenderData.pCurrentMonData->m_shRGBA.tex               = glGetUniformLocation(prog, "tex");
@@ -990,32 +1121,14 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shRGBA.tint              = glGetUniformLocation(prog, "tint");
     m_RenderData.pCurrentMonData->m_shRGBA.useAlphaMatte     = glGetUniformLocation(prog, "useAlphaMatte");
 
-    prog                                                     = createProgram(TEXVERTSRC, TEXFRAGSRCRGBAPASSTHRU);
+    prog                                                     = PROGRAMS[2];
     m_RenderData.pCurrentMonData->m_shPASSTHRURGBA.program   = prog;
     m_RenderData.pCurrentMonData->m_shPASSTHRURGBA.proj      = glGetUniformLocation(prog, "proj");
     m_RenderData.pCurrentMonData->m_shPASSTHRURGBA.tex       = glGetUniformLocation(prog, "tex");
     m_RenderData.pCurrentMonData->m_shPASSTHRURGBA.texAttrib = glGetAttribLocation(prog, "texcoord");
     m_RenderData.pCurrentMonData->m_shPASSTHRURGBA.posAttrib = glGetAttribLocation(prog, "pos");
 
-    prog                                               = createProgram(TEXVERTSRC, TEXFRAGSRCRGBAMATTE);
-    m_RenderData.pCurrentMonData->m_shMATTE.program    = prog;
-    m_RenderData.pCurrentMonData->m_shMATTE.proj       = glGetUniformLocation(prog, "proj");
-    m_RenderData.pCurrentMonData->m_shMATTE.tex        = glGetUniformLocation(prog, "tex");
-    m_RenderData.pCurrentMonData->m_shMATTE.alphaMatte = glGetUniformLocation(prog, "texMatte");
-    m_RenderData.pCurrentMonData->m_shMATTE.texAttrib  = glGetAttribLocation(prog, "texcoord");
-    m_RenderData.pCurrentMonData->m_shMATTE.posAttrib  = glGetAttribLocation(prog, "pos");
-
-    prog                                               = createProgram(TEXVERTSRC, FRAGGLITCH);
-    m_RenderData.pCurrentMonData->m_shGLITCH.program   = prog;
-    m_RenderData.pCurrentMonData->m_shGLITCH.proj      = glGetUniformLocation(prog, "proj");
-    m_RenderData.pCurrentMonData->m_shGLITCH.tex       = glGetUniformLocation(prog, "tex");
-    m_RenderData.pCurrentMonData->m_shGLITCH.texAttrib = glGetAttribLocation(prog, "texcoord");
-    m_RenderData.pCurrentMonData->m_shGLITCH.posAttrib = glGetAttribLocation(prog, "pos");
-    m_RenderData.pCurrentMonData->m_shGLITCH.distort   = glGetUniformLocation(prog, "distort");
-    m_RenderData.pCurrentMonData->m_shGLITCH.time      = glGetUniformLocation(prog, "time");
-    m_RenderData.pCurrentMonData->m_shGLITCH.fullSize  = glGetUniformLocation(prog, "screenSize");
-
-    prog                                                     = createProgram(TEXVERTSRC, TEXFRAGSRCRGBX);
+    prog                                                     = PROGRAMS[3];
     m_RenderData.pCurrentMonData->m_shRGBX.program           = prog;
     m_RenderData.pCurrentMonData->m_shRGBX.tex               = glGetUniformLocation(prog, "tex");
     m_RenderData.pCurrentMonData->m_shRGBX.proj              = glGetUniformLocation(prog, "proj");
@@ -1031,23 +1144,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shRGBX.applyTint         = glGetUniformLocation(prog, "applyTint");
     m_RenderData.pCurrentMonData->m_shRGBX.tint              = glGetUniformLocation(prog, "tint");
 
-    prog                                                    = createProgram(TEXVERTSRC, TEXFRAGSRCEXT);
-    m_RenderData.pCurrentMonData->m_shEXT.program           = prog;
-    m_RenderData.pCurrentMonData->m_shEXT.tex               = glGetUniformLocation(prog, "tex");
-    m_RenderData.pCurrentMonData->m_shEXT.proj              = glGetUniformLocation(prog, "proj");
-    m_RenderData.pCurrentMonData->m_shEXT.alpha             = glGetUniformLocation(prog, "alpha");
-    m_RenderData.pCurrentMonData->m_shEXT.posAttrib         = glGetAttribLocation(prog, "pos");
-    m_RenderData.pCurrentMonData->m_shEXT.texAttrib         = glGetAttribLocation(prog, "texcoord");
-    m_RenderData.pCurrentMonData->m_shEXT.discardOpaque     = glGetUniformLocation(prog, "discardOpaque");
-    m_RenderData.pCurrentMonData->m_shEXT.discardAlpha      = glGetUniformLocation(prog, "discardAlpha");
-    m_RenderData.pCurrentMonData->m_shEXT.discardAlphaValue = glGetUniformLocation(prog, "discardAlphaValue");
-    m_RenderData.pCurrentMonData->m_shEXT.topLeft           = glGetUniformLocation(prog, "topLeft");
-    m_RenderData.pCurrentMonData->m_shEXT.fullSize          = glGetUniformLocation(prog, "fullSize");
-    m_RenderData.pCurrentMonData->m_shEXT.radius            = glGetUniformLocation(prog, "radius");
-    m_RenderData.pCurrentMonData->m_shEXT.applyTint         = glGetUniformLocation(prog, "applyTint");
-    m_RenderData.pCurrentMonData->m_shEXT.tint              = glGetUniformLocation(prog, "tint");
-
-    prog                                                      = createProgram(TEXVERTSRC, FRAGBLUR1);
+    prog                                                      = PROGRAMS[4];
     m_RenderData.pCurrentMonData->m_shBLUR1.program           = prog;
     m_RenderData.pCurrentMonData->m_shBLUR1.tex               = glGetUniformLocation(prog, "tex");
     m_RenderData.pCurrentMonData->m_shBLUR1.alpha             = glGetUniformLocation(prog, "alpha");
@@ -1060,7 +1157,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shBLUR1.vibrancy          = glGetUniformLocation(prog, "vibrancy");
     m_RenderData.pCurrentMonData->m_shBLUR1.vibrancy_darkness = glGetUniformLocation(prog, "vibrancy_darkness");
 
-    prog                                              = createProgram(TEXVERTSRC, FRAGBLUR2);
+    prog                                              = PROGRAMS[5];
     m_RenderData.pCurrentMonData->m_shBLUR2.program   = prog;
     m_RenderData.pCurrentMonData->m_shBLUR2.tex       = glGetUniformLocation(prog, "tex");
     m_RenderData.pCurrentMonData->m_shBLUR2.alpha     = glGetUniformLocation(prog, "alpha");
@@ -1070,7 +1167,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shBLUR2.radius    = glGetUniformLocation(prog, "radius");
     m_RenderData.pCurrentMonData->m_shBLUR2.halfpixel = glGetUniformLocation(prog, "halfpixel");
 
-    prog                                                     = createProgram(TEXVERTSRC, FRAGBLURPREPARE);
+    prog                                                     = PROGRAMS[6];
     m_RenderData.pCurrentMonData->m_shBLURPREPARE.program    = prog;
     m_RenderData.pCurrentMonData->m_shBLURPREPARE.tex        = glGetUniformLocation(prog, "tex");
     m_RenderData.pCurrentMonData->m_shBLURPREPARE.proj       = glGetUniformLocation(prog, "proj");
@@ -1079,7 +1176,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shBLURPREPARE.contrast   = glGetUniformLocation(prog, "contrast");
     m_RenderData.pCurrentMonData->m_shBLURPREPARE.brightness = glGetUniformLocation(prog, "brightness");
 
-    prog                                                    = createProgram(TEXVERTSRC, FRAGBLURFINISH);
+    prog                                                    = PROGRAMS[7];
     m_RenderData.pCurrentMonData->m_shBLURFINISH.program    = prog;
     m_RenderData.pCurrentMonData->m_shBLURFINISH.tex        = glGetUniformLocation(prog, "tex");
     m_RenderData.pCurrentMonData->m_shBLURFINISH.proj       = glGetUniformLocation(prog, "proj");
@@ -1088,7 +1185,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shBLURFINISH.brightness = glGetUniformLocation(prog, "brightness");
     m_RenderData.pCurrentMonData->m_shBLURFINISH.noise      = glGetUniformLocation(prog, "noise");
 
-    prog                                                 = createProgram(QUADVERTSRC, FRAGSHADOW);
+    prog                                                 = PROGRAMS[8];
     m_RenderData.pCurrentMonData->m_shSHADOW.program     = prog;
     m_RenderData.pCurrentMonData->m_shSHADOW.proj        = glGetUniformLocation(prog, "proj");
     m_RenderData.pCurrentMonData->m_shSHADOW.posAttrib   = glGetAttribLocation(prog, "pos");
@@ -1101,7 +1198,7 @@ void CHyprOpenGLImpl::initShaders() {
     m_RenderData.pCurrentMonData->m_shSHADOW.shadowPower = glGetUniformLocation(prog, "shadowPower");
     m_RenderData.pCurrentMonData->m_shSHADOW.color       = glGetUniformLocation(prog, "color");
 
-    prog                                                            = createProgram(QUADVERTSRC, FRAGBORDER1);
+    prog                                                            = PROGRAMS[9];
     m_RenderData.pCurrentMonData->m_shBORDER1.program               = prog;
     m_RenderData.pCurrentMonData->m_shBORDER1.proj                  = glGetUniformLocation(prog, "proj");
     m_RenderData.pCurrentMonData->m_shBORDER1.thick                 = glGetUniformLocation(prog, "thick");
@@ -1123,6 +1220,64 @@ void CHyprOpenGLImpl::initShaders() {
     Debug::log(LOG, "Shaders initialized successfully.");
 }
 
+CShader* CHyprOpenGLImpl::getMatteShader() {
+    auto& shader = m_RenderData.pCurrentMonData->m_shMATTE;
+    if (shader.program)
+        return &shader;
+
+    const auto PROG   = createProgram(TEXVERTSRC, TEXFRAGSRCRGBAMATTE);
+    shader.program    = PROG;
+    shader.proj       = glGetUniformLocation(PROG, "proj");
+    shader.tex        = glGetUniformLocation(PROG, "tex");
+    shader.alphaMatte = glGetUniformLocation(PROG, "texMatte");
+    shader.texAttrib  = glGetAttribLocation(PROG, "texcoord");
+    shader.posAttrib  = glGetAttribLocation(PROG, "pos");
+
+    return &shader;
+}
+
+CShader* CHyprOpenGLImpl::getGlitchShader() {
+    auto& shader = m_RenderData.pCurrentMonData->m_shGLITCH;
+    if (shader.program)
+        return &shader;
+
+    const auto PROG  = createProgram(TEXVERTSRC, FRAGGLITCH);
+    shader.program   = PROG;
+    shader.proj      = glGetUniformLocation(PROG, "proj");
+    shader.tex       = glGetUniformLocation(PROG, "tex");
+    shader.texAttrib = glGetAttribLocation(PROG, "texcoord");
+    shader.posAttrib = glGetAttribLocation(PROG, "pos");
+    shader.distort   = glGetUniformLocation(PROG, "distort");
+    shader.time      = glGetUniformLocation(PROG, "time");
+    shader.fullSize  = glGetUniformLocation(PROG, "screenSize");
+
+    return &shader;
+}
+
+CShader* CHyprOpenGLImpl::getExtShader() {
+    auto& shader = m_RenderData.pCurrentMonData->m_shEXT;
+    if (shader.program)
+        return &shader;
+
+    const auto PROG          = createProgram(TEXVERTSRC, TEXFRAGSRCEXT);
+    shader.program           = PROG;
+    shader.tex               = glGetUniformLocation(PROG, "tex");
+    shader.proj              = glGetUniformLocation(PROG, "proj");
+    shader.alpha             = glGetUniformLocation(PROG, "alpha");
+    shader.posAttrib         = glGetAttribLocation(PROG, "pos");
+    shader.texAttrib         = glGetAttribLocation(PROG, "texcoord");
+    shader.discardOpaque     = glGetUniformLocation(PROG, "discardOpaque");
+    shader.discardAlpha      = glGetUniformLocation(PROG, "discardAlpha");
+    shader.discardAlphaValue = glGetUniformLocation(PROG, "discardAlphaValue");
+    shader.topLeft           = glGetUniformLocation(PROG, "topLeft");
+    shader.fullSize          = glGetUniformLocation(PROG, "fullSize");
+    shader.radius            = glGetUniformLocation(PROG, "radius");
+    shader.applyTint         = glGetUniformLocation(PROG, "applyTint");
+    shader.tint              = glGetUniformLocation(PROG, "tint");
+
+    return &shader;
+}
+
 void CHyprOpenGLImpl::applyScreenShader(const std::string& path) {
 
     static auto PDT = CConfigValue<Hyprlang::INT>("debug:damage_tracking");
@@ -1231,6 +1386,157 @@ void CHyprOpenGLImpl::scissor(const int x, const int y, const int w, const int h
     scissor(&box, transform);
 }
 
+void CHyprOpenGLImpl::initGeometry() {
+    glGenBuffers(1, &m_sGeometry.quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_sGeometry.quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullVerts), fullVerts, GL_STATIC_DRAW);
+
+    m_sGeometry.streamCapacity = GEOMETRY_STREAM_SIZE;
+    m_sGeometry.streamOffset   = 0;
+
+    glGenBuffers(1, &m_sGeometry.streamVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_sGeometry.streamVBO);
+    glBufferData(GL_ARRAY_BUFFER, m_sGeometry.streamCapacity, nullptr, GL_STREAM_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// the quad buffer has to be bound
+static void setQuadAttribs(CShader* shader) {
+    glVertexAttribPointer(shader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    if (shader->texAttrib != -1)
+        glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+}
+
+void CHyprOpenGLImpl::bindQuad(CShader* shader, const float* texVerts) {
+#ifndef GLES2
+    if (!shader->vao) {
+        glGenVertexArrays(1, &shader->vao);
+        glBindVertexArray(shader->vao);
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_sGeometry.quadVBO);
+        setQuadAttribs(shader);
+
+        glEnableVertexAttribArray(shader->posAttrib);
+        if (shader->texAttrib != -1)
+            glEnableVertexAttribArray(shader->texAttrib);
+    } else
+        glBindVertexArray(shader->vao);
+#else
+    glBindBuffer(GL_ARRAY_BUFFER, m_sGeometry.quadVBO);
+    setQuadAttribs(shader);
+
+    glEnableVertexAttribArray(shader->posAttrib);
+    if (shader->texAttrib != -1)
+        glEnableVertexAttribArray(shader->texAttrib);
+#endif
+
+    if (texVerts && shader->texAttrib != -1) {
+        const auto OFFSET = streamVertices(texVerts, sizeof(fullVerts));
+        glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)OFFSET);
+        m_sGeometry.quadModified = true;
+    }
+}
+
+void CHyprOpenGLImpl::unbindQuad(CShader* shader) {
+    // the vao keeps whatever its attribs were pointed at, it has to stay the plain quad
+    if (m_sGeometry.quadModified) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_sGeometry.quadVBO);
+        setQuadAttribs(shader);
+        m_sGeometry.quadModified = false;
+    }
+
+#ifndef GLES2
+    glBindVertexArray(0);
+#else
+    glDisableVertexAttribArray(shader->posAttrib);
+    if (shader->texAttrib != -1)
+        glDisableVertexAttribArray(shader->texAttrib);
+#endif
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+size_t CHyprOpenGLImpl::streamVertices(const void* data, size_t size) {
+    glBindBuffer(GL_ARRAY_BUFFER, m_sGeometry.streamVBO);
+
+    if (m_sGeometry.streamOffset + size > m_sGeometry.streamCapacity) {
+        // orphan it, the driver keeps the old storage around for draws still using it
+        m_sGeometry.streamCapacity = std::max(m_sGeometry.streamCapacity, size);
+        glBufferData(GL_ARRAY_BUFFER, m_sGeometry.streamCapacity, nullptr, GL_STREAM_DRAW);
+        m_sGeometry.streamOffset = 0;
+    }
+
+    const auto OFFSET = m_sGeometry.streamOffset;
+    glBufferSubData(GL_ARRAY_BUFFER, OFFSET, size, data);
+
+    // keep attrib offsets aligned
+    m_sGeometry.streamOffset += (size + 15) & ~(size_t)15;
+
+    return OFFSET;
+}
+
+void CHyprOpenGLImpl::drawDamage(CShader* shader, const CBox& box, eTransform transform, const CRegion& damage, bool transformDamage, const Vector2D& uvTopLeft,
+                                 const Vector2D& uvBottomRight) {
+    if (damage.empty())
+        return;
+
+    const auto RECTS = damage.getRects();
+
+    // a rotated or transformed quad doesn't map rects in box to rects of the unit quad, scissor those
+    if (box.rot != 0 || transform != HYPRUTILS_TRANSFORM_NORMAL || box.width <= 0 || box.height <= 0) {
+        for (auto const& RECT : RECTS) {
+            scissor(&RECT, transformDamage);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            m_sStats.drawCalls++;
+        }
+
+        scissor((CBox*)nullptr);
+        return;
+    }
+
+    // damage and box are in the same space, so every rect clipped to the box is a part of the unit quad.
+    // Interpolation is affine, so the part draws exactly what the scissored full quad would.
+    m_vDamageVerts.clear();
+    m_vDamageVerts.reserve(RECTS.size() * 6 * 4);
+
+    const auto UVSIZE = uvBottomRight - uvTopLeft;
+
+    for (auto const& RECT : RECTS) {
+        const double X1 = std::max<double>(RECT.x1, box.x), Y1 = std::max<double>(RECT.y1, box.y);
+        const double X2 = std::min<double>(RECT.x2, box.x + box.width), Y2 = std::min<double>(RECT.y2, box.y + box.height);
+
+        if (X2 <= X1 || Y2 <= Y1)
+            continue;
+
+        const float U1 = (X1 - box.x) / box.width, V1 = (Y1 - box.y) / box.height;
+        const float U2 = (X2 - box.x) / box.width, V2 = (Y2 - box.y) / box.height;
+
+        // two triangles
+        const float QUAD[] = {U1, V1, U2, V1, U1, V2, U2, V1, U2, V2, U1, V2};
+
+        for (size_t i = 0; i < 12; i += 2) {
+            m_vDamageVerts.insert(m_vDamageVerts.end(), {QUAD[i], QUAD[i + 1], (float)(uvTopLeft.x + UVSIZE.x * QUAD[i]), (float)(uvTopLeft.y + UVSIZE.y * QUAD[i + 1])});
+        }
+    }
+
+    if (m_vDamageVerts.empty())
+        return;
+
+    scissor((CBox*)nullptr);
+
+    const auto OFFSET = streamVertices(m_vDamageVerts.data(), m_vDamageVerts.size() * sizeof(float));
+
+    glVertexAttribPointer(shader->posAttrib, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)OFFSET);
+    if (shader->texAttrib != -1)
+        glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(OFFSET + 2 * sizeof(float)));
+
+    m_sGeometry.quadModified = true;
+
+    glDrawArrays(GL_TRIANGLES, 0, m_vDamageVerts.size() / 4);
+    m_sStats.drawCalls++;
+}
+
 void CHyprOpenGLImpl::renderRect(CBox* box, const CColor& col, int round) {
     if (!m_RenderData.damage.empty())
         renderRectWithDamage(box, col, &m_RenderData.damage, round);
@@ -1294,9 +1600,9 @@ void CHyprOpenGLImpl::renderRectWithDamage(CBox* box, const CColor& col, CRegion
 
     box = &newBox;
 
-    Mat3x3 matrix = m_RenderData.monitorProjection.projectBox(
-        newBox, wlTransformToHyprutils(invertTransform(!m_bEndFrame ? WL_OUTPUT_TRANSFORM_NORMAL : m_RenderData.pMonitor->transform)), newBox.rot);
-    Mat3x3 glMatrix = m_RenderData.projection.copy().multiply(matrix);
+    const auto TRANSFORM = wlTransformToHyprutils(invertTransform(!m_bEndFrame ? WL_OUTPUT_TRANSFORM_NORMAL : m_RenderData.pMonitor->transform));
+    Mat3x3     matrix    = m_RenderData.monitorProjection.projectBox(newBox, TRANSFORM, newBox.rot);
+    Mat3x3     glMatrix  = m_RenderData.projection.copy().multiply(matrix);
 
     glUseProgram(m_RenderData.pCurrentMonData->m_shQUAD.program);
 
@@ -1322,28 +1628,17 @@ void CHyprOpenGLImpl::renderRectWithDamage(CBox* box, const CColor& col, CRegion
     glUniform2f(m_RenderData.pCurrentMonData->m_shQUAD.fullSize, (float)FULLSIZE.x, (float)FULLSIZE.y);
     glUniform1f(m_RenderData.pCurrentMonData->m_shQUAD.radius, round);
 
-    glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shQUAD.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-    glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shQUAD.posAttrib);
+    bindQuad(&m_RenderData.pCurrentMonData->m_shQUAD);
 
     if (m_RenderData.clipBox.width != 0 && m_RenderData.clipBox.height != 0) {
         CRegion damageClip{m_RenderData.clipBox.x, m_RenderData.clipBox.y, m_RenderData.clipBox.width, m_RenderData.clipBox.height};
         damageClip.intersect(*damage);
 
-        if (!damageClip.empty()) {
-            for (auto const& RECT : damageClip.getRects()) {
-                scissor(&RECT);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
-    } else {
-        for (auto const& RECT : damage->getRects()) {
-            scissor(&RECT);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-    }
+        drawDamage(&m_RenderData.pCurrentMonData->m_shQUAD, newBox, TRANSFORM, damageClip);
+    } else
+        drawDamage(&m_RenderData.pCurrentMonData->m_shQUAD, newBox, TRANSFORM, *damage);
 
-    glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shQUAD.posAttrib);
+    unbindQuad(&m_RenderData.pCurrentMonData->m_shQUAD);
 
     scissor((CBox*)nullptr);
 }
@@ -1405,7 +1700,7 @@ void CHyprOpenGLImpl::renderTextureInternalWithDamage(SP<CTexture> tex, CBox* pB
     const bool CRASHING = m_bApplyFinalShader && g_pHyprRenderer->m_bCrashingInProgress;
 
     if (CRASHING) {
-        shader           = &m_RenderData.pCurrentMonData->m_shGLITCH;
+        shader           = getGlitchShader();
         usingFinalShader = true;
     } else if (m_bApplyFinalShader && m_sFinalScreenShader.program) {
         shader           = &m_sFinalScreenShader;
@@ -1418,7 +1713,7 @@ void CHyprOpenGLImpl::renderTextureInternalWithDamage(SP<CTexture> tex, CBox* pB
             switch (tex->m_iType) {
                 case TEXTURE_RGBA: shader = &m_RenderData.pCurrentMonData->m_shRGBA; break;
                 case TEXTURE_RGBX: shader = &m_RenderData.pCurrentMonData->m_shRGBX; break;
-                case TEXTURE_EXTERNAL: shader = &m_RenderData.pCurrentMonData->m_shEXT; break;
+                case TEXTURE_EXTERNAL: shader = getExtShader(); break;
                 default: RASSERT(false, "tex->m_iTarget unsupported!");
             }
         }
@@ -1510,36 +1805,21 @@ void CHyprOpenGLImpl::renderTextureInternalWithDamage(SP<CTexture> tex, CBox* pB
         m_RenderData.primarySurfaceUVTopLeft.x,     m_RenderData.primarySurfaceUVBottomRight.y, // bottom left
     };
 
-    glVertexAttribPointer(shader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
+    const bool     CUSTOMUV      = allowCustomUV && m_RenderData.primarySurfaceUVTopLeft != Vector2D(-1, -1);
+    const Vector2D UVTOPLEFT     = CUSTOMUV ? m_RenderData.primarySurfaceUVTopLeft : Vector2D{0, 0};
+    const Vector2D UVBOTTOMRIGHT = CUSTOMUV ? m_RenderData.primarySurfaceUVBottomRight : Vector2D{1, 1};
 
-    if (allowCustomUV && m_RenderData.primarySurfaceUVTopLeft != Vector2D(-1, -1)) {
-        glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, verts);
-    } else {
-        glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-    }
-
-    glEnableVertexAttribArray(shader->posAttrib);
-    glEnableVertexAttribArray(shader->texAttrib);
+    bindQuad(shader, CUSTOMUV ? verts : nullptr);
 
     if (m_RenderData.clipBox.width != 0 && m_RenderData.clipBox.height != 0) {
         CRegion damageClip{m_RenderData.clipBox.x, m_RenderData.clipBox.y, m_RenderData.clipBox.width, m_RenderData.clipBox.height};
         damageClip.intersect(*damage);
 
-        if (!damageClip.empty()) {
-            for (auto const& RECT : damageClip.getRects()) {
-                scissor(&RECT);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
-    } else {
-        for (auto const& RECT : damage->getRects()) {
-            scissor(&RECT);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-    }
+        drawDamage(shader, newBox, TRANSFORM, damageClip, true, UVTOPLEFT, UVBOTTOMRIGHT);
+    } else
+        drawDamage(shader, newBox, TRANSFORM, *damage, true, UVTOPLEFT, UVBOTTOMRIGHT);
 
-    glDisableVertexAttribArray(shader->posAttrib);
-    glDisableVertexAttribArray(shader->texAttrib);
+    unbindQuad(shader);
 
     glBindTexture(tex->m_iTarget, 0);
 }
@@ -1576,21 +1856,13 @@ void CHyprOpenGLImpl::renderTexturePrimitive(SP<CTexture> tex, CBox* pBox) {
 #endif
     glUniform1i(shader->tex, 0);
 
-    glVertexAttribPointer(shader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-    glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-    glEnableVertexAttribArray(shader->posAttrib);
-    glEnableVertexAttribArray(shader->texAttrib);
+    bindQuad(shader);
 
-    for (auto const& RECT : m_RenderData.damage.getRects()) {
-        scissor(&RECT);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    }
+    drawDamage(shader, newBox, TRANSFORM, m_RenderData.damage);
 
     scissor((CBox*)nullptr);
 
-    glDisableVertexAttribArray(shader->posAttrib);
-    glDisableVertexAttribArray(shader->texAttrib);
+    unbindQuad(shader);
 
     glBindTexture(tex->m_iTarget, 0);
 }
@@ -1612,7 +1884,7 @@ void CHyprOpenGLImpl::renderTextureMatte(SP<CTexture> tex, CBox* pBox, CFramebuf
     Mat3x3     matrix    = m_RenderData.monitorProjection.projectBox(newBox, TRANSFORM, newBox.rot);
     Mat3x3     glMatrix  = m_RenderData.projection.copy().multiply(matrix);
 
-    CShader*   shader = &m_RenderData.pCurrentMonData->m_shMATTE;
+    CShader*   shader = getMatteShader();
 
     glUseProgram(shader->program);
 
@@ -1632,21 +1904,13 @@ void CHyprOpenGLImpl::renderTextureMatte(SP<CTexture> tex, CBox* pBox, CFramebuf
     auto matteTex = matte.getTexture();
     glBindTexture(matteTex->m_iTarget, matteTex->m_iTexID);
 
-    glVertexAttribPointer(shader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-    glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
+    bindQuad(shader);
 
-    glEnableVertexAttribArray(shader->posAttrib);
-    glEnableVertexAttribArray(shader->texAttrib);
-
-    for (auto const& RECT : m_RenderData.damage.getRects()) {
-        scissor(&RECT);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    }
+    drawDamage(shader, newBox, TRANSFORM, m_RenderData.damage);
 
     scissor((CBox*)nullptr);
 
-    glDisableVertexAttribArray(shader->posAttrib);
-    glDisableVertexAttribArray(shader->texAttrib);
+    unbindQuad(shader);
 
     glBindTexture(tex->m_iTarget, 0);
 }
@@ -1720,21 +1984,11 @@ CFramebuffer* CHyprOpenGLImpl::blurMainFramebufferWithDamage(float a, CRegion* o
         glUniform1f(m_RenderData.pCurrentMonData->m_shBLURPREPARE.brightness, *PBLURBRIGHTNESS);
         glUniform1i(m_RenderData.pCurrentMonData->m_shBLURPREPARE.tex, 0);
 
-        glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shBLURPREPARE.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-        glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shBLURPREPARE.texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
+        bindQuad(&m_RenderData.pCurrentMonData->m_shBLURPREPARE);
 
-        glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURPREPARE.posAttrib);
-        glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURPREPARE.texAttrib);
-
-        if (!damage.empty()) {
-            for (auto const& RECT : damage.getRects()) {
-                scissor(&RECT, false /* this region is already transformed */);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
+        drawDamage(&m_RenderData.pCurrentMonData->m_shBLURPREPARE, MONITORBOX, TRANSFORM, damage, false /* this region is already transformed */);
 
-        glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURPREPARE.posAttrib);
-        glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURPREPARE.texAttrib);
+        unbindQuad(&m_RenderData.pCurrentMonData->m_shBLURPREPARE);
 
         currentRenderToFB = PMIRRORSWAPFB;
     }
@@ -1775,21 +2029,11 @@ CFramebuffer* CHyprOpenGLImpl::blurMainFramebufferWithDamage(float a, CRegion* o
                         0.5f / (m_RenderData.pMonitor->vecPixelSize.y * 2.f));
         glUniform1i(pShader->tex, 0);
 
-        glVertexAttribPointer(pShader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-        glVertexAttribPointer(pShader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-        glEnableVertexAttribArray(pShader->posAttrib);
-        glEnableVertexAttribArray(pShader->texAttrib);
+        bindQuad(pShader);
 
-        if (!pDamage->empty()) {
-            for (auto const& RECT : pDamage->getRects()) {
-                scissor(&RECT, false /* this region is already transformed */);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
+        drawDamage(pShader, MONITORBOX, TRANSFORM, *pDamage, false /* this region is already transformed */);
 
-        glDisableVertexAttribArray(pShader->posAttrib);
-        glDisableVertexAttribArray(pShader->texAttrib);
+        unbindQuad(pShader);
 
         if (currentRenderToFB != PMIRRORFB)
             currentRenderToFB = PMIRRORFB;
@@ -1847,21 +2091,11 @@ CFramebuffer* CHyprOpenGLImpl::blurMainFramebufferWithDamage(float a, CRegion* o
 
         glUniform1i(m_RenderData.pCurrentMonData->m_shBLURFINISH.tex, 0);
 
-        glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shBLURFINISH.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-        glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shBLURFINISH.texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
+        bindQuad(&m_RenderData.pCurrentMonData->m_shBLURFINISH);
 
-        glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURFINISH.posAttrib);
-        glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURFINISH.texAttrib);
+        drawDamage(&m_RenderData.pCurrentMonData->m_shBLURFINISH, MONITORBOX, TRANSFORM, damage, false /* this region is already transformed */);
 
-        if (!damage.empty()) {
-            for (auto const& RECT : damage.getRects()) {
-                scissor(&RECT, false /* this region is already transformed */);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
-
-        glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURFINISH.posAttrib);
-        glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBLURFINISH.texAttrib);
+        unbindQuad(&m_RenderData.pCurrentMonData->m_shBLURFINISH);
 
         if (currentRenderToFB != PMIRRORFB)
             currentRenderToFB = PMIRRORFB;
@@ -1879,6 +2113,111 @@ CFramebuffer* CHyprOpenGLImpl::blurMainFramebufferWithDamage(float a, CRegion* o
 
 void CHyprOpenGLImpl::markBlurDirtyForMonitor(PHLMONITOR pMonitor) {
     m_mMonitorRenderResources[pMonitor].blurFBDirty = true;
+
+    for (auto& [w, cache] : m_mMonitorRenderResources[pMonitor].windowBlurCaches) {
+        cache.stale = true;
+    }
+
+    for (auto& [l, cache] : m_mMonitorRenderResources[pMonitor].layerBlurCaches) {
+        cache.stale = true;
+    }
+}
+
+void CHyprOpenGLImpl::damageBlurCaches(PHLMONITOR pMonitor, const CRegion& damage) {
+    const auto IT = m_mMonitorRenderResources.find(pMonitor);
+    if (IT == m_mMonitorRenderResources.end() || (IT->second.windowBlurCaches.empty() && IT->second.layerBlurCaches.empty()))
+        return;
+
+    static auto PBLURSIZE   = CConfigValue<Hyprlang::INT>("decoration:blur:size");
+    static auto PBLURPASSES = CConfigValue<Hyprlang::INT>("decoration:blur:passes");
+    const auto  BLURRADIUS  = *PBLURPASSES > 10 ? pow(2, 15) : std::clamp(*PBLURSIZE, (int64_t)1, (int64_t)40) * pow(2, *PBLURPASSES);
+
+    const auto  OWNERWINDOW = m_pDamageOwnerWindow.lock();
+    const auto  OWNERLAYER  = m_pDamageOwnerLayer.lock();
+
+    // anything changing within the blur radius changes the blurred background
+    const auto damageCache = [&](SBlurCache& cache) {
+        if (cache.stale || CRegion{damage}.intersect(CBox{cache.box}.expand(BLURRADIUS)).empty())
+            return;
+
+        cache.stale            = true;
+        cache.repaintRequested = false;
+    };
+
+    for (auto& [w, cache] : IT->second.windowBlurCaches) {
+        if (!OWNERWINDOW || w.lock() != OWNERWINDOW)
+            damageCache(cache);
+    }
+
+    for (auto& [l, cache] : IT->second.layerBlurCaches) {
+        if (!OWNERLAYER || l.lock() != OWNERLAYER)
+            damageCache(cache);
+    }
+}
+
+SBlurCache* CHyprOpenGLImpl::blurCacheFor(SP<CWLSurfaceResource> pSurface, const CBox& box, float a) {
+#ifndef GLES2
+    static auto PDAMAGETRACKING = CConfigValue<Hyprlang::INT>("debug:damage_tracking");
+
+    // damage only tells what changed below in the monitor's own frames
+    if (g_pHyprRenderer->m_eRenderMode != RENDER_MODE_NORMAL || *PDAMAGETRACKING != DAMAGE_TRACKING_FULL || !m_RenderData.renderModif.modifs.empty())
+        return nullptr;
+
+    SBlurCache* cache = nullptr;
+    if (const auto PWINDOW = m_pCurrentWindow.lock(); PWINDOW && PWINDOW->m_pWLSurface->resource() == pSurface)
+        cache = &m_RenderData.pCurrentMonData->windowBlurCaches[PWINDOW];
+    else if (m_pCurrentLayer && m_pCurrentLayer->surface->resource() == pSurface)
+        cache = &m_RenderData.pCurrentMonData->layerBlurCaches[m_pCurrentLayer];
+    else
+        return nullptr;
+
+    if (cache->box != box || cache->alpha != a) {
+        cache->box              = box;
+        cache->alpha            = a;
+        cache->valid            = false;
+        cache->stale            = true;
+        cache->repaintRequested = false;
+    }
+
+    return cache;
+#else
+    return nullptr;
+#endif
+}
+
+void CHyprOpenGLImpl::updateBlurCache(SBlurCache& cache, CFramebuffer* blurred, bool filled) {
+#ifndef GLES2
+    if (!filled) {
+        // nothing below changed since the last frame, redraw all of the box once so it can be kept
+        if (!cache.stale && !cache.repaintRequested) {
+            m_RenderData.pMonitor->damage.damage(cache.box);
+            g_pCompositor->scheduleFrameForMonitor(m_RenderData.pMonitor.lock(), Aquamarine::IOutput::AQ_SCHEDULE_DAMAGE);
+            cache.repaintRequested = true;
+        }
+
+        cache.valid = false;
+        cache.stale = false;
+        return;
+    }
+
+    // copy the box out of the monitor sized result, in framebuffer coordinates
+    CBox fbBox = cache.box;
+    fbBox.transform(wlTransformToHyprutils(invertTransform(m_RenderData.pMonitor->transform)), m_RenderData.pMonitor->vecTransformedSize.x,
+                    m_RenderData.pMonitor->vecTransformedSize.y);
+    fbBox.round();
+
+    cache.fb.alloc(fbBox.w, fbBox.h, m_RenderData.pMonitor->output->state->state().drmFormat);
+
+    scissor((CBox*)nullptr);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, blurred->getFBID());
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, cache.fb.getFBID());
+    glBlitFramebuffer(fbBox.x, fbBox.y, fbBox.x + fbBox.w, fbBox.y + fbBox.h, 0, 0, fbBox.w, fbBox.h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+
+    m_RenderData.currentFB->bind();
+
+    cache.valid = true;
+    cache.stale = false;
+#endif
 }
 
 void CHyprOpenGLImpl::preRender(PHLMONITOR pMonitor) {
@@ -2075,17 +2414,33 @@ void CHyprOpenGLImpl::renderTextureWithBlur(SP<CTexture> tex, CBox* pBox, float
     inverseOpaque.scale(m_RenderData.pMonitor->scale);
 
     //   vvv TODO: layered blur fbs?
-    const bool    USENEWOPTIMIZE = shouldUseNewBlurOptimizations(m_pCurrentLayer, m_pCurrentWindow.lock()) && !blockBlurOptimization;
+    const bool USENEWOPTIMIZE = shouldUseNewBlurOptimizations(m_pCurrentLayer, m_pCurrentWindow.lock()) && !blockBlurOptimization;
+
+    // with nothing below changed, the blurred background from the last time is still right
+    SBlurCache*   cache    = USENEWOPTIMIZE ? nullptr : blurCacheFor(pSurface, *pBox, a);
+    const bool    USECACHE = cache && cache->valid && !cache->stale;
 
     CFramebuffer* POUTFB = nullptr;
-    if (!USENEWOPTIMIZE) {
+    if (USENEWOPTIMIZE)
+        POUTFB = &m_RenderData.pCurrentMonData->blurFB;
+    else if (!USECACHE) {
         inverseOpaque.translate({pBox->x, pBox->y});
         m_RenderData.renderModif.applyToRegion(inverseOpaque);
-        inverseOpaque.intersect(texDamage);
+
+        // the whole box (as far as it's on the monitor) is redrawn and nothing below changed since the last frame:
+        // blur all of it this once, and keep it. finalDamage isn't clipped to what's visible, see CRenderPass::render
+        const bool FILLCACHE = cache && !cache->stale &&
+            CRegion{*pBox}.intersect(CBox{{}, m_RenderData.pMonitor->vecTransformedSize}).subtract(m_RenderData.finalDamage).empty();
+
+        if (FILLCACHE)
+            inverseOpaque = *pBox;
+        else
+            inverseOpaque.intersect(texDamage);
 
         POUTFB = blurMainFramebufferWithDamage(a, &inverseOpaque);
-    } else {
-        POUTFB = &m_RenderData.pCurrentMonData->blurFB;
+
+        if (cache)
+            updateBlurCache(*cache, POUTFB, FILLCACHE);
     }
 
     m_RenderData.currentFB->bind();
@@ -2117,7 +2472,11 @@ void CHyprOpenGLImpl::renderTextureWithBlur(SP<CTexture> tex, CBox* pBox, float
     setMonitorTransformEnabled(true);
     if (!USENEWOPTIMIZE)
         setRenderModifEnabled(false);
-    renderTextureInternalWithDamage(POUTFB->getTexture(), &MONITORBOX, *PBLURIGNOREOPACITY ? blurA : a * blurA, &texDamage, 0, false, false, false);
+    if (USECACHE) {
+        CBox cacheBox = cache->box;
+        renderTextureInternalWithDamage(cache->fb.getTexture(), &cacheBox, *PBLURIGNOREOPACITY ? blurA : a * blurA, &texDamage, 0, false, false, false);
+    } else
+        renderTextureInternalWithDamage(POUTFB->getTexture(), &MONITORBOX, *PBLURIGNOREOPACITY ? blurA : a * blurA, &texDamage, 0, false, false, false);
     if (!USENEWOPTIMIZE)
         setRenderModifEnabled(true);
     setMonitorTransformEnabled(false);
@@ -2170,9 +2529,9 @@ void CHyprOpenGLImpl::renderBorder(CBox* box, const CGradientValueData& grad, in
 
     round += round == 0 ? 0 : scaledBorderSize;
 
-    Mat3x3 matrix = m_RenderData.monitorProjection.projectBox(
-        newBox, wlTransformToHyprutils(invertTransform(!m_bEndFrame ? WL_OUTPUT_TRANSFORM_NORMAL : m_RenderData.pMonitor->transform)), newBox.rot);
-    Mat3x3     glMatrix = m_RenderData.projection.copy().multiply(matrix);
+    const auto TRANSFORM = wlTransformToHyprutils(invertTransform(!m_bEndFrame ? WL_OUTPUT_TRANSFORM_NORMAL : m_RenderData.pMonitor->transform));
+    Mat3x3     matrix    = m_RenderData.monitorProjection.projectBox(newBox, TRANSFORM, newBox.rot);
+    Mat3x3     glMatrix  = m_RenderData.projection.copy().multiply(matrix);
 
     const auto BLEND = m_bBlend;
     blend(true);
@@ -2207,31 +2566,17 @@ void CHyprOpenGLImpl::renderBorder(CBox* box, const CGradientValueData& grad, in
     glUniform1f(m_RenderData.pCurrentMonData->m_shBORDER1.radiusOuter, outerRound == -1 ? round : outerRound);
     glUniform1f(m_RenderData.pCurrentMonData->m_shBORDER1.thick, scaledBorderSize);
 
-    glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shBORDER1.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-    glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shBORDER1.texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-    glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBORDER1.posAttrib);
-    glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBORDER1.texAttrib);
+    bindQuad(&m_RenderData.pCurrentMonData->m_shBORDER1);
 
     if (m_RenderData.clipBox.width != 0 && m_RenderData.clipBox.height != 0) {
         CRegion damageClip{m_RenderData.clipBox.x, m_RenderData.clipBox.y, m_RenderData.clipBox.width, m_RenderData.clipBox.height};
         damageClip.intersect(m_RenderData.damage);
 
-        if (!damageClip.empty()) {
-            for (auto const& RECT : damageClip.getRects()) {
-                scissor(&RECT);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
-    } else {
-        for (auto const& RECT : m_RenderData.damage.getRects()) {
-            scissor(&RECT);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-    }
+        drawDamage(&m_RenderData.pCurrentMonData->m_shBORDER1, newBox, TRANSFORM, damageClip);
+    } else
+        drawDamage(&m_RenderData.pCurrentMonData->m_shBORDER1, newBox, TRANSFORM, m_RenderData.damage);
 
-    glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBORDER1.posAttrib);
-    glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shBORDER1.texAttrib);
+    unbindQuad(&m_RenderData.pCurrentMonData->m_shBORDER1);
 
     blend(BLEND);
 }
@@ -2472,9 +2817,9 @@ void CHyprOpenGLImpl::renderRoundedShadow(CBox* box, int round, int range, const
 
     const auto  col = color;
 
-    Mat3x3      matrix = m_RenderData.monitorProjection.projectBox(
-        newBox, wlTransformToHyprutils(invertTransform(!m_bEndFrame ? WL_OUTPUT_TRANSFORM_NORMAL : m_RenderData.pMonitor->transform)), newBox.rot);
-    Mat3x3 glMatrix = m_RenderData.projection.copy().multiply(matrix);
+    const auto  TRANSFORM = wlTransformToHyprutils(invertTransform(!m_bEndFrame ? WL_OUTPUT_TRANSFORM_NORMAL : m_RenderData.pMonitor->transform));
+    Mat3x3      matrix    = m_RenderData.monitorProjection.projectBox(newBox, TRANSFORM, newBox.rot);
+    Mat3x3      glMatrix  = m_RenderData.projection.copy().multiply(matrix);
 
     blend(true);
 
@@ -2500,31 +2845,17 @@ void CHyprOpenGLImpl::renderRoundedShadow(CBox* box, int round, int range, const
     glUniform1f(m_RenderData.pCurrentMonData->m_shSHADOW.range, range);
     glUniform1f(m_RenderData.pCurrentMonData->m_shSHADOW.shadowPower, SHADOWPOWER);
 
-    glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shSHADOW.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-    glVertexAttribPointer(m_RenderData.pCurrentMonData->m_shSHADOW.texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-    glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shSHADOW.posAttrib);
-    glEnableVertexAttribArray(m_RenderData.pCurrentMonData->m_shSHADOW.texAttrib);
+    bindQuad(&m_RenderData.pCurrentMonData->m_shSHADOW);
 
     if (m_RenderData.clipBox.width != 0 && m_RenderData.clipBox.height != 0) {
         CRegion damageClip{m_RenderData.clipBox.x, m_RenderData.clipBox.y, m_RenderData.clipBox.width, m_RenderData.clipBox.height};
         damageClip.intersect(m_RenderData.damage);
 
-        if (!damageClip.empty()) {
-            for (auto const& RECT : damageClip.getRects()) {
-                scissor(&RECT);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-        }
-    } else {
-        for (auto const& RECT : m_RenderData.damage.getRects()) {
-            scissor(&RECT);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-    }
+        drawDamage(&m_RenderData.pCurrentMonData->m_shSHADOW, newBox, TRANSFORM, damageClip);
+    } else
+        drawDamage(&m_RenderData.pCurrentMonData->m_shSHADOW, newBox, TRANSFORM, m_RenderData.damage);
 
-    glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shSHADOW.posAttrib);
-    glDisableVertexAttribArray(m_RenderData.pCurrentMonData->m_shSHADOW.texAttrib);
+    unbindQuad(&m_RenderData.pCurrentMonData->m_shSHADOW);
 }
 
 void CHyprOpenGLImpl::saveBufferForMirror(CBox* box) {
@@ -2957,6 +3288,8 @@ void CHyprOpenGLImpl::destroyMonitorResources(PHLMONITOR pMonitor) {
         RESIT->second.blurFB.release();
         RESIT->second.offMainFB.release();
         RESIT->second.stencilTex->destroyTexture();
+        if (RESIT->second.gpuTimer.queries[0])
+            g_pHyprOpenGL->m_sProc.glDeleteQueriesEXT(GPU_TIMER_QUERIES, RESIT->second.gpuTimer.queries.data());
         g_pHyprOpenGL->m_mMonitorRenderResources.erase(RESIT);
     }
 
@@ -2969,6 +3302,53 @@ void CHyprOpenGLImpl::destroyMonitorResources(PHLMONITOR pMonitor) {
     Debug::log(LOG, "Monitor {} -> destroyed all render data", pMonitor->szName);
 }
 
+void CHyprOpenGLImpl::beginGPUTimer(PHLMONITOR pMonitor) {
+    auto& timer = m_RenderData.pCurrentMonData->gpuTimer;
+
+    if (!timer.queries[0])
+        m_sProc.glGenQueriesEXT(GPU_TIMER_QUERIES, timer.queries.data());
+
+    // e.g. a gpu clock change, the results in flight are meaningless then
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    for (size_t i = 0; i < GPU_TIMER_QUERIES; ++i) {
+        if (!timer.pending[i])
+            continue;
+
+        GLuint available = GL_FALSE;
+        m_sProc.glGetQueryObjectuivEXT(timer.queries[i], GL_QUERY_RESULT_AVAILABLE_EXT, &available);
+        if (!available)
+            continue;
+
+        GLuint64 elapsedNs = 0;
+        m_sProc.glGetQueryObjectui64vEXT(timer.queries[i], GL_QUERY_RESULT_EXT, &elapsedNs);
+        timer.pending[i] = false;
+
+        if (!disjoint)
+            pMonitor->frameTimes.gpu.add(elapsedNs / 1000000.0);
+    }
+
+    // every query is still in flight, rather not time this frame than stall
+    if (timer.pending[timer.next])
+        return;
+
+    m_sProc.glBeginQueryEXT(GL_TIME_ELAPSED_EXT, timer.queries[timer.next]);
+    timer.active = true;
+}
+
+void CHyprOpenGLImpl::endGPUTimer() {
+    if (!m_RenderData.pCurrentMonData || !m_RenderData.pCurrentMonData->gpuTimer.active)
+        return;
+
+    auto& timer = m_RenderData.pCurrentMonData->gpuTimer;
+
+    m_sProc.glEndQueryEXT(GL_TIME_ELAPSED_EXT);
+    timer.pending[timer.next] = true;
+    timer.next                = (timer.next + 1) % GPU_TIMER_QUERIES;
+    timer.active              = false;
+}
+
 void CHyprOpenGLImpl::saveMatrix() {
     m_RenderData.savedProjection = m_RenderData.projection;
 }
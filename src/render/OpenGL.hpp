@@ -7,6 +7,7 @@
 #include "../helpers/math/Math.hpp"
 #include "../helpers/Format.hpp"
 #include "../helpers/sync/SyncTimeline.hpp"
+#include <array>
 #include <cstdint>
 #include <list>
 #include <unordered_map>
@@ -19,6 +20,7 @@
 #include "Framebuffer.hpp"
 #include "Transformer.hpp"
 #include "Renderbuffer.hpp"
+#include "ShaderCache.hpp"
 
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
@@ -38,6 +40,9 @@ inline const float fullVerts[] = {
 };
 inline const float fanVertsFull[] = {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
 
+// initial size of the vertex stream, see CHyprOpenGLImpl::streamVertices
+constexpr size_t GEOMETRY_STREAM_SIZE = 64 * 1024;
+
 enum eDiscardMode {
     DISCARD_OPAQUE = 1,
     DISCARD_ALPHA  = 1 << 1
@@ -61,6 +66,19 @@ struct SRenderModifData {
     bool                                               enabled = true;
 };
 
+// the blurred background of a window or layer, reused while nothing below it changes
+struct SBlurCache {
+    CFramebuffer fb;
+    CBox         box;                      // monitor pixels
+    float        alpha            = 1.f;   // the blur size depends on it
+    bool         valid            = false; // fb holds the blurred background of box
+    bool         stale            = true;  // something below changed since it was last drawn
+    bool         repaintRequested = false;
+};
+
+// frames a GPU timer result may take to arrive, see beginGPUTimer
+constexpr size_t GPU_TIMER_QUERIES = 4;
+
 struct SMonitorRenderData {
     CFramebuffer offloadFB;
     CFramebuffer mirrorFB;     // these are used for some effects,
@@ -75,6 +93,18 @@ struct SMonitorRenderData {
     bool         blurFBDirty        = true;
     bool         blurFBShouldRender = false;
 
+    // see renderTextureWithBlur
+    std::map<PHLWINDOWREF, SBlurCache> windowBlurCaches;
+    std::map<PHLLSREF, SBlurCache>     layerBlurCaches;
+
+    // timer queries in flight, oldest first from next
+    struct {
+        std::array<GLuint, GPU_TIMER_QUERIES> queries = {};
+        std::array<bool, GPU_TIMER_QUERIES>   pending = {};
+        size_t                                next    = 0;
+        bool                                  active  = false;
+    } gpuTimer;
+
     // Shaders
     bool    m_bShadersInitialized = false;
     CShader m_shQUAD;
@@ -189,6 +219,7 @@ class CHyprOpenGLImpl {
     void     destroyMonitorResources(PHLMONITOR);
 
     void     markBlurDirtyForMonitor(PHLMONITOR);
+    void     damageBlurCaches(PHLMONITOR, const CRegion& damage); // damage in monitor pixels, see m_pDamageOwnerWindow
 
     void     preWindowPass();
     bool     preBlurQueued();
@@ -227,11 +258,22 @@ class CHyprOpenGLImpl {
     PHLWINDOWREF                                m_pCurrentWindow; // hack to get the current rendered window
     PHLLS                                       m_pCurrentLayer;  // hack to get the current rendered layer
 
+    // set while a window or layer damages its own main surface, which doesn't change what's below it
+    PHLWINDOWREF                                m_pDamageOwnerWindow;
+    PHLLSREF                                    m_pDamageOwnerLayer;
+
     std::map<PHLWINDOWREF, CFramebuffer>        m_mWindowFramebuffers;
     std::map<PHLLSREF, CFramebuffer>            m_mLayerFramebuffers;
     std::map<PHLMONITORREF, SMonitorRenderData> m_mMonitorRenderResources;
     std::map<PHLMONITORREF, CFramebuffer>       m_mMonitorBGFBs;
 
+    // since startup, see CBenchmark
+    struct {
+        uint64_t drawCalls     = 0;
+        uint64_t textureAllocs = 0; // textures created
+        uint64_t fbAllocs      = 0; // framebuffer storage (re)allocated
+    } m_sStats;
+
     struct {
         PFNGLEGLIMAGETARGETRENDERBUFFERSTORAGEOESPROC glEGLImageTargetRenderbufferStorageOES = nullptr;
         PFNGLEGLIMAGETARGETTEXTURE2DOESPROC           glEGLImageTargetTexture2DOES           = nullptr;
@@ -248,6 +290,13 @@ class CHyprOpenGLImpl {
         PFNEGLDESTROYSYNCKHRPROC                      eglDestroySyncKHR                      = nullptr;
         PFNEGLDUPNATIVEFENCEFDANDROIDPROC             eglDupNativeFenceFDANDROID             = nullptr;
         PFNEGLWAITSYNCKHRPROC                         eglWaitSyncKHR                         = nullptr;
+        PFNGLMAXSHADERCOMPILERTHREADSKHRPROC          glMaxShaderCompilerThreadsKHR          = nullptr;
+        PFNGLGENQUERIESEXTPROC                        glGenQueriesEXT                        = nullptr;
+        PFNGLDELETEQUERIESEXTPROC                     glDeleteQueriesEXT                     = nullptr;
+        PFNGLBEGINQUERYEXTPROC                        glBeginQueryEXT                        = nullptr;
+        PFNGLENDQUERYEXTPROC                          glEndQueryEXT                          = nullptr;
+        PFNGLGETQUERYOBJECTUIVEXTPROC                 glGetQueryObjectuivEXT                 = nullptr;
+        PFNGLGETQUERYOBJECTUI64VEXTPROC               glGetQueryObjectui64vEXT               = nullptr;
     } m_sProc;
 
     struct {
@@ -257,6 +306,8 @@ class CHyprOpenGLImpl {
         bool KHR_display_reference              = false;
         bool IMG_context_priority               = false;
         bool EXT_create_context_robustness      = false;
+        bool KHR_parallel_shader_compile        = false;
+        bool EXT_disjoint_timer_query           = false;
     } m_sExts;
 
   private:
@@ -276,15 +327,31 @@ class CHyprOpenGLImpl {
     bool                    m_bOffloadedFramebuffer = false;
 
     CShader                 m_sFinalScreenShader;
+    UP<CShaderCache>        m_pShaderCache;
     CTimer                  m_tGlobalTimer;
 
     SP<CTexture>            m_pMissingAssetTexture, m_pBackgroundTexture, m_pLockDeadTexture, m_pLockDead2Texture, m_pLockTtyTextTexture;
 
+    std::vector<float>      m_vDamageVerts; // pos, texcoord for every damaged vertex, see drawDamage
+
+    struct {
+        GLuint quadVBO        = 0;
+        GLuint streamVBO      = 0; // orphaned when full, and every frame
+        size_t streamCapacity = 0;
+        size_t streamOffset   = 0;
+        bool   quadModified   = false; // attribs of the bound quad point into the stream
+    } m_sGeometry;
+
     void                    logShaderError(const GLuint&, bool program = false);
     GLuint                  createProgram(const std::string&, const std::string&, bool dynamic = false);
+    std::vector<GLuint>     createPrograms(const std::vector<std::pair<std::string, std::string>>& sources);
     GLuint                  compileShader(const GLuint&, std::string, bool dynamic = false);
     void                    createBGTextureForMonitor(PHLMONITOR);
     void                    initShaders();
+    // drawn with rarely (mattes, the crash screen, external textures), so linked on first use instead of before the first frame
+    CShader*                getMatteShader();
+    CShader*                getGlitchShader();
+    CShader*                getExtShader();
     void                    initDRMFormats();
     void                    initEGL(bool gbm);
     EGLDeviceEXT            eglDeviceFromDRMFD(int drmFD);
@@ -306,8 +373,27 @@ class CHyprOpenGLImpl {
 
     void          preBlurForCurrentMonitor();
 
+    SBlurCache*   blurCacheFor(SP<CWLSurfaceResource> pSurface, const CBox& box, float a);
+    void          updateBlurCache(SBlurCache& cache, CFramebuffer* blurred, bool filled);
+
+    // geometry lives in buffer objects: the unit quad, and a stream for anything that changes per draw.
+    // bindQuad binds the quad for the shader, through its VAO, with texVerts as texcoords if set. unbindQuad undoes that.
+    void   initGeometry();
+    void   bindQuad(CShader* shader, const float* texVerts = nullptr);
+    void   unbindQuad(CShader* shader);
+    size_t streamVertices(const void* data, size_t size); // returns the offset in the stream buffer, which is left bound
+
+    // draws the unit quad projected onto box, only where damage is. The quad has to be bound for shader.
+    // One draw call for all rects when the quad maps onto the box axis-aligned, a scissored one per rect otherwise.
+    void drawDamage(CShader* shader, const CBox& box, eTransform transform, const CRegion& damage, bool transformDamage = true, const Vector2D& uvTopLeft = {0, 0},
+                    const Vector2D& uvBottomRight = {1, 1});
+
     bool          passRequiresIntrospection(PHLMONITOR pMonitor);
 
+    // GPU time of monitor frames into CMonitor::frameTimes, with EXT_disjoint_timer_query. Results are read back a few frames later, never waited for.
+    void beginGPUTimer(PHLMONITOR pMonitor);
+    void endGPUTimer();
+
     friend class CHyprRenderer;
 };
 
@@ -20,6 +20,7 @@ class CRenderbuffer {
     uint32_t                getFormat();
 
     WP<Aquamarine::IBuffer> m_pHLBuffer;
+    uint64_t                m_iLastFrame = 0; // the monitor's damage ring frame it was last drawn in, see CHyprRenderer::beginRender
 
   private:
     void*        m_iImage = nullptr;
@@ -20,6 +20,7 @@
 #include "../protocols/DRMSyncobj.hpp"
 #include "../protocols/LinuxDMABUF.hpp"
 #include "../helpers/sync/SyncTimeline.hpp"
+#include "pass/PassElements.hpp"
 #include "debug/Log.hpp"
 
 #include <hyprutils/utils/ScopeGuard.hpp>
@@ -392,7 +393,7 @@ bool CHyprRenderer::shouldRenderWindow(PHLWINDOW pWindow) {
 void CHyprRenderer::renderWorkspaceWindowsFullscreen(PHLMONITOR pMonitor, PHLWORKSPACE pWorkspace, timespec* time) {
     PHLWINDOW pWorkspaceWindow = nullptr;
 
-    EMIT_HOOK_EVENT("render", RENDER_PRE_WINDOWS);
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([]() { EMIT_HOOK_EVENT("render", RENDER_PRE_WINDOWS); }));
 
     // loop over the tiled windows that are fading out
     for (auto const& w : g_pCompositor->m_vWindows) {
@@ -408,7 +409,7 @@ void CHyprRenderer::renderWorkspaceWindowsFullscreen(PHLMONITOR pMonitor, PHLWOR
         if (pWorkspace->m_bIsSpecialWorkspace != w->onSpecialWorkspace())
             continue;
 
-        renderWindow(w, pMonitor, time, true, RENDER_PASS_ALL);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w, pMonitor, time, true, RENDER_PASS_ALL));
     }
 
     // and floating ones too
@@ -428,7 +429,7 @@ void CHyprRenderer::renderWorkspaceWindowsFullscreen(PHLMONITOR pMonitor, PHLWOR
         if (pWorkspace->m_bIsSpecialWorkspace && w->m_pMonitor != pWorkspace->m_pMonitor)
             continue; // special on another are rendered as a part of the base pass
 
-        renderWindow(w, pMonitor, time, true, RENDER_PASS_ALL);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w, pMonitor, time, true, RENDER_PASS_ALL));
     }
 
     // TODO: this pass sucks
@@ -450,7 +451,7 @@ void CHyprRenderer::renderWorkspaceWindowsFullscreen(PHLMONITOR pMonitor, PHLWOR
             continue;
 
         if (shouldRenderWindow(w, pMonitor))
-            renderWindow(w, pMonitor, time, pWorkspace->m_efFullscreenMode != FSMODE_FULLSCREEN, RENDER_PASS_ALL);
+            m_sRenderPass.add(makeShared<CWindowPassElement>(w, pMonitor, time, pWorkspace->m_efFullscreenMode != FSMODE_FULLSCREEN, RENDER_PASS_ALL));
 
         if (w->m_pWorkspace != pWorkspace)
             continue;
@@ -475,14 +476,14 @@ void CHyprRenderer::renderWorkspaceWindowsFullscreen(PHLMONITOR pMonitor, PHLWOR
         if (pWorkspace->m_bIsSpecialWorkspace && w->m_pMonitor != pWorkspace->m_pMonitor)
             continue; // special on another are rendered as a part of the base pass
 
-        renderWindow(w, pMonitor, time, true, RENDER_PASS_ALL);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w, pMonitor, time, true, RENDER_PASS_ALL));
     }
 }
 
 void CHyprRenderer::renderWorkspaceWindows(PHLMONITOR pMonitor, PHLWORKSPACE pWorkspace, timespec* time) {
     PHLWINDOW lastWindow;
 
-    EMIT_HOOK_EVENT("render", RENDER_PRE_WINDOWS);
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([]() { EMIT_HOOK_EVENT("render", RENDER_PRE_WINDOWS); }));
 
     std::vector<PHLWINDOWREF> windows;
     windows.reserve(g_pCompositor->m_vWindows.size());
@@ -512,11 +513,11 @@ void CHyprRenderer::renderWorkspaceWindows(PHLMONITOR pMonitor, PHLWORKSPACE pWo
         }
 
         // render the bad boy
-        renderWindow(w.lock(), pMonitor, time, true, RENDER_PASS_MAIN);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w.lock(), pMonitor, time, true, RENDER_PASS_MAIN));
     }
 
     if (lastWindow)
-        renderWindow(lastWindow, pMonitor, time, true, RENDER_PASS_MAIN);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(lastWindow, pMonitor, time, true, RENDER_PASS_MAIN));
 
     // Non-floating popup
     for (auto& w : windows) {
@@ -530,7 +531,7 @@ void CHyprRenderer::renderWorkspaceWindows(PHLMONITOR pMonitor, PHLWORKSPACE pWo
             continue;
 
         // render the bad boy
-        renderWindow(w.lock(), pMonitor, time, true, RENDER_PASS_POPUP);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w.lock(), pMonitor, time, true, RENDER_PASS_POPUP));
         w.reset();
     }
 
@@ -549,7 +550,7 @@ void CHyprRenderer::renderWorkspaceWindows(PHLMONITOR pMonitor, PHLWORKSPACE pWo
             continue; // special on another are rendered as a part of the base pass
 
         // render the bad boy
-        renderWindow(w.lock(), pMonitor, time, true, RENDER_PASS_ALL);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w.lock(), pMonitor, time, true, RENDER_PASS_ALL));
     }
 }
 
@@ -921,6 +922,7 @@ void CHyprRenderer::renderAllClientsForWorkspace(PHLMONITOR pMonitor, PHLWORKSPA
         return;
     }
 
+    // everything below is collected into the pass first, and rendered at the end
     // for storing damage when we optimize for occlusion
     CRegion preOccludedDamage{g_pHyprOpenGL->m_RenderData.damage};
 
@@ -931,54 +933,68 @@ void CHyprRenderer::renderAllClientsForWorkspace(PHLMONITOR pMonitor, PHLWORKSPA
     if (!pWorkspace->m_bHasFullscreenWindow || pWorkspace->m_efFullscreenMode != FSMODE_FULLSCREEN || !PFULLWINDOW || PFULLWINDOW->m_vRealSize.isBeingAnimated() ||
         !PFULLWINDOW->opaque() || pWorkspace->m_vRenderOffset.value() != Vector2D{} || g_pHyprOpenGL->preBlurQueued()) {
 
-        if (!g_pHyprOpenGL->m_RenderData.pCurrentMonData->blurFBShouldRender)
-            setOccludedForBackLayers(g_pHyprOpenGL->m_RenderData.damage, pWorkspace);
+        m_sRenderPass.add(makeShared<CCallbackPassElement>([this, pMonitor, pWorkspace]() {
+            if (!g_pHyprOpenGL->m_RenderData.pCurrentMonData->blurFBShouldRender)
+                setOccludedForBackLayers(g_pHyprOpenGL->m_RenderData.damage, pWorkspace);
 
-        g_pHyprOpenGL->blend(false);
-        if (!canSkipBackBufferClear(pMonitor)) {
-            if (*PRENDERTEX /* inverted cfg flag */)
-                g_pHyprOpenGL->clear(CColor(*PBACKGROUNDCOLOR));
-            else
-                g_pHyprOpenGL->clearWithTex(); // will apply the hypr "wallpaper"
-        }
-        g_pHyprOpenGL->blend(true);
+            g_pHyprOpenGL->blend(false);
+            if (!canSkipBackBufferClear(pMonitor)) {
+                if (*PRENDERTEX /* inverted cfg flag */)
+                    g_pHyprOpenGL->clear(CColor(*PBACKGROUNDCOLOR));
+                else
+                    g_pHyprOpenGL->clearWithTex(); // will apply the hypr "wallpaper"
+            }
+            g_pHyprOpenGL->blend(true);
+        }));
 
         for (auto const& ls : pMonitor->m_aLayerSurfaceLayers[ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND]) {
-            renderLayer(ls.lock(), pMonitor, time);
+            if (const auto LS = ls.lock(); LS)
+                m_sRenderPass.add(makeShared<CLayerPassElement>(LS, pMonitor, time));
         }
         for (auto const& ls : pMonitor->m_aLayerSurfaceLayers[ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM]) {
-            renderLayer(ls.lock(), pMonitor, time);
+            if (const auto LS = ls.lock(); LS)
+                m_sRenderPass.add(makeShared<CLayerPassElement>(LS, pMonitor, time));
         }
 
-        g_pHyprOpenGL->m_RenderData.damage = preOccludedDamage;
+        m_sRenderPass.add(makeShared<CCallbackPassElement>([preOccludedDamage]() { g_pHyprOpenGL->m_RenderData.damage = preOccludedDamage; }));
     }
 
     // pre window pass
-    g_pHyprOpenGL->preWindowPass();
-
-    setOccludedForMainWorkspace(g_pHyprOpenGL->m_RenderData.damage, pWorkspace);
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([this, pWorkspace]() {
+        g_pHyprOpenGL->preWindowPass();
+        setOccludedForMainWorkspace(g_pHyprOpenGL->m_RenderData.damage, pWorkspace);
+    }));
 
     if (pWorkspace->m_bHasFullscreenWindow)
         renderWorkspaceWindowsFullscreen(pMonitor, pWorkspace, time);
     else
         renderWorkspaceWindows(pMonitor, pWorkspace, time);
 
-    g_pHyprOpenGL->m_RenderData.damage = preOccludedDamage;
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([preOccludedDamage]() { g_pHyprOpenGL->m_RenderData.damage = preOccludedDamage; }));
 
     // and then special
     for (auto const& ws : g_pCompositor->m_vWorkspaces) {
         if (ws->m_pMonitor == pMonitor && ws->m_fAlpha.value() > 0.f && ws->m_bIsSpecialWorkspace) {
             const auto SPECIALANIMPROGRS = ws->m_vRenderOffset.isBeingAnimated() ? ws->m_vRenderOffset.getCurveValue() : ws->m_fAlpha.getCurveValue();
             const bool ANIMOUT           = !pMonitor->activeSpecialWorkspace;
+            const auto MONBOX            = CBox{translate.x, translate.y, pMonitor->vecTransformedSize.x * scale, pMonitor->vecTransformedSize.y * scale};
 
             if (*PDIMSPECIAL != 0.f) {
-                CBox monbox = {translate.x, translate.y, pMonitor->vecTransformedSize.x * scale, pMonitor->vecTransformedSize.y * scale};
-                g_pHyprOpenGL->renderRect(&monbox, CColor(0, 0, 0, *PDIMSPECIAL * (ANIMOUT ? (1.0 - SPECIALANIMPROGRS) : SPECIALANIMPROGRS)));
+                const auto COLOR = CColor(0, 0, 0, *PDIMSPECIAL * (ANIMOUT ? (1.0 - SPECIALANIMPROGRS) : SPECIALANIMPROGRS));
+                m_sRenderPass.add(makeShared<CCallbackPassElement>([MONBOX, COLOR]() {
+                    CBox monbox = MONBOX;
+                    g_pHyprOpenGL->renderRect(&monbox, COLOR);
+                }));
             }
 
             if (*PBLURSPECIAL && *PBLUR) {
-                CBox monbox = {translate.x, translate.y, pMonitor->vecTransformedSize.x * scale, pMonitor->vecTransformedSize.y * scale};
-                g_pHyprOpenGL->renderRectWithBlur(&monbox, CColor(0, 0, 0, 0), 0, (ANIMOUT ? (1.0 - SPECIALANIMPROGRS) : SPECIALANIMPROGRS));
+                const float ALPHA = ANIMOUT ? (1.0 - SPECIALANIMPROGRS) : SPECIALANIMPROGRS;
+                m_sRenderPass.add(makeShared<CCallbackPassElement>(
+                    [MONBOX, ALPHA]() {
+                        CBox monbox = MONBOX;
+                        g_pHyprOpenGL->renderRectWithBlur(&monbox, CColor(0, 0, 0, 0), 0, ALPHA);
+                    },
+                    std::nullopt, true));
             }
 
             break;
@@ -1007,32 +1023,40 @@ void CHyprRenderer::renderAllClientsForWorkspace(PHLMONITOR pMonitor, PHLWORKSPA
             continue;
 
         // render the bad boy
-        renderWindow(w, pMonitor, time, true, RENDER_PASS_ALL);
+        m_sRenderPass.add(makeShared<CWindowPassElement>(w, pMonitor, time, true, RENDER_PASS_ALL));
     }
 
-    EMIT_HOOK_EVENT("render", RENDER_POST_WINDOWS);
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([]() { EMIT_HOOK_EVENT("render", RENDER_POST_WINDOWS); }));
 
     // Render surfaces above windows for monitor
     for (auto const& ls : pMonitor->m_aLayerSurfaceLayers[ZWLR_LAYER_SHELL_V1_LAYER_TOP]) {
-        renderLayer(ls.lock(), pMonitor, time);
+        if (const auto LS = ls.lock(); LS)
+            m_sRenderPass.add(makeShared<CLayerPassElement>(LS, pMonitor, time));
     }
 
     // Render IME popups
-    for (auto const& imep : g_pInputManager->m_sIMERelay.m_vIMEPopups) {
-        renderIMEPopup(imep.get(), pMonitor, time);
-    }
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([this, pMonitor, time]() {
+        for (auto const& imep : g_pInputManager->m_sIMERelay.m_vIMEPopups) {
+            renderIMEPopup(imep.get(), pMonitor, time);
+        }
+    }));
 
     for (auto const& ls : pMonitor->m_aLayerSurfaceLayers[ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY]) {
-        renderLayer(ls.lock(), pMonitor, time);
+        if (const auto LS = ls.lock(); LS)
+            m_sRenderPass.add(makeShared<CLayerPassElement>(LS, pMonitor, time));
     }
 
     for (auto const& lsl : pMonitor->m_aLayerSurfaceLayers) {
         for (auto const& ls : lsl) {
-            renderLayer(ls.lock(), pMonitor, time, true);
+            if (const auto LS = ls.lock(); LS)
+                m_sRenderPass.add(makeShared<CLayerPassElement>(LS, pMonitor, time, true));
         }
     }
 
-    renderDragIcon(pMonitor, time);
+    m_sRenderPass.add(makeShared<CCallbackPassElement>([this, pMonitor, time]() { renderDragIcon(pMonitor, time); }));
+
+    // boxes are in untransformed monitor coordinates, can't cull with a render modif
+    m_sRenderPass.render(g_pHyprOpenGL->m_RenderData.damage, RENDERMODIFDATA.modifs.empty());
 
     //g_pHyprOpenGL->restoreMatrix();
     g_pHyprOpenGL->m_RenderData.renderModif = {};
@@ -1223,6 +1247,12 @@ void CHyprRenderer::renderMonitor(PHLMONITOR pMonitor) {
         firstLaunchAnimActive = false;
     }
 
+    // the last frame is still on the gpu, render again once it's committed
+    if (pMonitor->pendingCommit.source) {
+        pMonitor->pendingFrame = true;
+        return;
+    }
+
     renderStart = std::chrono::high_resolution_clock::now();
 
     if (*PDEBUGOVERLAY == 1)
@@ -1477,18 +1507,25 @@ void CHyprRenderer::renderMonitor(PHLMONITOR pMonitor) {
     pMonitor->output->state->setPresentationMode(shouldTear ? Aquamarine::eOutputPresentationMode::AQ_OUTPUT_PRESENTATION_IMMEDIATE :
                                                               Aquamarine::eOutputPresentationMode::AQ_OUTPUT_PRESENTATION_VSYNC);
 
-    commitPendingAndDoExplicitSync(pMonitor);
+    if (!pMonitor->pendingCommit.sync || !commitWhenSignaled(pMonitor)) {
+        pMonitor->frameTimes.onCommit();
+        commitPendingAndDoExplicitSync(pMonitor);
+    }
 
     if (shouldTear)
         pMonitor->tearingState.busy = true;
 
-    if (*PDAMAGEBLINK || *PVFR == 0 || pMonitor->pendingFrame)
-        g_pCompositor->scheduleFrameForMonitor(pMonitor, Aquamarine::IOutput::AQ_SCHEDULE_RENDER_MONITOR);
+    // otherwise, done once it's committed
+    if (!pMonitor->pendingCommit.source) {
+        if (*PDAMAGEBLINK || *PVFR == 0 || pMonitor->pendingFrame)
+            g_pCompositor->scheduleFrameForMonitor(pMonitor, Aquamarine::IOutput::AQ_SCHEDULE_RENDER_MONITOR);
 
-    pMonitor->pendingFrame = false;
+        pMonitor->pendingFrame = false;
+    }
 
     const float durationUs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - renderStart).count() / 1000.f;
     g_pDebugOverlay->renderData(pMonitor, durationUs);
+    pMonitor->frameTimes.render.add(durationUs / 1000.f);
 
     if (*PDEBUGOVERLAY == 1) {
         if (pMonitor == g_pCompositor->m_vMonitors.front()) {
@@ -1500,6 +1537,62 @@ void CHyprRenderer::renderMonitor(PHLMONITOR pMonitor) {
     }
 }
 
+bool CHyprRenderer::commitWhenSignaled(PHLMONITOR pMonitor) {
+    // sync files poll readable once signaled
+    pMonitor->pendingCommit.source = wl_event_loop_add_fd(
+        g_pEventLoopManager->m_sWayland.loop, pMonitor->pendingCommit.sync->fd(), WL_EVENT_READABLE,
+        [](int fd, uint32_t mask, void* data) {
+            const auto PMONITOR = ((CMonitor*)data)->self.lock();
+
+            wl_event_source_remove(PMONITOR->pendingCommit.source);
+            PMONITOR->pendingCommit.source = nullptr;
+
+            g_pHyprRenderer->commitSignaled(PMONITOR);
+
+            return 0;
+        },
+        pMonitor.get());
+
+    if (!pMonitor->pendingCommit.source) {
+        Debug::log(ERR, "renderer: couldn't wait for the frame fence of {}, committing right away", pMonitor->szName);
+        glFinish();
+        pMonitor->pendingCommit.sync.reset();
+        return false;
+    }
+
+    return true;
+}
+
+void CHyprRenderer::commitSignaled(PHLMONITOR pMonitor) {
+    static auto PVFR         = CConfigValue<Hyprlang::INT>("misc:vfr");
+    static auto PDAMAGEBLINK = CConfigValue<Hyprlang::INT>("debug:damage_blink");
+
+    makeEGLCurrent();
+    pMonitor->pendingCommit.sync.reset();
+
+    pMonitor->frameTimes.onCommit();
+    commitPendingAndDoExplicitSync(pMonitor);
+
+    if (*PDAMAGEBLINK || *PVFR == 0 || pMonitor->pendingFrame)
+        g_pCompositor->scheduleFrameForMonitor(pMonitor, Aquamarine::IOutput::AQ_SCHEDULE_RENDER_MONITOR);
+
+    pMonitor->pendingFrame = false;
+}
+
+void CHyprRenderer::finishPendingCommit(PHLMONITOR pMonitor) {
+    if (!pMonitor->pendingCommit.source)
+        return;
+
+    wl_event_source_remove(pMonitor->pendingCommit.source);
+    pMonitor->pendingCommit.source = nullptr;
+
+    // otherwise the frame's buffer goes out with the next commit, unfinished, or a test sees it
+    makeEGLCurrent();
+    glFinish();
+
+    commitSignaled(pMonitor);
+}
+
 bool CHyprRenderer::commitPendingAndDoExplicitSync(PHLMONITOR pMonitor) {
     // apply timelines for explicit sync
     // save inFD otherwise reset will reset it
@@ -1837,6 +1930,10 @@ void CHyprRenderer::damageSurface(SP<CWLSurfaceResource> pSurface, double x, dou
 
     damageBox.translate({x, y});
 
+    // new content of a main surface doesn't change what's below it, so the owner keeps its blur cache
+    g_pHyprOpenGL->m_pDamageOwnerWindow = WLSURF->getWindow();
+    g_pHyprOpenGL->m_pDamageOwnerLayer  = WLSURF->getLayer();
+
     CRegion damageBoxForEach;
 
     for (auto const& m : g_pCompositor->m_vMonitors) {
@@ -1849,6 +1946,9 @@ void CHyprRenderer::damageSurface(SP<CWLSurfaceResource> pSurface, double x, dou
         m->addDamage(&damageBoxForEach);
     }
 
+    g_pHyprOpenGL->m_pDamageOwnerWindow.reset();
+    g_pHyprOpenGL->m_pDamageOwnerLayer.reset();
+
     static auto PLOGDAMAGE = CConfigValue<Hyprlang::INT>("debug:log_damage");
 
     if (*PLOGDAMAGE)
@@ -2017,6 +2117,9 @@ bool CHyprRenderer::applyMonitorRule(PHLMONITOR pMonitor, SMonitorRule* pMonitor
         return true;
     }
 
+    // the tests below would see its buffer, with the old mode
+    finishPendingCommit(pMonitor);
+
     const auto WAS10B = pMonitor->enabled10bit;
     const auto OLDRES = pMonitor->vecPixelSize;
 
@@ -2725,10 +2828,6 @@ bool CHyprRenderer::beginRender(PHLMONITOR pMonitor, CRegion& damage, eRenderMod
         return true;
     }
 
-    /* This is a constant expression, as we always use double-buffering in our swapchain 
-        TODO: Rewrite the CDamageRing to take advantage of that maybe? It's made to support longer swapchains atm because we used to do wlroots */
-    static constexpr const int HL_BUFFER_AGE = 2;
-
     if (!buffer) {
         m_pCurrentBuffer = pMonitor->output->swapchain->next(nullptr);
         if (!m_pCurrentBuffer) {
@@ -2751,8 +2850,14 @@ bool CHyprRenderer::beginRender(PHLMONITOR pMonitor, CRegion& damage, eRenderMod
     }
 
     if (mode == RENDER_MODE_NORMAL) {
-        damage = pMonitor->damage.getBufferDamage(HL_BUFFER_AGE);
+        // frames since this buffer was drawn, 0 if it never was
+        const auto FRAMES = pMonitor->damage.frames();
+        const int  AGE    = m_pCurrentRenderbuffer->m_iLastFrame ? FRAMES + 1 - m_pCurrentRenderbuffer->m_iLastFrame : 0;
+
+        damage = pMonitor->damage.getBufferDamage(AGE);
         pMonitor->damage.rotate();
+
+        m_pCurrentRenderbuffer->m_iLastFrame = FRAMES + 1;
     }
 
     m_pCurrentRenderbuffer->bind();
@@ -2767,6 +2872,7 @@ bool CHyprRenderer::beginRender(PHLMONITOR pMonitor, CRegion& damage, eRenderMod
 void CHyprRenderer::endRender() {
     const auto  PMONITOR           = g_pHyprOpenGL->m_RenderData.pMonitor;
     static auto PNVIDIAANTIFLICKER = CConfigValue<Hyprlang::INT>("opengl:nvidia_anti_flicker");
+    static auto PASYNCCOMMIT       = CConfigValue<Hyprlang::INT>("render:async_commit");
 
     PMONITOR->commitSeq++;
 
@@ -2814,10 +2920,16 @@ void CHyprRenderer::endRender() {
 
             PMONITOR->output->state->setExplicitInFence(fd);
         } else {
-            if (isNvidia() && *PNVIDIAANTIFLICKER)
-                glFinish();
-            else
-                glFlush();
+            // flushes too, the frame gets committed once it signals. See commitWhenSignaled
+            if (*PASYNCCOMMIT && !PMONITOR->tearingState.activelyTearing)
+                PMONITOR->pendingCommit.sync = g_pHyprOpenGL->createEGLSync(-1);
+
+            if (!PMONITOR->pendingCommit.sync) {
+                if (isNvidia() && *PNVIDIAANTIFLICKER)
+                    glFinish();
+                else
+                    glFlush();
+            }
         }
     }
 }
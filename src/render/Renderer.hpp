@@ -7,6 +7,7 @@
 #include "Renderbuffer.hpp"
 #include "../helpers/Timer.hpp"
 #include "../helpers/math/Math.hpp"
+#include "pass/Pass.hpp"
 
 struct SMonitorRule;
 class CWorkspace;
@@ -82,6 +83,10 @@ class CHyprRenderer {
     SExplicitSyncSettings           getExplicitSyncSettings();
     void                            addWindowToRenderUnfocused(PHLWINDOW window);
 
+    // a frame waiting for its fence (see commitWhenSignaled) has to go before anything else commits or tests the output.
+    // Waits for the fence and commits it now. See CMonitor::cancelPendingCommit for dropping it instead.
+    void finishPendingCommit(PHLMONITOR pMonitor);
+
     // if RENDER_MODE_NORMAL, provided damage will be written to.
     // otherwise, it will be the one used.
     bool beginRender(PHLMONITOR pMonitor, CRegion& damage, eRenderMode mode = RENDER_MODE_NORMAL, SP<IHLBuffer> buffer = {}, CFramebuffer* fb = nullptr, bool simple = false);
@@ -105,6 +110,9 @@ class CHyprRenderer {
 
     CTimer                              m_tRenderTimer;
 
+    // the pass renderAllClientsForWorkspace collects into and renders
+    CRenderPass                         m_sRenderPass;
+
     std::vector<SP<CWLSurfaceResource>> explicitPresented;
 
     struct {
@@ -129,6 +137,8 @@ class CHyprRenderer {
     void              renderSessionLockMissing(PHLMONITOR pMonitor);
 
     bool              commitPendingAndDoExplicitSync(PHLMONITOR pMonitor);
+    bool              commitWhenSignaled(PHLMONITOR pMonitor); // commits once pendingCommit.sync signals, false if it can't wait for it
+    void              commitSignaled(PHLMONITOR pMonitor); // pendingCommit.sync is done, commits the frame
 
     bool              m_bCursorHidden        = false;
     bool              m_bCursorHasSurface    = false;
@@ -154,6 +164,9 @@ class CHyprRenderer {
     friend class CInputManager;
     friend class CPointerManager;
     friend class CMonitor;
+    friend class CWindowPassElement;
+    friend class CLayerPassElement;
+    friend class CBenchmark;
 };
 
 inline std::unique_ptr<CHyprRenderer> g_pHyprRenderer;
@@ -19,5 +19,11 @@ CShader::~CShader() {
 void CShader::destroy() {
     glDeleteProgram(program);
 
+#ifndef GLES2
+    if (vao)
+        glDeleteVertexArrays(1, &vao);
+#endif
+
     program = 0;
+    vao     = 0;
 }
\ No newline at end of file
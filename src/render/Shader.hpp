@@ -8,6 +8,7 @@ class CShader {
     ~CShader();
 
     GLuint  program           = 0;
+    GLuint  vao               = 0; // the unit quad, see CHyprOpenGLImpl::bindQuad
     GLint   proj              = -1;
     GLint   color             = -1;
     GLint   alphaMatte        = -1;
@@ -0,0 +1,249 @@
+#include "ShaderCache.hpp"
+#include "../debug/Log.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+constexpr uint32_t SHADER_CACHE_MAGIC   = 0x43535948; // "HYSC"
+constexpr uint32_t SHADER_CACHE_VERSION = 1;
+// binaries not loaded for this long are from old drivers or old builds
+constexpr auto SHADER_CACHE_MAX_AGE = std::chrono::days{30};
+
+struct SShaderCacheHeader {
+    uint32_t magic   = SHADER_CACHE_MAGIC;
+    uint32_t version = SHADER_CACHE_VERSION;
+    uint64_t key     = 0;
+    uint32_t format  = 0;
+    uint32_t size    = 0;
+};
+
+// FNV-1a, std::hash isn't guaranteed to be the same across builds
+static uint64_t hashAppend(uint64_t hash, const std::string& str) {
+    for (const char c : str) {
+        hash ^= (uint8_t)c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    // separator, so "ab" + "c" differs from "a" + "bc"
+    hash ^= 0xFF;
+    hash *= 0x100000001b3ULL;
+
+    return hash;
+}
+
+CShaderCache::CShaderCache() {
+#ifndef GLES2
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+    if (formats <= 0) {
+        Debug::log(LOG, "Shader cache: no program binary formats supported, disabled");
+        return;
+    }
+
+    const auto RENDERER = (const char*)glGetString(GL_RENDERER);
+    const auto VERSION  = (const char*)glGetString(GL_VERSION);
+    m_szDriver          = std::string{RENDERER ? RENDERER : ""} + "\n" + std::string{VERSION ? VERSION : ""};
+    m_bEnabled          = true;
+
+    const auto CACHE_HOME = getenv("XDG_CACHE_HOME");
+    const auto HOME       = getenv("HOME");
+
+    if (CACHE_HOME && CACHE_HOME[0] != '\0')
+        m_szDirectory = std::string{CACHE_HOME} + "/hyprland/shaders";
+    else if (HOME && HOME[0] != '\0')
+        m_szDirectory = std::string{HOME} + "/.cache/hyprland/shaders";
+
+    std::error_code ec;
+    if (!m_szDirectory.empty() && !std::filesystem::create_directories(m_szDirectory, ec) && ec) {
+        Debug::log(WARN, "Shader cache: couldn't create {}: {}, only caching in memory", m_szDirectory, ec.message());
+        m_szDirectory = "";
+    }
+
+    if (!m_szDirectory.empty())
+        prune();
+
+    Debug::log(LOG, "Shader cache: using {}", m_szDirectory.empty() ? "memory only" : m_szDirectory);
+#endif
+}
+
+void CShaderCache::prune() const {
+    const auto      NOW = std::filesystem::file_time_type::clock::now();
+
+    std::error_code ec;
+    size_t          removed = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(m_szDirectory, ec)) {
+        if (!entry.is_regular_file(ec))
+            continue;
+
+        const auto EXT = entry.path().extension();
+        if (EXT != ".bin" && EXT != ".tmp")
+            continue;
+
+        // .tmp files are left behind by instances that died mid-write, give running ones a moment
+        const auto MAX_AGE = EXT == ".tmp" ? std::chrono::duration_cast<std::filesystem::file_time_type::duration>(std::chrono::hours{1}) :
+                                             std::chrono::duration_cast<std::filesystem::file_time_type::duration>(SHADER_CACHE_MAX_AGE);
+        const auto WRITTEN = entry.last_write_time(ec);
+        if (ec || NOW - WRITTEN < MAX_AGE)
+            continue;
+
+        if (std::filesystem::remove(entry.path(), ec))
+            removed++;
+    }
+
+    if (removed > 0)
+        Debug::log(LOG, "Shader cache: pruned {} stale files", removed);
+}
+
+bool CShaderCache::enabled() const {
+    return m_bEnabled;
+}
+
+uint64_t CShaderCache::keyFor(const std::string& vert, const std::string& frag) const {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    hash          = hashAppend(hash, m_szDriver);
+    hash          = hashAppend(hash, vert);
+    hash          = hashAppend(hash, frag);
+    return hash;
+}
+
+std::string CShaderCache::pathFor(uint64_t key) const {
+    return std::format("{}/{:016x}.bin", m_szDirectory, key);
+}
+
+bool CShaderCache::read(uint64_t key, SBinary& out) const {
+    if (m_szDirectory.empty())
+        return false;
+
+    const auto      PATH = pathFor(key);
+
+    std::error_code ec;
+    const auto      FILE_SIZE = std::filesystem::file_size(PATH, ec);
+    if (ec || FILE_SIZE <= sizeof(SShaderCacheHeader))
+        return false;
+
+    std::ifstream file(PATH, std::ios::binary);
+    if (!file.good())
+        return false;
+
+    SShaderCacheHeader header;
+    if (!file.read((char*)&header, sizeof(header)) || header.magic != SHADER_CACHE_MAGIC || header.version != SHADER_CACHE_VERSION || header.key != key || header.size == 0)
+        return false;
+
+    // don't trust the header with the allocation, a truncated or corrupt file could claim anything
+    if (header.size != FILE_SIZE - sizeof(header)) {
+        Debug::log(WARN, "Shader cache: {} is {} bytes, header claims {}", PATH, FILE_SIZE - sizeof(header), header.size);
+        return false;
+    }
+
+    out.format = header.format;
+    out.data.resize(header.size);
+
+    if (!file.read((char*)out.data.data(), header.size))
+        return false;
+
+    // mark it as used, so prune() keeps it
+    std::filesystem::last_write_time(PATH, std::filesystem::file_time_type::clock::now(), ec);
+
+    return true;
+}
+
+void CShaderCache::write(uint64_t key, const SBinary& binary) const {
+    if (m_szDirectory.empty())
+        return;
+
+    const auto         PATH = pathFor(key);
+    const auto         TMP  = std::format("{}.{}.tmp", PATH, getpid());
+
+    SShaderCacheHeader header;
+    header.key    = key;
+    header.format = binary.format;
+    header.size   = binary.data.size();
+
+    {
+        std::ofstream file(TMP, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)binary.data.data(), binary.data.size());
+
+        if (!file.good()) {
+            Debug::log(WARN, "Shader cache: couldn't write {}", TMP);
+            std::error_code ec;
+            std::filesystem::remove(TMP, ec);
+            return;
+        }
+    }
+
+    // other instances may be reading it, never let them see half a file
+    std::error_code ec;
+    std::filesystem::rename(TMP, PATH, ec);
+    if (ec) {
+        Debug::log(WARN, "Shader cache: couldn't write {}: {}", PATH, ec.message());
+        std::filesystem::remove(TMP, ec);
+    }
+}
+
+GLuint CShaderCache::load(const std::string& vert, const std::string& frag) {
+#ifndef GLES2
+    if (!m_bEnabled)
+        return 0;
+
+    const auto KEY = keyFor(vert, frag);
+
+    auto       it = m_mBinaries.find(KEY);
+    if (it == m_mBinaries.end()) {
+        SBinary binary;
+        if (!read(KEY, binary))
+            return 0;
+
+        it = m_mBinaries.emplace(KEY, std::move(binary)).first;
+    }
+
+    const auto PROG = glCreateProgram();
+    glProgramBinary(PROG, it->second.format, it->second.data.data(), it->second.data.size());
+
+    GLint ok = GL_FALSE;
+    glGetProgramiv(PROG, GL_LINK_STATUS, &ok);
+
+    if (ok == GL_FALSE) {
+        // the driver changed in a way the version doesn't show, compile it again
+        Debug::log(LOG, "Shader cache: binary {:016x} rejected by the driver", KEY);
+        glDeleteProgram(PROG);
+        m_mBinaries.erase(it);
+
+        std::error_code ec;
+        if (!m_szDirectory.empty())
+            std::filesystem::remove(pathFor(KEY), ec);
+
+        return 0;
+    }
+
+    return PROG;
+#else
+    return 0;
+#endif
+}
+
+void CShaderCache::store(GLuint program, const std::string& vert, const std::string& frag) {
+#ifndef GLES2
+    if (!m_bEnabled || !program)
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    SBinary binary;
+    binary.data.resize(length);
+    glGetProgramBinary(program, length, &length, &binary.format, binary.data.data());
+    if (length <= 0)
+        return;
+
+    binary.data.resize(length);
+
+    const auto KEY = keyFor(vert, frag);
+    write(KEY, binary);
+    m_mBinaries[KEY] = std::move(binary);
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../defines.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+    Linked program binaries, keyed by the GL renderer, the driver version and the shader sources.
+    Kept in memory for the other monitors, and in $XDG_CACHE_HOME/hyprland/shaders for the next launch.
+    Needs a GL context to be current.
+*/
+class CShaderCache {
+  public:
+    CShaderCache();
+
+    // a linked program, or 0 if it's not cached or the driver rejected the binary
+    GLuint load(const std::string& vert, const std::string& frag);
+
+    // program has to be linked, with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set
+    void store(GLuint program, const std::string& vert, const std::string& frag);
+
+    bool enabled() const;
+
+  private:
+    struct SBinary {
+        GLenum               format = 0;
+        std::vector<uint8_t> data;
+    };
+
+    uint64_t                              keyFor(const std::string& vert, const std::string& frag) const;
+    std::string                           pathFor(uint64_t key) const;
+    bool                                  read(uint64_t key, SBinary& out) const;
+    void                                  write(uint64_t key, const SBinary& binary) const;
+    // drops binaries that weren't loaded for a while and leftover temp files
+    void                                  prune() const;
+
+    bool                                  m_bEnabled = false;
+    std::string                           m_szDriver; // renderer and version, part of every key
+    std::string                           m_szDirectory;
+    std::unordered_map<uint64_t, SBinary> m_mBinaries;
+};
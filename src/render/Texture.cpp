@@ -149,6 +149,11 @@ void CTexture::destroyTexture() {
 }
 
 void CTexture::allocate() {
-    if (!m_iTexID)
-        GLCALL(glGenTextures(1, &m_iTexID));
+    if (m_iTexID)
+        return;
+
+    GLCALL(glGenTextures(1, &m_iTexID));
+
+    if (g_pHyprOpenGL)
+        g_pHyprOpenGL->m_sStats.textureAllocs++;
 }
@@ -465,8 +465,10 @@ bool CHyprGroupBarDecoration::onEndWindowDragOnDeco(const Vector2D& pos, PHLWIND
 
     pWindowInsertAfter->insertWindowToGroup(pDraggedWindow);
 
-    if (WINDOWINDEX == -1)
+    if (WINDOWINDEX == -1) {
         std::swap(pDraggedHead->m_sGroupData.head, pWindowInsertEnd->m_sGroupData.head);
+        pDraggedWindow->markGroupStateChanged();
+    }
 
     m_pWindow->setGroupCurrent(pDraggedWindow);
     pDraggedWindow->updateWindowDecos();
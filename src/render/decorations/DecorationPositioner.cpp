@@ -275,6 +275,8 @@ void CDecorationPositioner::onWindowUpdate(PHLWINDOW pWindow) {
         WINDOWDATA->extents = {{stickyOffsetXL + reservedXL, stickyOffsetYT + reservedYT}, {stickyOffsetXR + reservedXR, stickyOffsetYB + reservedYB}};
         g_pLayoutManager->getCurrentLayout()->recalculateWindow(pWindow);
     }
+
+    g_pCompositor->updateWindowHitIndex(pWindow);
 }
 
 void CDecorationPositioner::onWindowUnmap(PHLWINDOW pWindow) {
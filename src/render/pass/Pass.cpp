@@ -0,0 +1,193 @@
+#include "Pass.hpp"
+#include "../OpenGL.hpp"
+#include "../../config/ConfigValue.hpp"
+#include "../../debug/Log.hpp"
+#include <algorithm>
+
+// grouping looks at every pair in a run, keep runs short
+constexpr size_t MAX_GROUP_RUN = 32;
+
+void IPassElement::discard() {
+    ;
+}
+
+std::optional<CBox> IPassElement::boundingBox() {
+    return std::nullopt;
+}
+
+CRegion IPassElement::opaqueRegion() {
+    return {};
+}
+
+bool IPassElement::samplesBelow() {
+    return false;
+}
+
+uint32_t IPassElement::stateKey() {
+    return 0;
+}
+
+bool IPassElement::reorderable() {
+    return false;
+}
+
+void CRenderPass::add(SP<IPassElement> element) {
+    m_vElements.emplace_back(element);
+}
+
+void CRenderPass::clear() {
+    m_vElements.clear();
+}
+
+bool CRenderPass::empty() const {
+    return m_vElements.empty();
+}
+
+size_t CRenderPass::size() const {
+    return m_vElements.size();
+}
+
+void CRenderPass::render(const CRegion& damage, bool cull) {
+    SRenderState state;
+    std::swap(state.elements, m_vElements);
+
+    const size_t N = state.elements.size();
+
+    state.boxes.resize(N);
+    state.culled.assign(N, false);
+    state.order.resize(N);
+    state.visible.resize(N);
+
+    for (size_t i = 0; i < N; ++i) {
+        state.boxes[i] = state.elements[i]->boundingBox();
+        state.order[i] = i;
+    }
+
+    if (cull) {
+        cullElements(state, damage);
+        groupElements(state);
+    }
+
+    for (auto const& i : state.order) {
+        if (state.culled[i])
+            state.elements[i]->discard();
+        else if (cull && state.boxes[i].has_value()) {
+            // clip to what's not covered from above. The damage may have been changed by an element before, keep that.
+            const CRegion DAMAGE               = g_pHyprOpenGL->m_RenderData.damage;
+            g_pHyprOpenGL->m_RenderData.damage = CRegion{DAMAGE}.intersect(state.visible[i]);
+            state.elements[i]->draw();
+            g_pHyprOpenGL->m_RenderData.damage = DAMAGE;
+        } else
+            state.elements[i]->draw();
+
+        drawAdded();
+    }
+}
+
+void CRenderPass::drawAdded() {
+    while (!m_vElements.empty()) {
+        std::vector<SP<IPassElement>> added;
+        std::swap(added, m_vElements);
+
+        for (auto const& el : added) {
+            el->draw();
+        }
+    }
+}
+
+CRegion CRenderPass::shrinkRegion(const CRegion& region, double amount) {
+    CRegion result;
+
+    for (auto const& RECT : region.getRects()) {
+        CBox box = {RECT.x1, RECT.y1, RECT.x2 - RECT.x1, RECT.y2 - RECT.y1};
+        box.expand(-amount);
+
+        if (box.w > 0 && box.h > 0)
+            result.add(box);
+    }
+
+    return result;
+}
+
+void CRenderPass::cullElements(SRenderState& state, const CRegion& damage) {
+    static auto  PBLUR       = CConfigValue<Hyprlang::INT>("decoration:blur:enabled");
+    static auto  PBLURSIZE   = CConfigValue<Hyprlang::INT>("decoration:blur:size");
+    static auto  PBLURPASSES = CConfigValue<Hyprlang::INT>("decoration:blur:passes");
+    const auto   BLURRADIUS  = *PBLUR ? (*PBLURPASSES > 10 ? pow(2, 15) : std::clamp(*PBLURSIZE, (int64_t)1, (int64_t)40) * pow(2, *PBLURPASSES)) : 0;
+
+    const size_t N = state.elements.size();
+
+    // front to back, anything under what's already opaque is invisible
+    CRegion opaque;
+    size_t  culled = 0;
+
+    for (size_t i = N; i > 0; --i) {
+        const auto& EL  = state.elements[i - 1];
+        const auto& BOX = state.boxes[i - 1];
+
+        if (BOX.has_value()) {
+            CRegion visible{damage};
+            visible.intersect(*BOX);
+            if (!opaque.empty())
+                visible.subtract(opaque);
+
+            if (visible.empty()) {
+                state.culled[i - 1] = true;
+                culled++;
+                continue;
+            }
+
+            state.visible[i - 1] = visible;
+        }
+
+        // blur reads up to BLURRADIUS around what it draws, so elements below have to be drawn there
+        // even when something opaque covers them later.
+        if (EL->samplesBelow() && BLURRADIUS > 0 && !opaque.empty())
+            opaque = shrinkRegion(opaque, BLURRADIUS);
+
+        if (const auto OPAQUERG = EL->opaqueRegion(); !OPAQUERG.empty())
+            opaque.add(OPAQUERG);
+    }
+
+    if (culled > 0)
+        Debug::log(TRACE, "Render pass: culled {} of {} elements", culled, N);
+}
+
+void CRenderPass::groupElements(SRenderState& state) {
+    const size_t N = state.order.size();
+
+    // elements that don't overlap can be drawn in any order, so within a run of those,
+    // draw the ones using the same shaders together
+    for (size_t begin = 0; begin < N;) {
+        size_t end = begin;
+
+        while (end < N && end - begin < MAX_GROUP_RUN) {
+            const auto IDX = state.order[end];
+
+            if (state.culled[IDX]) {
+                end++;
+                continue;
+            }
+
+            // blur reads past the element's box, overlapping or not
+            if (!state.elements[IDX]->reorderable() || state.elements[IDX]->samplesBelow() || !state.boxes[IDX].has_value())
+                break;
+
+            const bool OVERLAPS = std::any_of(state.order.begin() + begin, state.order.begin() + end, [&](size_t other) {
+                return !state.culled[other] && state.boxes[other].has_value() && state.boxes[other]->overlaps(*state.boxes[IDX]);
+            });
+
+            if (OVERLAPS)
+                break;
+
+            end++;
+        }
+
+        if (end - begin > 1)
+            std::stable_sort(state.order.begin() + begin, state.order.begin() + end,
+                             [&state](size_t a, size_t b) { return state.elements[a]->stateKey() < state.elements[b]->stateKey(); });
+
+        // the element that ended the run starts the next one
+        begin = std::max(end, begin + 1);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include "../../defines.hpp"
+#include "../../helpers/math/Math.hpp"
+
+/*
+    Something drawn in a render pass. Boxes are in monitor pixel coordinates.
+*/
+class IPassElement {
+  public:
+    virtual ~IPassElement() = default;
+
+    virtual void        draw()     = 0;
+    virtual const char* passName() = 0;
+
+    // called instead of draw() when the element was culled
+    virtual void discard();
+
+    // everything the element may touch. nullopt means unknown, and the element is never culled.
+    virtual std::optional<CBox> boundingBox();
+
+    // what the element covers entirely with opaque pixels, anything below it there is skipped
+    virtual CRegion opaqueRegion();
+
+    // whether drawing reads what's below the element, like blur does
+    virtual bool samplesBelow();
+
+    // elements with equal keys use the same shaders. Only elements that can be reordered
+    // (disjoint, not sampling what's below like blur does) are grouped by it.
+    virtual uint32_t stateKey();
+    virtual bool     reorderable();
+};
+
+/*
+    A retained pass: elements are collected back to front, and rendered at once with
+    render(). Each element with a bounding box only draws the part of the damage that
+    isn't covered by opaque elements above it, and is skipped if that is empty.
+*/
+class CRenderPass {
+  public:
+    void   add(SP<IPassElement> element);
+    void   clear();
+    bool   empty() const;
+    size_t size() const;
+
+    // pass cull = false if the elements' boxes can't be trusted, e.g. with a render modif.
+    // Elements added while rendering (e.g. from a render hook) are drawn right after the current one.
+    void render(const CRegion& damage, bool cull = true);
+
+    // shrinks every rect of the region by amount
+    static CRegion shrinkRegion(const CRegion& region, double amount);
+
+  private:
+    struct SRenderState {
+        std::vector<SP<IPassElement>>    elements;
+        std::vector<std::optional<CBox>> boxes;
+        std::vector<size_t>              order;
+        std::vector<bool>                culled;
+        std::vector<CRegion>             visible;
+    };
+
+    void                          cullElements(SRenderState& state, const CRegion& damage);
+    void                          groupElements(SRenderState& state);
+    void                          drawAdded();
+
+    std::vector<SP<IPassElement>> m_vElements;
+};
@@ -0,0 +1,211 @@
+#include "PassElements.hpp"
+#include "../../Compositor.hpp"
+#include "../../config/ConfigValue.hpp"
+#include "../../desktop/Window.hpp"
+#include "../../desktop/LayerSurface.hpp"
+#include "../../desktop/Popup.hpp"
+#include "../../protocols/core/Compositor.hpp"
+
+// layout coords -> monitor pixels, grown by a pixel for rounding
+static CBox monitorBox(CBox box, PHLMONITOR pMonitor) {
+    return box.translate(-pMonitor->vecPosition).scale(pMonitor->scale).expand(1);
+}
+
+// opaque parts of a surface drawn in box, with its origin at origin. In monitor pixels, shrunk by a pixel for rounding.
+static CRegion opaqueRegionForSurface(SP<CWLSurfaceResource> surface, const CBox& box, const Vector2D& origin, float rounding, PHLMONITOR pMonitor) {
+    if (!surface || !surface->current.texture)
+        return {};
+
+    CRegion opaque;
+    if (surface->current.texture->m_bOpaque)
+        opaque = box;
+    else
+        opaque = CRegion{surface->current.opaque}.translate(origin).intersect(box);
+
+    if (opaque.empty())
+        return {};
+
+    // the rounded corners aren't opaque
+    if (rounding > 0) {
+        opaque.subtract(CBox{box.x, box.y, rounding, rounding});
+        opaque.subtract(CBox{box.x + box.w - rounding, box.y, rounding, rounding});
+        opaque.subtract(CBox{box.x, box.y + box.h - rounding, rounding, rounding});
+        opaque.subtract(CBox{box.x + box.w - rounding, box.y + box.h - rounding, rounding, rounding});
+    }
+
+    opaque.translate(-pMonitor->vecPosition).scale(pMonitor->scale);
+
+    return CRenderPass::shrinkRegion(opaque, 1);
+}
+
+static void feedbackForSurfaceTree(SP<CWLSurfaceResource> surface, timespec* time, PHLMONITOR pMonitor) {
+    if (!surface)
+        return;
+
+    surface->breadthfirst([time, pMonitor](SP<CWLSurfaceResource> s, const Vector2D& offset, void* d) { s->presentFeedback(time, pMonitor); }, nullptr);
+}
+
+CWindowPassElement::CWindowPassElement(PHLWINDOW pWindow, PHLMONITOR pMonitor, timespec* time, bool decorate, eRenderPassMode mode) :
+    m_pWindow(pWindow), m_pMonitor(pMonitor), m_pTime(time), m_bDecorate(decorate), m_eMode(mode) {
+    static auto PBLUR       = CConfigValue<Hyprlang::INT>("decoration:blur:enabled");
+    static auto PBLURPOPUPS = CConfigValue<Hyprlang::INT>("decoration:blur:popups");
+    static auto PDIMAROUND  = CConfigValue<Hyprlang::FLOAT>("decoration:dim_around");
+
+    const auto  PWORKSPACE = pWindow->m_pWorkspace;
+
+    // even opaque windows blur their rounded corners
+    m_bSamplesBelow = *PBLUR && (!pWindow->m_sWindowData.noBlur.valueOrDefault() || (mode != RENDER_PASS_MAIN && *PBLURPOPUPS));
+
+    // snapshots, dimming and transformers draw outside of the window's box
+    if (!PWORKSPACE || pWindow->m_bFadingOut || !pWindow->m_vTransformers.empty() || (*PDIMAROUND && pWindow->m_sWindowData.dimAround.valueOrDefault()))
+        return;
+
+    const auto OFFSET   = (pWindow->m_bPinned ? Vector2D{} : PWORKSPACE->m_vRenderOffset.value()) + pWindow->m_vFloatingOffset;
+    const auto ROUNDING = pWindow->isEffectiveInternalFSMode(FSMODE_FULLSCREEN) || pWindow->m_sWindowData.noRounding.valueOrDefault() ? 0 : pWindow->rounding();
+
+    // full bounding box includes decorations and popups
+    m_bbox = monitorBox(pWindow->getFullWindowBoundingBox().translate(OFFSET), pMonitor);
+
+    // whether m_fMovingToWorkspaceAlpha is used, see renderWindow
+    const bool MOVINGFADE = pWindow->m_iMonitorMovedFrom != -1 && !g_pCompositor->isWorkspaceVisible(PWORKSPACE);
+
+    // anything translucent, or stretched mid-animation shows what's below
+    const bool TRANSLUCENT = pWindow->m_fAlpha.value() != 1.f || pWindow->m_fActiveInactiveAlpha.value() != 1.f || PWORKSPACE->m_fAlpha.value() != 1.f ||
+        pWindow->m_vRealSize.isBeingAnimated() || pWindow->m_vRealSize.goal().floor() != pWindow->m_vReportedSize ||
+        (pWindow->m_pWLSurface->small() && !pWindow->m_pWLSurface->m_bFillIgnoreSmall);
+
+    if (mode != RENDER_PASS_POPUP && pWindow->m_bIsMapped && !TRANSLUCENT && !MOVINGFADE) {
+        // the main surface is cropped to the xdg geometry, see renderSurface
+        const CBox WINDOWBOX   = {pWindow->m_vRealPosition.value() + OFFSET, pWindow->m_vRealSize.value()};
+        const auto GEOMETRYPOS = pWindow->m_bIsX11 || !pWindow->m_pXDGSurface ? Vector2D{} : pWindow->m_pXDGSurface->current.geometry.pos();
+        m_opaque               = opaqueRegionForSurface(pWindow->m_pWLSurface->resource(), WINDOWBOX, WINDOWBOX.pos() - GEOMETRYPOS, ROUNDING, pMonitor);
+    }
+
+    // blur reads around the window, so moving it changes what it reads
+    m_bReorderable = mode != RENDER_PASS_POPUP && !m_bSamplesBelow;
+    m_iStateKey    = (decorate ? PASS_STATE_DECORATED : PASS_STATE_TEXTURE) + (ROUNDING > 0 ? 1 : 0);
+}
+
+void CWindowPassElement::draw() {
+    g_pHyprRenderer->renderWindow(m_pWindow, m_pMonitor, m_pTime, m_bDecorate, m_eMode);
+}
+
+void CWindowPassElement::discard() {
+    // culled surfaces still get their frame callbacks, same as invisible ones
+    if (g_pHyprRenderer->m_bBlockSurfaceFeedback || !m_pWindow->m_bIsMapped)
+        return;
+
+    if (m_eMode != RENDER_PASS_POPUP)
+        feedbackForSurfaceTree(m_pWindow->m_pWLSurface->resource(), m_pTime, m_pMonitor);
+
+    if (m_eMode != RENDER_PASS_MAIN && m_pWindow->m_pPopupHead) {
+        m_pWindow->m_pPopupHead->breadthfirst(
+            [this](CPopup* popup, void* data) {
+                if (!popup->m_pWLSurface || !popup->m_pWLSurface->resource())
+                    return;
+
+                feedbackForSurfaceTree(popup->m_pWLSurface->resource(), m_pTime, m_pMonitor);
+            },
+            nullptr);
+    }
+}
+
+const char* CWindowPassElement::passName() {
+    return "CWindowPassElement";
+}
+
+std::optional<CBox> CWindowPassElement::boundingBox() {
+    return m_bbox;
+}
+
+CRegion CWindowPassElement::opaqueRegion() {
+    return m_opaque;
+}
+
+bool CWindowPassElement::samplesBelow() {
+    return m_bSamplesBelow;
+}
+
+uint32_t CWindowPassElement::stateKey() {
+    return m_iStateKey;
+}
+
+bool CWindowPassElement::reorderable() {
+    return m_bReorderable && m_bbox.has_value();
+}
+
+CLayerPassElement::CLayerPassElement(PHLLS pLayer, PHLMONITOR pMonitor, timespec* time, bool popups) : m_pLayer(pLayer), m_pMonitor(pMonitor), m_pTime(time), m_bPopups(popups) {
+    static auto PDIMAROUND = CConfigValue<Hyprlang::FLOAT>("decoration:dim_around");
+
+    if (popups)
+        return;
+
+    if (!pLayer->fadingOut && pLayer->alpha.value() == 1.f && !pLayer->realSize.isBeingAnimated()) {
+        const CBox LAYERBOX = {pLayer->realPosition.value(), pLayer->realSize.value()};
+        m_opaque            = opaqueRegionForSurface(pLayer->surface->resource(), LAYERBOX, LAYERBOX.pos(), 0, pMonitor);
+    }
+
+    // popups and subsurfaces can be anywhere
+    if (pLayer->fadingOut || (*PDIMAROUND && pLayer->dimAround) || !pLayer->surface->resource() || !pLayer->surface->resource()->subsurfaces.empty())
+        return;
+
+    m_bbox = monitorBox(CBox{pLayer->realPosition.value(), pLayer->realSize.value()}, pMonitor);
+}
+
+void CLayerPassElement::draw() {
+    g_pHyprRenderer->renderLayer(m_pLayer, m_pMonitor, m_pTime, m_bPopups);
+}
+
+void CLayerPassElement::discard() {
+    if (g_pHyprRenderer->m_bBlockSurfaceFeedback)
+        return;
+
+    feedbackForSurfaceTree(m_pLayer->surface->resource(), m_pTime, m_pMonitor);
+}
+
+const char* CLayerPassElement::passName() {
+    return "CLayerPassElement";
+}
+
+std::optional<CBox> CLayerPassElement::boundingBox() {
+    return m_bbox;
+}
+
+CRegion CLayerPassElement::opaqueRegion() {
+    return m_opaque;
+}
+
+bool CLayerPassElement::samplesBelow() {
+    static auto PBLUR = CConfigValue<Hyprlang::INT>("decoration:blur:enabled");
+
+    return *PBLUR && (m_bPopups ? m_pLayer->forceBlurPopups : m_pLayer->forceBlur);
+}
+
+uint32_t CLayerPassElement::stateKey() {
+    return PASS_STATE_TEXTURE;
+}
+
+bool CLayerPassElement::reorderable() {
+    return m_bbox.has_value() && !m_pLayer->forceBlur;
+}
+
+CCallbackPassElement::CCallbackPassElement(std::function<void()> fn, std::optional<CBox> bbox, bool samplesBelow) : m_fDraw(fn), m_bbox(bbox), m_bSamplesBelow(samplesBelow) {
+    ;
+}
+
+void CCallbackPassElement::draw() {
+    if (m_fDraw)
+        m_fDraw();
+}
+
+const char* CCallbackPassElement::passName() {
+    return "CCallbackPassElement";
+}
+
+std::optional<CBox> CCallbackPassElement::boundingBox() {
+    return m_bbox;
+}
+
+bool CCallbackPassElement::samplesBelow() {
+    return m_bSamplesBelow;
+}
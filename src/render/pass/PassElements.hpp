@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include "Pass.hpp"
+#include "../Renderer.hpp"
+
+// shader state keys, see IPassElement::stateKey
+enum ePassStateKey : uint32_t {
+    PASS_STATE_TEXTURE = 0,
+    PASS_STATE_TEXTURE_ROUNDED,
+    PASS_STATE_DECORATED,
+    PASS_STATE_DECORATED_ROUNDED,
+};
+
+class CWindowPassElement : public IPassElement {
+  public:
+    CWindowPassElement(PHLWINDOW pWindow, PHLMONITOR pMonitor, timespec* time, bool decorate, eRenderPassMode mode);
+    virtual ~CWindowPassElement() = default;
+
+    virtual void                draw();
+    virtual void                discard();
+    virtual const char*         passName();
+    virtual std::optional<CBox> boundingBox();
+    virtual CRegion             opaqueRegion();
+    virtual bool                samplesBelow();
+    virtual uint32_t            stateKey();
+    virtual bool                reorderable();
+
+  private:
+    PHLWINDOW           m_pWindow;
+    PHLMONITOR          m_pMonitor;
+    timespec*           m_pTime     = nullptr;
+    bool                m_bDecorate = true;
+    eRenderPassMode     m_eMode     = RENDER_PASS_ALL;
+
+    std::optional<CBox> m_bbox;
+    CRegion             m_opaque;
+    uint32_t            m_iStateKey     = PASS_STATE_TEXTURE;
+    bool                m_bReorderable  = false;
+    bool                m_bSamplesBelow = false;
+};
+
+class CLayerPassElement : public IPassElement {
+  public:
+    CLayerPassElement(PHLLS pLayer, PHLMONITOR pMonitor, timespec* time, bool popups = false);
+    virtual ~CLayerPassElement() = default;
+
+    virtual void                draw();
+    virtual void                discard();
+    virtual const char*         passName();
+    virtual std::optional<CBox> boundingBox();
+    virtual CRegion             opaqueRegion();
+    virtual bool                samplesBelow();
+    virtual uint32_t            stateKey();
+    virtual bool                reorderable();
+
+  private:
+    PHLLS               m_pLayer;
+    PHLMONITOR          m_pMonitor;
+    timespec*           m_pTime   = nullptr;
+    bool                m_bPopups = false;
+
+    std::optional<CBox> m_bbox;
+    CRegion             m_opaque;
+};
+
+/*
+    Anything else: rects, state changes, hooks. Plugins can add these to g_pHyprRenderer->m_sRenderPass
+    from the render hooks, they are drawn right where the hook fired.
+*/
+class CCallbackPassElement : public IPassElement {
+  public:
+    CCallbackPassElement(std::function<void()> fn, std::optional<CBox> bbox = std::nullopt, bool samplesBelow = false);
+    virtual ~CCallbackPassElement() = default;
+
+    virtual void                draw();
+    virtual const char*         passName();
+    virtual std::optional<CBox> boundingBox();
+    virtual bool                samplesBelow();
+
+  private:
+    std::function<void()> m_fDraw;
+    std::optional<CBox>   m_bbox;
+    bool                  m_bSamplesBelow = false;
+};